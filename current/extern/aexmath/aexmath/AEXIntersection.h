@@ -36,6 +36,67 @@ namespace AEX
 	// TestAABBToLine
 	bool AEX_MATH_API TestAABBToLine(AABB box, Line line);
 
+	// ------------------------------------------------------------------------
+	// inline implementation
+	// ------------------------------------------------------------------------
+
+	// p is the center of the box, size its full extent; edges are inside
+	inline bool AABB::Contains(const AEVec2 &pt)
+	{
+		return PointInRect(pt, p, size);
+	}
+
+	inline bool PointInRect(const AEVec2 &pt, const AEVec2 rect_pos, AEVec2 rect_size)
+	{
+		return fabsf(pt.x - rect_pos.x) <= rect_size.x * 0.5f
+			&& fabsf(pt.y - rect_pos.y) <= rect_size.y * 0.5f;
+	}
+
+	inline bool TestAABBToAABB(const AABB&a, const AABB&b)
+	{
+		return fabsf(a.p.x - b.p.x) <= (a.size.x + b.size.x) * 0.5f
+			&& fabsf(a.p.y - b.p.y) <= (a.size.y + b.size.y) * 0.5f;
+	}
+
+	// > 0 if the point is left of the line (start -> end), < 0 if right
+	inline f32 TestPointToLine(AEVec2 point, AEVec2 start_line, AEVec2 end_line)
+	{
+		return (end_line - start_line).CrossMag(point - start_line);
+	}
+
+	// true if the line segment crosses the box: a corner must lie between
+	// the segment's end points, the box must be within its half diagonal of
+	// the line and one corner must be on its right
+	inline bool TestAABBToLine(AABB box, Line line)
+	{
+		f32 hw = box.size.x * 0.5f, hh = box.size.y * 0.5f;
+		AEVec2 corners[4] = {
+			box.p + AEVec2(-hw, hh), box.p + AEVec2(hw, hh),
+			box.p + AEVec2(-hw, -hh), box.p + AEVec2(hw, -hh)
+		};
+		AEVec2 d0 = line.end - line.start;
+		AEVec2 d1 = line.start - line.end;
+
+		u32 between = 0;
+		for (u32 i = 0; i < 4; ++i)
+		{
+			if ((corners[i] - line.start) * d1 < 0.0f && (corners[i] - line.end) * d0 < 0.0f)
+				++between;
+		}
+		if (between == 0)
+			return false;
+
+		if ((box.p - line.start).ProjectPerp(d0).LengthSq() > hw * hw + hh * hh)
+			return false;
+
+		for (u32 i = 0; i < 4; ++i)
+		{
+			if (TestPointToLine(corners[i], line.start, line.end) < 0.0f)
+				return true;
+		}
+		return false;
+	}
+
 } // namespace AEX
 
 // ----------------------------------------------------------------------------
@@ -12,10 +12,12 @@
 #define AEX_MATH_H
 
 #include <math.h>
+#include <stdio.h>
 #include <random>
 #include <src\Engine\Core\AEXDataTypes.h>
 #include "AEXMathDLL.h"
 #include "AEXMathDefs.h"
+#include "AEXMathSIMD.h"
 #include "AEXMath.inl"
 #include "AEXVec2.h"
 #include "AEXVec3.h"
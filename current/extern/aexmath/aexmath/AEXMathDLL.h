@@ -1,9 +1,6 @@
-#ifndef AEX_NO_DLL
-	#ifdef AEX_MATH_DLL_EXPORT
-		#define AEX_MATH_API __declspec(dllexport)
-	#else
-		#define AEX_MATH_API __declspec(dllimport)
-	#endif
-#else
-	#define AEX_MATH_API 
-#endif
\ No newline at end of file
+// The math library is header only: everything is inline and there is no
+// dll to import from. AEX_MATH_API is kept so that declarations written
+// against the old dll still compile.
+#ifndef AEX_MATH_API
+	#define AEX_MATH_API
+#endif
@@ -0,0 +1,765 @@
+// ---------------------------------------------------------------------------
+// Project Name		:	Alpha Engine
+// File Name		:	AEXMathSIMD.h
+// Purpose			:	SSE/AVX kernels behind the 4x4 matrix, 4D vector and
+//						quaternion operations and the batch point transforms,
+//						with the scalar versions they fall back to
+// History			:
+// - 2026/10/17		:	- initial implementation
+// ---------------------------------------------------------------------------
+#ifndef AEX_MATH_SIMD_H_
+#define AEX_MATH_SIMD_H_
+
+// ---------------------------------------------------------------------------
+// Instruction sets
+//
+// SSE2 is used whenever the compiler targets it (always on x64, /arch:SSE2
+// on x86), AVX when /arch:AVX (or -mavx) is on. Define AEX_MATH_NO_SIMD to
+// build the scalar versions only.
+#if !defined(AEX_MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define AEX_MATH_SSE 1
+	#include <emmintrin.h>
+	#if defined(__AVX__)
+		#define AEX_MATH_AVX 1
+		#include <immintrin.h>
+	#endif
+#endif
+
+#ifdef _MSC_VER
+	#define AEX_MATH_INLINE __forceinline
+#else
+	#define AEX_MATH_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace AEX
+{
+	// ---------------------------------------------------------------------------
+	// The kernels work on raw floats: 4x4 matrices are 16 floats stored row
+	// major, vectors and quaternions 4 floats. Nothing needs to be aligned.
+	// Results may alias the inputs.
+	//
+	// Every kernel has a _Scalar version, an _SSE one when AEX_MATH_SSE is
+	// defined, and the unsuffixed one used by the math types, which picks the
+	// widest available unless it measured slower. The suffixed versions are
+	// only called directly to compare them (see the benchmark demo).
+	namespace internal
+	{
+		// ------------------------------------------------------------------------
+		#pragma region// 4D VECTORS
+
+		inline void Vec4Add_Scalar(f32 * r, const f32 * a, const f32 * b)
+		{
+			r[0] = a[0] + b[0]; r[1] = a[1] + b[1]; r[2] = a[2] + b[2]; r[3] = a[3] + b[3];
+		}
+		inline void Vec4Sub_Scalar(f32 * r, const f32 * a, const f32 * b)
+		{
+			r[0] = a[0] - b[0]; r[1] = a[1] - b[1]; r[2] = a[2] - b[2]; r[3] = a[3] - b[3];
+		}
+		inline void Vec4Mul_Scalar(f32 * r, const f32 * a, const f32 * b)
+		{
+			r[0] = a[0] * b[0]; r[1] = a[1] * b[1]; r[2] = a[2] * b[2]; r[3] = a[3] * b[3];
+		}
+		inline void Vec4Scale_Scalar(f32 * r, const f32 * a, f32 s)
+		{
+			r[0] = a[0] * s; r[1] = a[1] * s; r[2] = a[2] * s; r[3] = a[3] * s;
+		}
+		inline f32 Vec4Dot_Scalar(const f32 * a, const f32 * b)
+		{
+			return a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+		}
+
+	#ifdef AEX_MATH_SSE
+		AEX_MATH_INLINE void Vec4Add_SSE(f32 * r, const f32 * a, const f32 * b)
+		{
+			_mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+		}
+		AEX_MATH_INLINE void Vec4Sub_SSE(f32 * r, const f32 * a, const f32 * b)
+		{
+			_mm_storeu_ps(r, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+		}
+		AEX_MATH_INLINE void Vec4Mul_SSE(f32 * r, const f32 * a, const f32 * b)
+		{
+			_mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+		}
+		AEX_MATH_INLINE void Vec4Scale_SSE(f32 * r, const f32 * a, f32 s)
+		{
+			_mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+		}
+
+		// horizontal sum, in every lane
+		AEX_MATH_INLINE __m128 HSum_SSE(__m128 v)
+		{
+			v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		}
+		AEX_MATH_INLINE f32 Vec4Dot_SSE(const f32 * a, const f32 * b)
+		{
+			return _mm_cvtss_f32(HSum_SSE(_mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))));
+		}
+
+		#define AEX_MATH_KERNEL(name) name##_SSE
+	#else
+		#define AEX_MATH_KERNEL(name) name##_Scalar
+	#endif
+
+		AEX_MATH_INLINE void Vec4Add(f32 * r, const f32 * a, const f32 * b)		{ AEX_MATH_KERNEL(Vec4Add)(r, a, b); }
+		AEX_MATH_INLINE void Vec4Sub(f32 * r, const f32 * a, const f32 * b)		{ AEX_MATH_KERNEL(Vec4Sub)(r, a, b); }
+		AEX_MATH_INLINE void Vec4Mul(f32 * r, const f32 * a, const f32 * b)		{ AEX_MATH_KERNEL(Vec4Mul)(r, a, b); }
+		AEX_MATH_INLINE void Vec4Scale(f32 * r, const f32 * a, f32 s)			{ AEX_MATH_KERNEL(Vec4Scale)(r, a, s); }
+		AEX_MATH_INLINE f32  Vec4Dot(const f32 * a, const f32 * b)				{ return AEX_MATH_KERNEL(Vec4Dot)(a, b); }
+		#pragma endregion
+
+		// ------------------------------------------------------------------------
+		#pragma region// QUATERNIONS (x, y, z, w)
+
+		// Hamilton product a * b, not normalized
+		inline void QuatConcat_Scalar(f32 * r, const f32 * a, const f32 * b)
+		{
+			f32 x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+			f32 y = a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2];
+			f32 z = a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0];
+			f32 w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+			r[0] = x; r[1] = y; r[2] = z; r[3] = w;
+		}
+
+	#ifdef AEX_MATH_SSE
+		AEX_MATH_INLINE void QuatConcat_SSE(f32 * r, const f32 * a, const f32 * b)
+		{
+			const __m128 qa = _mm_loadu_ps(a);
+			const __m128 qb = _mm_loadu_ps(b);
+			const __m128 signW = _mm_setr_ps(1.0f, 1.0f, 1.0f, -1.0f);
+
+			// w * b + (x b.w, y b.w, z b.w, -x b.x) + (y b.z, z b.x, x b.y, -y b.y) - (z b.y, x b.z, y b.x, z b.z)
+			__m128 res = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+			res = _mm_add_ps(res, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 3, 3, 3))), signW));
+			res = _mm_add_ps(res, _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 1, 0, 2))), signW));
+			res = _mm_sub_ps(res, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 0, 2, 1))));
+			_mm_storeu_ps(r, res);
+		}
+	#endif
+
+		AEX_MATH_INLINE void QuatConcat(f32 * r, const f32 * a, const f32 * b)	{ AEX_MATH_KERNEL(QuatConcat)(r, a, b); }
+		#pragma endregion
+
+		// ------------------------------------------------------------------------
+		#pragma region// 4x4 MATRICES
+
+		// r = a * b
+		inline void Mtx44Concat_Scalar(f32 * r, const f32 * a, const f32 * b)
+		{
+			f32 tmp[16];
+			for (u32 i = 0; i < 4; ++i)
+			{
+				const f32 * row = a + i * 4;
+				for (u32 j = 0; j < 4; ++j)
+					tmp[i * 4 + j] = row[0] * b[j] + row[1] * b[4 + j] + row[2] * b[8 + j] + row[3] * b[12 + j];
+			}
+			for (u32 i = 0; i < 16; ++i)
+				r[i] = tmp[i];
+		}
+
+		// r = m * (x, y, z, w), only xyz are written
+		inline void Mtx44MultVec_Scalar(f32 * r, const f32 * m, f32 x, f32 y, f32 z, f32 w)
+		{
+			f32 rx = m[0] * x + m[1] * y + m[2] * z + m[3] * w;
+			f32 ry = m[4] * x + m[5] * y + m[6] * z + m[7] * w;
+			f32 rz = m[8] * x + m[9] * y + m[10] * z + m[11] * w;
+			r[0] = rx; r[1] = ry; r[2] = rz;
+		}
+
+		inline void Mtx44Transpose_Scalar(f32 * r, const f32 * m)
+		{
+			f32 tmp[16];
+			for (u32 i = 0; i < 4; ++i)
+				for (u32 j = 0; j < 4; ++j)
+					tmp[j * 4 + i] = m[i * 4 + j];
+			for (u32 i = 0; i < 16; ++i)
+				r[i] = tmp[i];
+		}
+
+		// cofactors. Returns false and leaves r alone if m is singular.
+		inline bool Mtx44Inverse_Scalar(f32 * r, const f32 * m)
+		{
+			f32 inv[16];
+			inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+			inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+			inv[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+			inv[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+			inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+			inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+			inv[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+			inv[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+			inv[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+			inv[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+			inv[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+			inv[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+			inv[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+			inv[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+			inv[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+			inv[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+			f32 det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+			if (det == 0.0f)
+				return false;
+
+			f32 invDet = 1.0f / det;
+			for (u32 i = 0; i < 16; ++i)
+				r[i] = inv[i] * invDet;
+			return true;
+		}
+
+	#ifdef AEX_MATH_SSE
+		AEX_MATH_INLINE void Mtx44Concat_SSE(f32 * r, const f32 * a, const f32 * b)
+		{
+			const __m128 b0 = _mm_loadu_ps(b);
+			const __m128 b1 = _mm_loadu_ps(b + 4);
+			const __m128 b2 = _mm_loadu_ps(b + 8);
+			const __m128 b3 = _mm_loadu_ps(b + 12);
+
+			// row i of r: a[i][0] * b0 + a[i][1] * b1 + a[i][2] * b2 + a[i][3] * b3.
+			// All of a is read before r is written.
+			__m128 rows[4];
+			for (u32 i = 0; i < 4; ++i)
+			{
+				const __m128 row = _mm_loadu_ps(a + i * 4);
+				__m128 res = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+				rows[i] = res;
+			}
+			for (u32 i = 0; i < 4; ++i)
+				_mm_storeu_ps(r + i * 4, rows[i]);
+		}
+
+		AEX_MATH_INLINE void Mtx44MultVec_SSE(f32 * r, const f32 * m, f32 x, f32 y, f32 z, f32 w)
+		{
+			const __m128 v = _mm_setr_ps(x, y, z, w);
+			__m128 r0 = _mm_mul_ps(_mm_loadu_ps(m), v);
+			__m128 r1 = _mm_mul_ps(_mm_loadu_ps(m + 4), v);
+			__m128 r2 = _mm_mul_ps(_mm_loadu_ps(m + 8), v);
+			__m128 r3 = _mm_setzero_ps();
+
+			// transpose the products and add the rows: lane i is row i . v
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			const __m128 res = _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3));
+
+			// 3 floats: no write past the vector
+			f32 out[4];
+			_mm_storeu_ps(out, res);
+			r[0] = out[0]; r[1] = out[1]; r[2] = out[2];
+		}
+
+		AEX_MATH_INLINE void Mtx44Transpose_SSE(f32 * r, const f32 * m)
+		{
+			__m128 r0 = _mm_loadu_ps(m);
+			__m128 r1 = _mm_loadu_ps(m + 4);
+			__m128 r2 = _mm_loadu_ps(m + 8);
+			__m128 r3 = _mm_loadu_ps(m + 12);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps(r, r0);
+			_mm_storeu_ps(r + 4, r1);
+			_mm_storeu_ps(r + 8, r2);
+			_mm_storeu_ps(r + 12, r3);
+		}
+
+		// 2x2 blocks (row major, one per register) for the block inverse
+		#define AEX_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x))
+		#define AEX_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+
+		// a * b
+		AEX_MATH_INLINE __m128 Mtx22Mul_SSE(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, AEX_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(AEX_SWIZZLE(a, 1, 0, 3, 2), AEX_SWIZZLE(b, 2, 1, 2, 1)));
+		}
+		// adj(a) * b
+		AEX_MATH_INLINE __m128 Mtx22AdjMul_SSE(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(AEX_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(AEX_SWIZZLE(a, 1, 1, 2, 2), AEX_SWIZZLE(b, 2, 3, 0, 1)));
+		}
+		// a * adj(b)
+		AEX_MATH_INLINE __m128 Mtx22MulAdj_SSE(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, AEX_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(AEX_SWIZZLE(a, 1, 0, 3, 2), AEX_SWIZZLE(b, 2, 1, 2, 1)));
+		}
+
+		// block inverse: with M = | A B |, the inverse is | X Y | / |M| with
+		//                        | C D |                 | Z W |
+		// X = adj(|D|A - B adj(D)C), W = adj(|A|D - C adj(A)B),
+		// Y = adj(|B|C - D adj(adj(A)B)), Z = adj(|C|B - A adj(adj(D)C)),
+		// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C).
+		AEX_MATH_INLINE bool Mtx44Inverse_SSE(f32 * r, const f32 * m)
+		{
+			const __m128 r0 = _mm_loadu_ps(m);
+			const __m128 r1 = _mm_loadu_ps(m + 4);
+			const __m128 r2 = _mm_loadu_ps(m + 8);
+			const __m128 r3 = _mm_loadu_ps(m + 12);
+
+			const __m128 A = _mm_movelh_ps(r0, r1);
+			const __m128 B = _mm_movehl_ps(r1, r0);
+			const __m128 C = _mm_movelh_ps(r2, r3);
+			const __m128 D = _mm_movehl_ps(r3, r2);
+
+			// (|A|, |B|, |C|, |D|)
+			const __m128 detSub = _mm_sub_ps(
+				_mm_mul_ps(AEX_SHUFFLE(r0, r2, 0, 2, 0, 2), AEX_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+				_mm_mul_ps(AEX_SHUFFLE(r0, r2, 1, 3, 1, 3), AEX_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+			const __m128 detA = AEX_SWIZZLE(detSub, 0, 0, 0, 0);
+			const __m128 detB = AEX_SWIZZLE(detSub, 1, 1, 1, 1);
+			const __m128 detC = AEX_SWIZZLE(detSub, 2, 2, 2, 2);
+			const __m128 detD = AEX_SWIZZLE(detSub, 3, 3, 3, 3);
+
+			const __m128 DC = Mtx22AdjMul_SSE(D, C);
+			const __m128 AB = Mtx22AdjMul_SSE(A, B);
+			__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mtx22Mul_SSE(B, DC));
+			__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mtx22Mul_SSE(C, AB));
+			__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mtx22MulAdj_SSE(D, AB));
+			__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mtx22MulAdj_SSE(A, DC));
+
+			__m128 det = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+			det = _mm_sub_ps(det, HSum_SSE(_mm_mul_ps(AB, AEX_SWIZZLE(DC, 0, 2, 1, 3))));
+			if (_mm_cvtss_f32(det) == 0.0f)
+				return false;
+
+			// the adjugates' signs go with the division
+			const __m128 rcpDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+			X = _mm_mul_ps(X, rcpDet);
+			Y = _mm_mul_ps(Y, rcpDet);
+			Z = _mm_mul_ps(Z, rcpDet);
+			W = _mm_mul_ps(W, rcpDet);
+
+			// adjugate swizzle and back to rows in one shuffle
+			_mm_storeu_ps(r, AEX_SHUFFLE(X, Y, 3, 1, 3, 1));
+			_mm_storeu_ps(r + 4, AEX_SHUFFLE(X, Y, 2, 0, 2, 0));
+			_mm_storeu_ps(r + 8, AEX_SHUFFLE(Z, W, 3, 1, 3, 1));
+			_mm_storeu_ps(r + 12, AEX_SHUFFLE(Z, W, 2, 0, 2, 0));
+			return true;
+		}
+		#undef AEX_SWIZZLE
+		#undef AEX_SHUFFLE
+	#endif
+
+	#ifdef AEX_MATH_AVX
+		// two rows of r at a time: each 128 bit lane holds one row of a
+		AEX_MATH_INLINE void Mtx44Concat_AVX(f32 * r, const f32 * a, const f32 * b)
+		{
+			const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+			const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+			const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+			const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+			const __m256 a01 = _mm256_loadu_ps(a);
+			const __m256 a23 = _mm256_loadu_ps(a + 8);
+
+			__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+			r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+			r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+
+			_mm256_storeu_ps(r, r01);
+			_mm256_storeu_ps(r + 8, r23);
+		}
+	#endif
+
+		#undef AEX_MATH_KERNEL
+	#if defined(AEX_MATH_AVX)
+		AEX_MATH_INLINE void Mtx44Concat(f32 * r, const f32 * a, const f32 * b)	{ Mtx44Concat_AVX(r, a, b); }
+	#elif defined(AEX_MATH_SSE)
+		AEX_MATH_INLINE void Mtx44Concat(f32 * r, const f32 * a, const f32 * b)	{ Mtx44Concat_SSE(r, a, b); }
+	#else
+		AEX_MATH_INLINE void Mtx44Concat(f32 * r, const f32 * a, const f32 * b)	{ Mtx44Concat_Scalar(r, a, b); }
+	#endif
+
+		// one vector against row major rows is three horizontal sums: the
+		// scalar version is faster (see the benchmark demo)
+		AEX_MATH_INLINE void Mtx44MultVec(f32 * r, const f32 * m, f32 x, f32 y, f32 z, f32 w)	{ Mtx44MultVec_Scalar(r, m, x, y, z, w); }
+	#ifdef AEX_MATH_SSE
+		AEX_MATH_INLINE void Mtx44Transpose(f32 * r, const f32 * m)							{ Mtx44Transpose_SSE(r, m); }
+		AEX_MATH_INLINE bool Mtx44Inverse(f32 * r, const f32 * m)								{ return Mtx44Inverse_SSE(r, m); }
+	#else
+		AEX_MATH_INLINE void Mtx44Transpose(f32 * r, const f32 * m)							{ Mtx44Transpose_Scalar(r, m); }
+		AEX_MATH_INLINE bool Mtx44Inverse(f32 * r, const f32 * m)								{ return Mtx44Inverse_Scalar(r, m); }
+	#endif
+		#pragma endregion
+
+		// ------------------------------------------------------------------------
+		#pragma region// POINT BATCHES
+		// count points transformed by an affine matrix, w = 1. Points are read
+		// every vStride bytes and written every rStride bytes, so they can be a
+		// field of a bigger struct: (&vertices[0].mPosition, sizeof(Vertex)).
+		// r may be v to transform in place. The SoA versions take one array per
+		// coordinate, same rule: r* may be the matching input array.
+		//
+		// Mtx33: 2D points, m is 9 floats. Mtx44: 3D points, m is 16 floats.
+
+		AEX_MATH_INLINE const f32 * StrideAt(const f32 * p, u32 stride, u32 i)
+		{
+			return reinterpret_cast<const f32 *>(reinterpret_cast<const u8 *>(p) + size_t(stride) * i);
+		}
+		AEX_MATH_INLINE f32 * StrideAt(f32 * p, u32 stride, u32 i)
+		{
+			return reinterpret_cast<f32 *>(reinterpret_cast<u8 *>(p) + size_t(stride) * i);
+		}
+
+		inline void Mtx33MultPoints_Scalar(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				const f32 * p = StrideAt(v, vStride, i);
+				f32 x = p[0], y = p[1];
+				f32 * o = StrideAt(r, rStride, i);
+				o[0] = m[0] * x + m[1] * y + m[2];
+				o[1] = m[3] * x + m[4] * y + m[5];
+			}
+		}
+		inline void Mtx33MultPointsSoA_Scalar(f32 * rx, f32 * ry, const f32 * m, const f32 * x, const f32 * y, u32 count)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				f32 px = x[i], py = y[i];
+				rx[i] = m[0] * px + m[1] * py + m[2];
+				ry[i] = m[3] * px + m[4] * py + m[5];
+			}
+		}
+		inline void Mtx44MultPoints_Scalar(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				const f32 * p = StrideAt(v, vStride, i);
+				Mtx44MultVec_Scalar(StrideAt(r, rStride, i), m, p[0], p[1], p[2], 1.0f);
+			}
+		}
+		inline void Mtx44MultPointsSoA_Scalar(f32 * rx, f32 * ry, f32 * rz, const f32 * m, const f32 * x, const f32 * y, const f32 * z, u32 count)
+		{
+			for (u32 i = 0; i < count; ++i)
+			{
+				f32 px = x[i], py = y[i], pz = z[i];
+				rx[i] = m[0] * px + m[1] * py + m[2] * pz + m[3];
+				ry[i] = m[4] * px + m[5] * py + m[6] * pz + m[7];
+				rz[i] = m[8] * px + m[9] * py + m[10] * pz + m[11];
+			}
+		}
+
+	#ifdef AEX_MATH_SSE
+		// two 2D points per register, left interleaved: for p = (x, y),
+		// p * (m00, m11) + (y, x) * (m01, m10) + (m02, m12)
+		AEX_MATH_INLINE __m128 Mtx33MultPointPair_SSE(__m128 p, __m128 diag, __m128 anti, __m128 trans)
+		{
+			const __m128 swapped = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1));
+			return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, diag), _mm_mul_ps(swapped, anti)), trans);
+		}
+
+		inline void Mtx33MultPoints_SSE(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			const __m128 diag = _mm_setr_ps(m[0], m[4], m[0], m[4]);
+			const __m128 anti = _mm_setr_ps(m[1], m[3], m[1], m[3]);
+			const __m128 trans = _mm_setr_ps(m[2], m[5], m[2], m[5]);
+
+			u32 i = 0;
+			if (vStride == 2 * sizeof(f32) && rStride == 2 * sizeof(f32))
+			{
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m128 p01 = _mm_loadu_ps(v + i * 2);
+					const __m128 p23 = _mm_loadu_ps(v + i * 2 + 4);
+					_mm_storeu_ps(r + i * 2, Mtx33MultPointPair_SSE(p01, diag, anti, trans));
+					_mm_storeu_ps(r + i * 2 + 4, Mtx33MultPointPair_SSE(p23, diag, anti, trans));
+				}
+			}
+			else
+			{
+				// one 64 bit load per point
+				for (; i + 2 <= count; i += 2)
+				{
+					__m128 p = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(StrideAt(v, vStride, i)));
+					p = _mm_loadh_pi(p, reinterpret_cast<const __m64 *>(StrideAt(v, vStride, i + 1)));
+					p = Mtx33MultPointPair_SSE(p, diag, anti, trans);
+					_mm_storel_pi(reinterpret_cast<__m64 *>(StrideAt(r, rStride, i)), p);
+					_mm_storeh_pi(reinterpret_cast<__m64 *>(StrideAt(r, rStride, i + 1)), p);
+				}
+			}
+			Mtx33MultPoints_Scalar(StrideAt(r, rStride, i), rStride, m, StrideAt(v, vStride, i), vStride, count - i);
+		}
+
+		// four points per register
+		inline void Mtx33MultPointsSoA_SSE(f32 * rx, f32 * ry, const f32 * m, const f32 * x, const f32 * y, u32 count)
+		{
+			const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+			const __m128 m3 = _mm_set1_ps(m[3]), m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]);
+
+			u32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const __m128 px = _mm_loadu_ps(x + i);
+				const __m128 py = _mm_loadu_ps(y + i);
+				_mm_storeu_ps(rx + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m0), _mm_mul_ps(py, m1)), m2));
+				_mm_storeu_ps(ry + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m3), _mm_mul_ps(py, m4)), m5));
+			}
+			Mtx33MultPointsSoA_Scalar(rx + i, ry + i, m, x + i, y + i, count - i);
+		}
+
+		// the 12 affine elements of a row major 4x4, one per register
+		struct Mtx44Splat_SSE
+		{
+			explicit Mtx44Splat_SSE(const f32 * m)
+			{
+				for (u32 i = 0; i < 12; ++i)
+					e[i] = _mm_set1_ps(m[i]);
+			}
+			__m128 e[12];
+		};
+
+		// four points, one coordinate per register: row . (x, y, z, 1)
+		AEX_MATH_INLINE void Mtx44MultPoints4_SSE(const Mtx44Splat_SSE & m, __m128 & x, __m128 & y, __m128 & z)
+		{
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.e[0]), _mm_mul_ps(y, m.e[1])), _mm_add_ps(_mm_mul_ps(z, m.e[2]), m.e[3]));
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.e[4]), _mm_mul_ps(y, m.e[5])), _mm_add_ps(_mm_mul_ps(z, m.e[6]), m.e[7]));
+			const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.e[8]), _mm_mul_ps(y, m.e[9])), _mm_add_ps(_mm_mul_ps(z, m.e[10]), m.e[11]));
+			x = rx; y = ry; z = rz;
+		}
+
+		inline void Mtx44MultPoints_SSE(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			u32 i = 0;
+			if (vStride == 3 * sizeof(f32) && rStride == 3 * sizeof(f32))
+			{
+				// packed: four points in three loads, transposed to one
+				// coordinate per register and back
+				const Mtx44Splat_SSE splat(m);
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m128 a = _mm_loadu_ps(v + i * 3);		// x0 y0 z0 x1
+					const __m128 b = _mm_loadu_ps(v + i * 3 + 4);	// y1 z1 x2 y2
+					const __m128 c = _mm_loadu_ps(v + i * 3 + 8);	// z2 x3 y3 z3
+
+					const __m128 x2y2x3y3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+					const __m128 y0y0y1y1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+					const __m128 z0x1y1z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 2));
+					__m128 x = _mm_shuffle_ps(a, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+					__m128 y = _mm_shuffle_ps(y0y0y1y1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+					__m128 z = _mm_shuffle_ps(z0x1y1z1, c, _MM_SHUFFLE(3, 0, 3, 0));
+
+					Mtx44MultPoints4_SSE(splat, x, y, z);
+
+					const __m128 xy01 = _mm_unpacklo_ps(x, y);
+					const __m128 xy23 = _mm_unpackhi_ps(x, y);
+					_mm_storeu_ps(r + i * 3, _mm_shuffle_ps(xy01, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+					_mm_storeu_ps(r + i * 3 + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+					_mm_storeu_ps(r + i * 3 + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+				}
+			}
+
+			// strided: one point per register, the matrix columns scaled by
+			// x, y and z plus the translation column
+			const __m128 c0 = _mm_setr_ps(m[0], m[4], m[8], 0.0f);
+			const __m128 c1 = _mm_setr_ps(m[1], m[5], m[9], 0.0f);
+			const __m128 c2 = _mm_setr_ps(m[2], m[6], m[10], 0.0f);
+			const __m128 c3 = _mm_setr_ps(m[3], m[7], m[11], 0.0f);
+			for (; i < count; ++i)
+			{
+				const f32 * p = StrideAt(v, vStride, i);
+				__m128 res = _mm_add_ps(_mm_mul_ps(_mm_load1_ps(p), c0), c3);
+				res = _mm_add_ps(res, _mm_add_ps(_mm_mul_ps(_mm_load1_ps(p + 1), c1), _mm_mul_ps(_mm_load1_ps(p + 2), c2)));
+
+				// 3 floats: no write past the point
+				f32 * o = StrideAt(r, rStride, i);
+				_mm_storel_pi(reinterpret_cast<__m64 *>(o), res);
+				_mm_store_ss(o + 2, _mm_movehl_ps(res, res));
+			}
+		}
+
+		inline void Mtx44MultPointsSoA_SSE(f32 * rx, f32 * ry, f32 * rz, const f32 * m, const f32 * x, const f32 * y, const f32 * z, u32 count)
+		{
+			const Mtx44Splat_SSE splat(m);
+			u32 i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 px = _mm_loadu_ps(x + i);
+				__m128 py = _mm_loadu_ps(y + i);
+				__m128 pz = _mm_loadu_ps(z + i);
+				Mtx44MultPoints4_SSE(splat, px, py, pz);
+				_mm_storeu_ps(rx + i, px);
+				_mm_storeu_ps(ry + i, py);
+				_mm_storeu_ps(rz + i, pz);
+			}
+			Mtx44MultPointsSoA_Scalar(rx + i, ry + i, rz + i, m, x + i, y + i, z + i, count - i);
+		}
+	#endif
+
+	#ifdef AEX_MATH_AVX
+		// packed 2D points, four per register. Strided points and the rest go
+		// to the SSE version: the 64 bit loads don't gain from the width.
+		inline void Mtx33MultPoints_AVX(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			u32 i = 0;
+			if (vStride == 2 * sizeof(f32) && rStride == 2 * sizeof(f32))
+			{
+				const __m256 diag = _mm256_setr_ps(m[0], m[4], m[0], m[4], m[0], m[4], m[0], m[4]);
+				const __m256 anti = _mm256_setr_ps(m[1], m[3], m[1], m[3], m[1], m[3], m[1], m[3]);
+				const __m256 trans = _mm256_setr_ps(m[2], m[5], m[2], m[5], m[2], m[5], m[2], m[5]);
+				for (; i + 4 <= count; i += 4)
+				{
+					const __m256 p = _mm256_loadu_ps(v + i * 2);
+					const __m256 swapped = _mm256_permute_ps(p, _MM_SHUFFLE(2, 3, 0, 1));
+					_mm256_storeu_ps(r + i * 2, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, diag), _mm256_mul_ps(swapped, anti)), trans));
+				}
+			}
+			Mtx33MultPoints_SSE(StrideAt(r, rStride, i), rStride, m, StrideAt(v, vStride, i), vStride, count - i);
+		}
+
+		// eight points per register
+		inline void Mtx33MultPointsSoA_AVX(f32 * rx, f32 * ry, const f32 * m, const f32 * x, const f32 * y, u32 count)
+		{
+			const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+			const __m256 m3 = _mm256_set1_ps(m[3]), m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]);
+
+			u32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 px = _mm256_loadu_ps(x + i);
+				const __m256 py = _mm256_loadu_ps(y + i);
+				_mm256_storeu_ps(rx + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m0), _mm256_mul_ps(py, m1)), m2));
+				_mm256_storeu_ps(ry + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m3), _mm256_mul_ps(py, m4)), m5));
+			}
+			Mtx33MultPointsSoA_SSE(rx + i, ry + i, m, x + i, y + i, count - i);
+		}
+
+		inline void Mtx44MultPointsSoA_AVX(f32 * rx, f32 * ry, f32 * rz, const f32 * m, const f32 * x, const f32 * y, const f32 * z, u32 count)
+		{
+			__m256 e[12];
+			for (u32 k = 0; k < 12; ++k)
+				e[k] = _mm256_set1_ps(m[k]);
+
+			u32 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const __m256 px = _mm256_loadu_ps(x + i);
+				const __m256 py = _mm256_loadu_ps(y + i);
+				const __m256 pz = _mm256_loadu_ps(z + i);
+				const __m256 resX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, e[0]), _mm256_mul_ps(py, e[1])), _mm256_add_ps(_mm256_mul_ps(pz, e[2]), e[3]));
+				const __m256 resY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, e[4]), _mm256_mul_ps(py, e[5])), _mm256_add_ps(_mm256_mul_ps(pz, e[6]), e[7]));
+				const __m256 resZ = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, e[8]), _mm256_mul_ps(py, e[9])), _mm256_add_ps(_mm256_mul_ps(pz, e[10]), e[11]));
+				_mm256_storeu_ps(rx + i, resX);
+				_mm256_storeu_ps(ry + i, resY);
+				_mm256_storeu_ps(rz + i, resZ);
+			}
+			Mtx44MultPointsSoA_SSE(rx + i, ry + i, rz + i, m, x + i, y + i, z + i, count - i);
+		}
+	#endif
+
+	#if defined(AEX_MATH_AVX)
+		#define AEX_MATH_KERNEL(name) name##_AVX
+	#elif defined(AEX_MATH_SSE)
+		#define AEX_MATH_KERNEL(name) name##_SSE
+	#else
+		#define AEX_MATH_KERNEL(name) name##_Scalar
+	#endif
+		inline void Mtx33MultPoints(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+			AEX_MATH_KERNEL(Mtx33MultPoints)(r, rStride, m, v, vStride, count);
+		}
+		inline void Mtx33MultPointsSoA(f32 * rx, f32 * ry, const f32 * m, const f32 * x, const f32 * y, u32 count)
+		{
+			AEX_MATH_KERNEL(Mtx33MultPointsSoA)(rx, ry, m, x, y, count);
+		}
+		inline void Mtx44MultPointsSoA(f32 * rx, f32 * ry, f32 * rz, const f32 * m, const f32 * x, const f32 * y, const f32 * z, u32 count)
+		{
+			AEX_MATH_KERNEL(Mtx44MultPointsSoA)(rx, ry, rz, m, x, y, z, count);
+		}
+		#undef AEX_MATH_KERNEL
+
+		// 3D points are shuffle bound: with plain SSE2 encoding the SSE version
+		// measured slower than scalar. The AVX encoding (broadcast loads, three
+		// operand shuffles) makes it faster, no wider version needed. Scalar
+		// unless built with /arch:AVX, which the engine project doesn't set.
+		inline void Mtx44MultPoints(f32 * r, u32 rStride, const f32 * m, const f32 * v, u32 vStride, u32 count)
+		{
+	#ifdef AEX_MATH_AVX
+			Mtx44MultPoints_SSE(r, rStride, m, v, vStride, count);
+	#else
+			Mtx44MultPoints_Scalar(r, rStride, m, v, vStride, count);
+	#endif
+		}
+		#pragma endregion
+
+		// ------------------------------------------------------------------------
+		#pragma region// MATRIX BATCHES
+		// count 2D model matrices T * Rz * S, one per element of the SoA
+		// inputs: translation (tx, ty, tz), scale (sx, sy) and the cosine and
+		// sine of the rotation. Written to r packed, 16 floats per matrix, row
+		// major like Mtx44Mult.
+
+		inline void Mtx44FromTRS2DSoA_Scalar(f32 * r, const f32 * tx, const f32 * ty, const f32 * tz, const f32 * sx, const f32 * sy, const f32 * c, const f32 * s, u32 count)
+		{
+			for (u32 i = 0; i < count; ++i, r += 16)
+			{
+				r[0] = c[i] * sx[i];	r[1] = -s[i] * sy[i];	r[2] = 0.0f;	r[3] = tx[i];
+				r[4] = s[i] * sx[i];	r[5] = c[i] * sy[i];	r[6] = 0.0f;	r[7] = ty[i];
+				r[8] = 0.0f;			r[9] = 0.0f;			r[10] = 1.0f;	r[11] = tz[i];
+				r[12] = 0.0f;			r[13] = 0.0f;			r[14] = 0.0f;	r[15] = 1.0f;
+			}
+		}
+
+	#ifdef AEX_MATH_SSE
+		// four matrices per iteration: the products are computed four wide,
+		// then interleaved with the translations into rows
+		inline void Mtx44FromTRS2DSoA_SSE(f32 * r, const f32 * tx, const f32 * ty, const f32 * tz, const f32 * sx, const f32 * sy, const f32 * c, const f32 * s, u32 count)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 row3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+			const __m128 sign = _mm_set1_ps(-0.0f);
+
+			u32 i = 0;
+			for (; i + 4 <= count; i += 4, r += 64)
+			{
+				const __m128 vc = _mm_loadu_ps(c + i), vs = _mm_loadu_ps(s + i);
+				const __m128 vsx = _mm_loadu_ps(sx + i), vsy = _mm_loadu_ps(sy + i);
+				const __m128 m00 = _mm_mul_ps(vc, vsx), m01 = _mm_xor_ps(_mm_mul_ps(vs, vsy), sign);
+				const __m128 m10 = _mm_mul_ps(vs, vsx), m11 = _mm_mul_ps(vc, vsy);
+
+				// (m, m) pairs and (0, t) or (1, tz) pairs of matrices 0, 1 (lo) and 2, 3 (hi)
+				const __m128 vtx = _mm_loadu_ps(tx + i), vty = _mm_loadu_ps(ty + i), vtz = _mm_loadu_ps(tz + i);
+				__m128 r0[2] = { _mm_unpacklo_ps(m00, m01), _mm_unpackhi_ps(m00, m01) };
+				__m128 t0[2] = { _mm_unpacklo_ps(zero, vtx), _mm_unpackhi_ps(zero, vtx) };
+				__m128 r1[2] = { _mm_unpacklo_ps(m10, m11), _mm_unpackhi_ps(m10, m11) };
+				__m128 t1[2] = { _mm_unpacklo_ps(zero, vty), _mm_unpackhi_ps(zero, vty) };
+				__m128 t2[2] = { _mm_unpacklo_ps(one, vtz), _mm_unpackhi_ps(one, vtz) };
+
+				for (u32 k = 0; k < 2; ++k)
+				{
+					f32 * o = r + k * 32;
+					_mm_storeu_ps(o, _mm_movelh_ps(r0[k], t0[k]));
+					_mm_storeu_ps(o + 4, _mm_movelh_ps(r1[k], t1[k]));
+					_mm_storeu_ps(o + 8, _mm_movelh_ps(zero, t2[k]));
+					_mm_storeu_ps(o + 12, row3);
+					_mm_storeu_ps(o + 16, _mm_movehl_ps(t0[k], r0[k]));
+					_mm_storeu_ps(o + 20, _mm_movehl_ps(t1[k], r1[k]));
+					_mm_storeu_ps(o + 24, _mm_movehl_ps(t2[k], zero));
+					_mm_storeu_ps(o + 28, row3);
+				}
+			}
+			Mtx44FromTRS2DSoA_Scalar(r, tx + i, ty + i, tz + i, sx + i, sy + i, c + i, s + i, count - i);
+		}
+	#endif
+
+		// store bound (64 bytes out for 28 in): the AVX build uses the SSE
+		// version as well
+		inline void Mtx44FromTRS2DSoA(f32 * r, const f32 * tx, const f32 * ty, const f32 * tz, const f32 * sx, const f32 * sy, const f32 * c, const f32 * s, u32 count)
+		{
+	#ifdef AEX_MATH_SSE
+			Mtx44FromTRS2DSoA_SSE(r, tx, ty, tz, sx, sy, c, s, count);
+	#else
+			Mtx44FromTRS2DSoA_Scalar(r, tx, ty, tz, sx, sy, c, s, count);
+	#endif
+		}
+		#pragma endregion
+	}
+}
+
+// ---------------------------------------------------------------------------
+#endif
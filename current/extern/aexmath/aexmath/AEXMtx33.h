@@ -154,6 +154,250 @@ namespace AEX
 	void 	AEX_MATH_API	AEMtx33MultVecArray(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec, u32 count);
 	void 	AEX_MATH_API	AEMtx33MultVecSR(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec);
 	void 	AEX_MATH_API	AEMtx33MultVecArraySR(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec, u32 count);
+
+	// ---------------------------------------------------------------------------
+	// batches: count points transformed like MultVec in one SIMD loop. The
+	// versions without pResult transform in place.
+	// * Strided: the points are stride bytes apart, ex: the positions of a
+	//   vertex array are (&vertices[0].mPosition, sizeof(Vertex))
+	// * SoA: the x and y coordinates are in separate arrays
+	void 	AEX_MATH_API	AEMtx33MultVecArray(AEVec2* pVec, const AEMtx33* pMtx, u32 count);
+	void 	AEX_MATH_API	AEMtx33MultVecStrided(AEVec2* pResult, u32 resultStride, const AEMtx33* pMtx, const AEVec2* pVec, u32 vecStride, u32 count);
+	void 	AEX_MATH_API	AEMtx33MultVecStrided(AEVec2* pVec, u32 stride, const AEMtx33* pMtx, u32 count);
+	void 	AEX_MATH_API	AEMtx33MultVecSoA(f32* pResultX, f32* pResultY, const AEMtx33* pMtx, const f32* pX, const f32* pY, u32 count);
+	void 	AEX_MATH_API	AEMtx33MultVecSoA(f32* pX, f32* pY, const AEMtx33* pMtx, u32 count);
+
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline AEMtx33::AEMtx33()
+	{
+		SetIdentity();
+	}
+	inline AEMtx33::AEMtx33(float a11, float a12, float a13,
+		float a21, float a22, float a23,
+		float a31, float a32, float a33)
+		: m11(a11), m12(a12), m13(a13)
+		, m21(a21), m22(a22), m23(a23)
+		, m31(a31), m32(a32), m33(a33)
+	{}
+
+	inline void AEMtx33::SetIdentity()
+	{
+		AEMtx33Identity(this);
+	}
+	inline AEMtx33 AEMtx33::Transpose()const
+	{
+		return AEMtx33(m11, m21, m31, m12, m22, m32, m13, m23, m33);
+	}
+	inline void AEMtx33::TransposeThis()
+	{
+		*this = Transpose();
+	}
+
+	inline AEMtx33 AEMtx33::Concat(const AEMtx33 & rhs)const
+	{
+		AEMtx33 r;
+		for (u32 i = 0; i < 3; ++i)
+			for (u32 j = 0; j < 3; ++j)
+				r.m[i][j] = m[i][0] * rhs.m[0][j] + m[i][1] * rhs.m[1][j] + m[i][2] * rhs.m[2][j];
+		return r;
+	}
+	inline AEMtx33 AEMtx33::operator *(const AEMtx33 & rhs)const
+	{
+		return Concat(rhs);
+	}
+	inline const AEMtx33& AEMtx33::operator *=(const AEMtx33 &rhs)
+	{
+		return *this = Concat(rhs);
+	}
+
+	// affine: the last row is ignored
+	inline AEVec2 AEMtx33::MultVec(const AEVec2 & vec)const
+	{
+		return AEVec2(m11 * vec.x + m12 * vec.y + m13, m21 * vec.x + m22 * vec.y + m23);
+	}
+	inline AEVec2 AEMtx33::operator*(const AEVec2 & vec)const
+	{
+		return MultVec(vec);
+	}
+	inline AEVec2 AEMtx33::MultVecDir(const AEVec2 &vec)const
+	{
+		return AEVec2(m11 * vec.x + m12 * vec.y, m21 * vec.x + m22 * vec.y);
+	}
+
+	inline AEMtx33 AEMtx33::Identity()
+	{
+		return AEMtx33();
+	}
+	inline AEMtx33 AEMtx33::Translate(float x, float y)
+	{
+		return AEMtx33(1.0f, 0.0f, x, 0.0f, 1.0f, y, 0.0f, 0.0f, 1.0f);
+	}
+	inline AEMtx33 AEMtx33::Scale(float sx, float sy)
+	{
+		return AEMtx33(sx, 0.0f, 0.0f, 0.0f, sy, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+	inline AEMtx33 AEMtx33::RotDeg(float angle_deg)
+	{
+		return RotRad(DegToRad(angle_deg));
+	}
+	inline AEMtx33 AEMtx33::RotRad(float angle_rad)
+	{
+		f32 c = cosf(angle_rad), s = sinf(angle_rad);
+		return AEMtx33(c, -s, 0.0f, s, c, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	// ---------------------------------------------------------------------------
+
+	inline void AEMtx33Identity(AEMtx33* pResult)
+	{
+		*pResult = AEMtx33(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+	inline void AEMtx33Transpose(AEMtx33* pResult, AEMtx33* pMtx)
+	{
+		*pResult = pMtx->Transpose();
+	}
+
+	// Returns the determinant. If it is (close to) zero, returns 0 and
+	// leaves pResult as it was.
+	inline f32 AEMtx33Inverse(AEMtx33* pResult, AEMtx33* pMtx)
+	{
+		const AEMtx33 & a = *pMtx;
+		AEMtx33 adj(
+			a.m22 * a.m33 - a.m23 * a.m32, a.m13 * a.m32 - a.m12 * a.m33, a.m12 * a.m23 - a.m13 * a.m22,
+			a.m23 * a.m31 - a.m21 * a.m33, a.m11 * a.m33 - a.m13 * a.m31, a.m13 * a.m21 - a.m11 * a.m23,
+			a.m21 * a.m32 - a.m22 * a.m31, a.m12 * a.m31 - a.m11 * a.m32, a.m11 * a.m22 - a.m12 * a.m21);
+
+		f32 det = a.m11 * adj.m11 + a.m12 * adj.m21 + a.m13 * adj.m31;
+		if (det * det < 1e-10f)
+			return 0.0f;
+
+		f32 invDet = 1.0f / det;
+		for (u32 i = 0; i < 9; ++i)
+			pResult->v[i] = adj.v[i] * invDet;
+		return det;
+	}
+	inline void AEMtx33InvTranspose(AEMtx33* pResult, AEMtx33* pMtx)
+	{
+		AEMtx33Inverse(pResult, pMtx);
+		AEMtx33Transpose(pResult, pResult);
+	}
+
+	inline void AEMtx33Concat(AEMtx33* pResult, AEMtx33* pMtx0, AEMtx33* pMtx1)
+	{
+		*pResult = pMtx0->Concat(*pMtx1);
+	}
+
+	inline f32 AEMtx33Determinant(AEMtx33* pMtx)
+	{
+		const AEMtx33 & a = *pMtx;
+		return a.m11 * (a.m22 * a.m33 - a.m23 * a.m32)
+			 - a.m12 * (a.m21 * a.m33 - a.m23 * a.m31)
+			 + a.m13 * (a.m21 * a.m32 - a.m22 * a.m31);
+	}
+
+	// ---------------------------------------------------------------------------
+	// rows and columns are 2D vectors: setting one zeroes its third element
+
+	inline void AEMtx33SetCol(AEMtx33* pResult, u32 col, AEVec2* pVec)
+	{
+		pResult->m[0][col] = pVec->x;
+		pResult->m[1][col] = pVec->y;
+		pResult->m[2][col] = 0.0f;
+	}
+	inline void AEMtx33SetRow(AEMtx33* pResult, u32 row, AEVec2* pVec)
+	{
+		pResult->m[row][0] = pVec->x;
+		pResult->m[row][1] = pVec->y;
+		pResult->m[row][2] = 0.0f;
+	}
+	inline void AEMtx33GetCol(AEVec2*  pResult, u32 col, AEMtx33* pMtx)
+	{
+		*pResult = AEVec2(pMtx->m[0][col], pMtx->m[1][col]);
+	}
+	inline void AEMtx33GetRow(AEVec2*  pResult, u32 row, AEMtx33* pMtx)
+	{
+		*pResult = AEVec2(pMtx->m[row][0], pMtx->m[row][1]);
+	}
+
+	// ---------------------------------------------------------------------------
+	// the Apply versions concatenate on the left: pResult = T * pMtx
+
+	inline void AEMtx33Trans(AEMtx33* pResult, f32 x, f32 y)
+	{
+		*pResult = AEMtx33::Translate(x, y);
+	}
+	inline void AEMtx33TransApply(AEMtx33* pResult, AEMtx33* pMtx, f32 x, f32 y)
+	{
+		*pResult = AEMtx33::Translate(x, y) * *pMtx;
+	}
+	inline void AEMtx33Scale(AEMtx33* pResult, f32 x, f32 y)
+	{
+		*pResult = AEMtx33::Scale(x, y);
+	}
+	inline void AEMtx33ScaleApply(AEMtx33* pResult, AEMtx33* pMtx, f32 x, f32 y)
+	{
+		*pResult = AEMtx33::Scale(x, y) * *pMtx;
+	}
+	inline void AEMtx33Rot(AEMtx33* pResult, f32 angle)
+	{
+		*pResult = AEMtx33::RotRad(angle);
+	}
+	inline void AEMtx33RotDeg(AEMtx33* pResult, f32 angle)
+	{
+		*pResult = AEMtx33::RotDeg(angle);
+	}
+	inline void AEMtx33RotApply(AEMtx33* pResult, AEMtx33* pMtx, f32 angle)
+	{
+		*pResult = AEMtx33::RotRad(angle) * *pMtx;
+	}
+	inline void AEMtx33RotDegApply(AEMtx33* pResult, AEMtx33* pMtx, f32 angle)
+	{
+		*pResult = AEMtx33::RotDeg(angle) * *pMtx;
+	}
+
+	// ---------------------------------------------------------------------------
+	// the SR versions ignore the translation
+
+	inline void AEMtx33MultVec(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec)
+	{
+		*pResult = pMtx->MultVec(*pVec);
+	}
+	inline void AEMtx33MultVecArray(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec, u32 count)
+	{
+		AEMtx33MultVecStrided(pResult, sizeof(AEVec2), pMtx, pVec, sizeof(AEVec2), count);
+	}
+	inline void AEMtx33MultVecSR(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec)
+	{
+		*pResult = pMtx->MultVecDir(*pVec);
+	}
+	inline void AEMtx33MultVecArraySR(AEVec2* pResult, AEMtx33* pMtx, AEVec2* pVec, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			pResult[i] = pMtx->MultVecDir(pVec[i]);
+	}
+
+	inline void AEMtx33MultVecArray(AEVec2* pVec, const AEMtx33* pMtx, u32 count)
+	{
+		AEMtx33MultVecStrided(pVec, sizeof(AEVec2), pMtx, pVec, sizeof(AEVec2), count);
+	}
+	inline void AEMtx33MultVecStrided(AEVec2* pResult, u32 resultStride, const AEMtx33* pMtx, const AEVec2* pVec, u32 vecStride, u32 count)
+	{
+		internal::Mtx33MultPoints(pResult->v, resultStride, pMtx->v, pVec->v, vecStride, count);
+	}
+	inline void AEMtx33MultVecStrided(AEVec2* pVec, u32 stride, const AEMtx33* pMtx, u32 count)
+	{
+		internal::Mtx33MultPoints(pVec->v, stride, pMtx->v, pVec->v, stride, count);
+	}
+	inline void AEMtx33MultVecSoA(f32* pResultX, f32* pResultY, const AEMtx33* pMtx, const f32* pX, const f32* pY, u32 count)
+	{
+		internal::Mtx33MultPointsSoA(pResultX, pResultY, pMtx->v, pX, pY, count);
+	}
+	inline void AEMtx33MultVecSoA(f32* pX, f32* pY, const AEMtx33* pMtx, u32 count)
+	{
+		internal::Mtx33MultPointsSoA(pX, pY, pMtx->v, pX, pY, count);
+	}
 }
 // ---------------------------------------------------------------------------
 
@@ -63,6 +63,182 @@ namespace AEX
 		static Quaternion MakeEulerXYZ(f32 x_rad, f32 y_rad, f32 z_rad);
 		static Quaternion MakeMatrix33(const AEMtx33 & rot33);
 	};
+
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline Quaternion::Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+	inline Quaternion::Quaternion(f32 xx, f32 yy, f32 zz, f32 ww) : x(xx), y(yy), z(zz), w(ww) {}
+	inline Quaternion::Quaternion(AEVec3 vec, f32 ww) : x(vec.x), y(vec.y), z(vec.z), w(ww) {}
+	inline Quaternion::Quaternion(AEVec3 vec) : x(vec.x), y(vec.y), z(vec.z), w(0.0f) {}
+
+	inline Quaternion Quaternion::operator+(const Quaternion & rhs) const	{ Quaternion r; internal::Vec4Add(r.v, v, rhs.v); return r; }
+	inline Quaternion Quaternion::operator-(const Quaternion & rhs) const	{ Quaternion r; internal::Vec4Sub(r.v, v, rhs.v); return r; }
+	inline Quaternion Quaternion::operator*(f32 scalar) const				{ Quaternion r; internal::Vec4Scale(r.v, v, scalar); return r; }
+	inline Quaternion Quaternion::operator/(f32 scalar) const				{ return *this * (1.0f / scalar); }
+	inline Quaternion& Quaternion::operator+=(const Quaternion & rhs)		{ internal::Vec4Add(v, v, rhs.v); return *this; }
+	inline Quaternion& Quaternion::operator-=(const Quaternion &rhs)		{ internal::Vec4Sub(v, v, rhs.v); return *this; }
+	inline Quaternion& Quaternion::operator*=(f32 scalar)					{ internal::Vec4Scale(v, v, scalar); return *this; }
+	inline Quaternion& Quaternion::operator/=(f32 scalar)					{ return *this *= (1.0f / scalar); }
+
+	// the product is normalized, so that errors don't build up when
+	// rotations are chained
+	inline Quaternion Quaternion::operator *(const Quaternion&rhs) const
+	{
+		Quaternion r;
+		internal::QuatConcat(r.v, v, rhs.v);
+		r.NormalizeThis();
+		return r;
+	}
+	inline Quaternion& Quaternion::operator*=(const Quaternion&rhs)
+	{
+		return *this = *this * rhs;
+	}
+
+	// q * v * q^-1, for a unit quaternion
+	inline AEVec3 Quaternion::operator*(const AEVec3 & rhs) const
+	{
+		AEVec3 u(x, y, z);
+		f32 d2 = 2.0f * (u * rhs);
+		f32 w2 = 2.0f * w;
+		f32 k = w2 * w - 1.0f;
+		return rhs * k + u * d2 + u.Cross(rhs) * w2;
+	}
+
+	inline void Quaternion::SetIdentity()
+	{
+		x = y = z = 0.0f;
+		w = 1.0f;
+	}
+	inline void Quaternion::NormalizeThis()
+	{
+		*this = Normalize();
+	}
+	inline f32 Quaternion::Length()const
+	{
+		return sqrtf(Dot(*this));
+	}
+	inline Quaternion Quaternion::Normalize() const
+	{
+		return *this / Length();
+	}
+	inline f32 Quaternion::Dot(const Quaternion &rhs) const
+	{
+		return internal::Vec4Dot(v, rhs.v);
+	}
+
+	// the conjugate: the inverse of a unit quaternion
+	inline Quaternion Quaternion::Inverse() const
+	{
+		return Quaternion(-x, -y, -z, w);
+	}
+
+	// ---------------------------------------------------------------------------
+	// conversions
+	//
+	// one convention for all: the matrices rotate column vectors like q * v
+	// (m[0][1] is 2(xy - wz)), as the ones made by RotateXYZ. FromMtx33/44
+	// and ToEulerXYZ read them back.
+
+	inline AEMtx33 Quaternion::ToMtx33() const
+	{
+		f32 s = 2.0f / Dot(*this);
+		f32 xs = x * s, ys = y * s, zs = z * s;
+		f32 wx = w * xs, wy = w * ys, wz = w * zs;
+		f32 xx = x * xs, xy = x * ys, xz = x * zs;
+		f32 yy = y * ys, yz = y * zs, zz = z * zs;
+		return AEMtx33(1.0f - (yy + zz), xy - wz, xz + wy,
+					   xy + wz, 1.0f - (xx + zz), yz - wx,
+					   xz - wy, yz + wx, 1.0f - (xx + yy));
+	}
+	inline AEMtx44 Quaternion::ToMtx44() const
+	{
+		return AEMtx44(ToMtx33());
+	}
+	inline AEVec3 Quaternion::ToEulerXYZ() const
+	{
+		AEVec3 angles;
+		ToMtx44().GetEulerAnglesXYZ(angles.x, angles.y, angles.z);
+		return angles;
+	}
+
+	inline Quaternion& Quaternion::FromMtx33(const AEMtx33& mtx33)
+	{
+		const AEMtx33 & m = mtx33;
+		f32 trace = m.m11 + m.m22 + m.m33;
+		if (trace > 0.0f)
+		{
+			f32 s = sqrtf(trace + 1.0f) * 2.0f;
+			w = 0.25f * s;
+			x = (m.m32 - m.m23) / s;
+			y = (m.m13 - m.m31) / s;
+			z = (m.m21 - m.m12) / s;
+		}
+		else if (m.m11 > m.m22 && m.m11 > m.m33)
+		{
+			f32 s = sqrtf(1.0f + m.m11 - m.m22 - m.m33) * 2.0f;
+			w = (m.m32 - m.m23) / s;
+			x = 0.25f * s;
+			y = (m.m12 + m.m21) / s;
+			z = (m.m13 + m.m31) / s;
+		}
+		else if (m.m22 > m.m33)
+		{
+			f32 s = sqrtf(1.0f + m.m22 - m.m11 - m.m33) * 2.0f;
+			w = (m.m13 - m.m31) / s;
+			x = (m.m12 + m.m21) / s;
+			y = 0.25f * s;
+			z = (m.m23 + m.m32) / s;
+		}
+		else
+		{
+			f32 s = sqrtf(1.0f + m.m33 - m.m11 - m.m22) * 2.0f;
+			w = (m.m21 - m.m12) / s;
+			x = (m.m13 + m.m31) / s;
+			y = (m.m23 + m.m32) / s;
+			z = 0.25f * s;
+		}
+		return *this;
+	}
+	inline Quaternion& Quaternion::FromMtx44(const AEMtx44& mtx44)
+	{
+		return FromMtx33(AEMtx33(mtx44));
+	}
+
+	// the axis doesn't need to be normalized: the result is
+	inline Quaternion& Quaternion::FromAxisAngle(const AEVec3 & axis, f32 angle_rad)
+	{
+		f32 s = sinf(angle_rad * 0.5f);
+		*this = Quaternion(axis * s, cosf(angle_rad * 0.5f));
+		NormalizeThis();
+		return *this;
+	}
+
+	// same rotation as AEMtx44::RotateXYZ: Rz * Ry * Rx
+	inline Quaternion& Quaternion::FromEulerXYZ(f32 x_rad, f32 y_rad, f32 z_rad)
+	{
+		f32 sx = sinf(x_rad * 0.5f), cx = cosf(x_rad * 0.5f);
+		f32 sy = sinf(y_rad * 0.5f), cy = cosf(y_rad * 0.5f);
+		f32 sz = sinf(z_rad * 0.5f), cz = cosf(z_rad * 0.5f);
+		x = cz * cy * sx - sz * sy * cx;
+		y = cz * sy * cx + sz * cy * sx;
+		z = sz * cy * cx - cz * sy * sx;
+		w = cz * cy * cx + sz * sy * sx;
+		return *this;
+	}
+
+	inline Quaternion Quaternion::MakeAxisAngle(const AEVec3 &axis, f32 angle_rad)
+	{
+		return Quaternion().FromAxisAngle(axis, angle_rad);
+	}
+	inline Quaternion Quaternion::MakeEulerXYZ(f32 x_rad, f32 y_rad, f32 z_rad)
+	{
+		return Quaternion().FromEulerXYZ(x_rad, y_rad, z_rad);
+	}
+	inline Quaternion Quaternion::MakeMatrix33(const AEMtx33 & rot33)
+	{
+		return Quaternion().FromMtx33(rot33);
+	}
 }
 #pragma warning (default:4201) // nameless struct warning
 
@@ -70,5 +70,112 @@ namespace AEX
 	 * Transforms an array of vertices using matrix arithmetic
 	 */
 	void AEX_MATH_API TransformVertices_Matrix(AEVec2 * oVertex, AEVec2 * wVertex, int size, Transform * transform);
+
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline Transform::Transform()
+		: mScale(1.0f, 1.0f)
+		, mOrientation(0.0f)
+	{}
+	inline Transform::Transform(const AEVec2 & pos, const AEVec2 & scale, f32 rot)
+		: mScale(scale)
+		, mTranslation(pos)
+		, mTranslationZ(pos)
+		, mOrientation(rot)
+	{}
+
+	inline AEMtx33 Transform::GetMatrix()
+	{
+		AEMtx33 r;
+		TransformGetMatrix(&r, this);
+		return r;
+	}
+	inline AEMtx33 Transform::GetInvMatrix()
+	{
+		AEMtx33 r;
+		TransformGetInvMatrix(&r, this);
+		return r;
+	}
+	inline Transform Transform::Concat(const Transform &rhs)
+	{
+		Transform r;
+		TransformConcatenate(&r, this, const_cast<Transform*>(&rhs));
+		return r;
+	}
+	inline Transform Transform::operator *(const Transform &rhs)
+	{
+		return Concat(rhs);
+	}
+	inline AEVec2 Transform::MultVec(const AEVec2 &rhs)
+	{
+		AEVec2 r;
+		TransformMultVec(&r, this, const_cast<AEVec2*>(&rhs));
+		return r;
+	}
+	inline AEVec2 Transform::operator *(const AEVec2 & rhs)
+	{
+		return MultVec(rhs);
+	}
+
+	// ---------------------------------------------------------------------------
+
+	inline void TransformMultVec(AEVec2 * pResult, Transform * transform, AEVec2 * pVec)
+	{
+		*pResult = transform->GetMatrix() * *pVec;
+	}
+
+	// T * R * S, composed directly. mOrientation is in degrees.
+	inline void TransformGetMatrix(AEMtx33 * pResult, Transform * transform)
+	{
+		f32 angle = DegToRad(transform->mOrientation);
+		f32 c = cosf(angle), s = sinf(angle);
+		const AEVec2 & sc = transform->mScale;
+		const AEVec2 & t = transform->mTranslation;
+		*pResult = AEMtx33(c * sc.x, -s * sc.y, t.x,
+						   s * sc.x, c * sc.y, t.y,
+						   0.0f, 0.0f, 1.0f);
+	}
+
+	// inverse(S) * transpose(R) * inverse(T)
+	inline void TransformGetInvMatrix(AEMtx33 * pResult, Transform * transform)
+	{
+		f32 angle = DegToRad(transform->mOrientation);
+		f32 c = cosf(angle), s = sinf(angle);
+		f32 isx = 1.0f / transform->mScale.x, isy = 1.0f / transform->mScale.y;
+		const AEVec2 & t = transform->mTranslation;
+		*pResult = AEMtx33(c * isx, s * isx, -(c * t.x + s * t.y) * isx,
+						   -s * isy, c * isy, (s * t.x - c * t.y) * isy,
+						   0.0f, 0.0f, 1.0f);
+	}
+
+	// mTranslationZ of pResult is left alone
+	inline void TransformConcatenate(Transform * pResult, Transform * t1, Transform * t0)
+	{
+		AEVec2 translation = t1->GetMatrix() * t0->mTranslation;
+		pResult->mScale = AEVec2(t1->mScale.x * t0->mScale.x, t1->mScale.y * t0->mScale.y);
+		pResult->mOrientation = t1->mOrientation + t0->mOrientation;
+		pResult->mTranslation = translation;
+	}
+
+	inline void TransformVertices_Vector(AEVec2 * oVertex, AEVec2 * wVertex, int size, Transform * transform)
+	{
+		// scale, rotate then translate each vertex
+		f32 angle = DegToRad(transform->mOrientation);
+		f32 c = cosf(angle), s = sinf(angle);
+		const AEVec2 & sc = transform->mScale;
+		const AEVec2 & t = transform->mTranslation;
+		for (int i = 0; i < size; ++i)
+		{
+			AEVec2 scaled(oVertex[i].x * sc.x, oVertex[i].y * sc.y);
+			wVertex[i] = AEVec2(c * scaled.x - s * scaled.y + t.x, s * scaled.x + c * scaled.y + t.y);
+		}
+	}
+	inline void TransformVertices_Matrix(AEVec2 * oVertex, AEVec2 * wVertex, int size, Transform * transform)
+	{
+		AEMtx33 mtx = transform->GetMatrix();
+		for (int i = 0; i < size; ++i)
+			wVertex[i] = mtx * oVertex[i];
+	}
 }
 #endif // TRANSFORM_H_
\ No newline at end of file
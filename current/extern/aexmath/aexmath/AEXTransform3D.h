@@ -34,6 +34,60 @@ namespace AEX
 		Transform3D operator * (const Transform3D & rhs);
 	};
 
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline Transform3D::Transform3D()
+		: scale(1.0f, 1.0f, 1.0f)
+	{}
+	inline Transform3D::Transform3D(const AEVec3 &pos, const AEVec3 &sca, const AEVec3 & eulers)
+		: position(pos)
+		, scale(sca)
+		, rot(Quaternion::MakeEulerXYZ(eulers.x, eulers.y, eulers.z))
+	{}
+	inline Transform3D::Transform3D(const AEVec3 &pos, const AEVec3 &sca, const Quaternion & rotation)
+		: position(pos)
+		, scale(sca)
+		, rot(rotation)
+	{}
+	inline Transform3D::Transform3D(const AEVec3 &pos, const AEVec3 &sca, const AEMtx33 &rotation)
+		: position(pos)
+		, scale(sca)
+		, rot(Quaternion::MakeMatrix33(rotation))
+	{}
+
+	// T * R * S, composed directly: R's columns scaled, position in the
+	// last column
+	inline AEMtx44 Transform3D::GetMatrix()
+	{
+		AEMtx33 r = rot.ToMtx33();
+		return AEMtx44(r.m11 * scale.x, r.m12 * scale.y, r.m13 * scale.z, position.x,
+					   r.m21 * scale.x, r.m22 * scale.y, r.m23 * scale.z, position.y,
+					   r.m31 * scale.x, r.m32 * scale.y, r.m33 * scale.z, position.z,
+					   0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	// inverse(S) * transpose(R) * inverse(T)
+	inline AEMtx44 Transform3D::GetInverseMatrix()
+	{
+		AEMtx33 r = rot.ToMtx33();
+		AEVec3 row0 = AEVec3(r.m11, r.m21, r.m31) / scale.x;
+		AEVec3 row1 = AEVec3(r.m12, r.m22, r.m32) / scale.y;
+		AEVec3 row2 = AEVec3(r.m13, r.m23, r.m33) / scale.z;
+		return AEMtx44(row0.x, row0.y, row0.z, -(row0 * position),
+					   row1.x, row1.y, row1.z, -(row1 * position),
+					   row2.x, row2.y, row2.z, -(row2 * position),
+					   0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	inline Transform3D Transform3D::operator * (const Transform3D & rhs)
+	{
+		AEVec3 scaled(scale.x * rhs.position.x, scale.y * rhs.position.y, scale.z * rhs.position.z);
+		return Transform3D(position + rot * scaled,
+						   AEVec3(scale.x * rhs.scale.x, scale.y * rhs.scale.y, scale.z * rhs.scale.z),
+						   rot * rhs.rot);
+	}
+
 }// namespace AEX
 // ---------------------------------------------------------------------------
 #endif
\ No newline at end of file
@@ -31,7 +31,6 @@ namespace AEX
 
 		// ------------------------------------------------------------------------
 		AEVec2();
-		AEVec2(const AEVec2& rhs);
 		AEVec2(f32 xx, f32 yy);
 		explicit	AEVec2(f32 xx);
 
@@ -88,6 +87,68 @@ namespace AEX
 
 	// typedef for point2D
 	typedef AEVec2 AEPoint2;
+
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline AEVec2::AEVec2() : x(0.0f), y(0.0f) {}
+	inline AEVec2::AEVec2(f32 xx, f32 yy) : x(xx), y(yy) {}
+	inline AEVec2::AEVec2(f32 xx) : x(xx), y(xx) {}
+
+	inline AEVec2 AEVec2::operator+(const AEVec2& rhs) const	{ return AEVec2(x + rhs.x, y + rhs.y); }
+	inline AEVec2 AEVec2::operator-(const AEVec2& rhs) const	{ return AEVec2(x - rhs.x, y - rhs.y); }
+	inline AEVec2 AEVec2::operator*(f32 s) const				{ return AEVec2(x * s, y * s); }
+	inline AEVec2 AEVec2::operator/(f32 s) const				{ return AEVec2(x / s, y / s); }
+	inline AEVec2 AEVec2::operator-() const						{ return AEVec2(-x, -y); }
+
+	// the compound operators return a copy
+	inline AEVec2 AEVec2::operator+=(const AEVec2& rhs)	{ x += rhs.x; y += rhs.y; return *this; }
+	inline AEVec2 AEVec2::operator-=(const AEVec2& rhs)	{ x -= rhs.x; y -= rhs.y; return *this; }
+	inline AEVec2 AEVec2::operator*=(f32 s)				{ x *= s; y *= s; return *this; }
+	inline AEVec2 AEVec2::operator/=(f32 s)				{ x /= s; y /= s; return *this; }
+
+	inline AEVec2 AEVec2::Perp() const					{ return AEVec2(-y, x); }
+	inline f32 AEVec2::Length() const					{ return sqrtf(x * x + y * y); }
+	inline f32 AEVec2::LengthSq() const					{ return x * x + y * y; }
+	inline f32 AEVec2::Distance(const AEVec2 &rhs)		{ return (*this - rhs).Length(); }
+	inline f32 AEVec2::DistanceSq(const AEVec2 &rhs)	{ return (*this - rhs).LengthSq(); }
+
+	// a null vector normalizes to itself
+	inline AEVec2 AEVec2::Normalize() const
+	{
+		f32 len = Length();
+		if (FLOAT_ZERO(len))
+			return AEVec2();
+		return *this / len;
+	}
+	inline const AEVec2 & AEVec2::NormalizeThis()
+	{
+		*this = Normalize();
+		return *this;
+	}
+
+	inline f32 AEVec2::Dot(const AEVec2& rhs) const			{ return x * rhs.x + y * rhs.y; }
+	inline f32 AEVec2::operator*(const AEVec2& rhs) const	{ return Dot(rhs); }
+
+	inline AEVec2 AEVec2::Project(const AEVec2& rhs)		{ return rhs * (Dot(rhs) / rhs.LengthSq()); }
+	inline AEVec2 AEVec2::ProjectPerp(const AEVec2& rhs)	{ return *this - Project(rhs); }
+	inline f32 AEVec2::CrossMag(const AEVec2& rhs)			{ return x * rhs.y - y * rhs.x; }
+
+	inline f32 AEVec2::GetAngle()				{ return atan2f(y, x); }
+	inline void AEVec2::FromAngle(f32 angle)	{ x = cosf(angle); y = sinf(angle); }
+
+	inline AEVec2 AEVec2::Random(AEVec2 min, AEVec2 max)
+	{
+		f32 rx = RandFloat(min.x, max.x);
+		f32 ry = RandFloat(min.y, max.y);
+		return AEVec2(rx, ry);
+	}
+
+	// note: returns 'from' at tn = 1 and 'to' at tn = 0
+	inline AEVec2 AEVec2::Lerp(AEVec2 from, AEVec2 to, f32 tn)
+	{
+		return from + (to - from) * (1.0f - tn);
+	}
 }
 
 
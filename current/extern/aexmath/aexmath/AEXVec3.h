@@ -28,7 +28,6 @@ namespace AEX
 		};
 
 		AEVec3();
-		AEVec3(const AEVec3& rhs);
 		AEVec3(const AEVec2 &rhs2D, f32 zz = 0.f);
 		AEVec3(f32 xx, f32 yy, f32 zz);
 		explicit	AEVec3(f32 xx);
@@ -67,6 +66,36 @@ namespace AEX
 		return (rhs * s);
 	}
 
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline AEVec3::AEVec3() : x(0.0f), y(0.0f), z(0.0f) {}
+	inline AEVec3::AEVec3(const AEVec2 &rhs2D, f32 zz) : x(rhs2D.x), y(rhs2D.y), z(zz) {}
+	inline AEVec3::AEVec3(f32 xx, f32 yy, f32 zz) : x(xx), y(yy), z(zz) {}
+	inline AEVec3::AEVec3(f32 xx) : x(xx), y(xx), z(xx) {}
+
+	inline AEVec3 AEVec3::operator+(const AEVec3& rhs) const	{ return AEVec3(x + rhs.x, y + rhs.y, z + rhs.z); }
+	inline AEVec3 AEVec3::operator-(const AEVec3& rhs) const	{ return AEVec3(x - rhs.x, y - rhs.y, z - rhs.z); }
+	inline AEVec3 AEVec3::operator*(f32 s) const				{ return AEVec3(x * s, y * s, z * s); }
+	inline AEVec3 AEVec3::operator/(f32 s) const				{ return AEVec3(x / s, y / s, z / s); }
+
+	inline AEVec3& AEVec3::operator+=(const AEVec3& rhs)	{ x += rhs.x; y += rhs.y; z += rhs.z; return *this; }
+	inline AEVec3& AEVec3::operator-=(const AEVec3& rhs)	{ x -= rhs.x; y -= rhs.y; z -= rhs.z; return *this; }
+	inline AEVec3& AEVec3::operator*=(f32 s)				{ x *= s; y *= s; z *= s; return *this; }
+	inline AEVec3& AEVec3::operator/=(f32 s)				{ x /= s; y /= s; z /= s; return *this; }
+
+	inline f32 AEVec3::Length() const						{ return sqrtf(x * x + y * y + z * z); }
+	inline AEVec3 AEVec3::Normalize() const					{ return *this / Length(); }
+	inline const AEVec3& AEVec3::NormalizeThis()			{ return *this = Normalize(); }
+	inline f32 AEVec3::operator*(const AEVec3& rhs) const	{ return x * rhs.x + y * rhs.y + z * rhs.z; }
+
+	inline AEVec3 AEVec3::Cross(const AEVec3& rhs) const
+	{
+		return AEVec3(y * rhs.z - z * rhs.y, z * rhs.x - x * rhs.z, x * rhs.y - y * rhs.x);
+	}
+
+	// ---------------------------------------------------------------------------
+
 	struct AEInteger4
 	{
 		union
@@ -31,6 +31,46 @@ namespace AEX
 		AEVec4 operator!();
 		AEVec4 Clamped();
 	};
+
+	// ---------------------------------------------------------------------------
+	// inline implementation
+
+	inline AEVec4::AEVec4(f32 rr, f32 gg, f32 bb, f32 aa) : x(rr), y(gg), z(bb), w(aa) {}
+
+	// 0xAARRGGBB
+	inline AEVec4::AEVec4(u32 color)
+		: x(f32((color >> 16) & 255) / 255.0f)
+		, y(f32((color >> 8) & 255) / 255.0f)
+		, z(f32(color & 255) / 255.0f)
+		, w(f32((color >> 24) & 255) / 255.0f)
+	{}
+	inline AEVec4::operator u32()
+	{
+		u32 aa = (w < 0.0f) ? (0) : ((w > 1.0f) ? (255) : (u32)(255.0f * w));
+		u32 rr = (x < 0.0f) ? (0) : ((x > 1.0f) ? (255) : (u32)(255.0f * x));
+		u32 gg = (y < 0.0f) ? (0) : ((y > 1.0f) ? (255) : (u32)(255.0f * y));
+		u32 bb = (z < 0.0f) ? (0) : ((z > 1.0f) ? (255) : (u32)(255.0f * z));
+		return ((aa << 24) | (rr << 16) | (gg << 8) | bb);
+	}
+
+	inline AEVec4 AEVec4::operator *(const AEVec4 & rhs)	{ AEVec4 r; internal::Vec4Mul(r.v, v, rhs.v); return r; }
+	inline AEVec4 AEVec4::operator *=(const AEVec4 & rhs)	{ internal::Vec4Mul(v, v, rhs.v); return *this; }
+	inline AEVec4 AEVec4::operator *(const f32 & sc)		{ AEVec4 r; internal::Vec4Scale(r.v, v, sc); return r; }
+	inline AEVec4 AEVec4::operator *=(const f32 & sc)		{ internal::Vec4Scale(v, v, sc); return *this; }
+	inline AEVec4 AEVec4::operator +(const AEVec4 & rhs)	{ AEVec4 r; internal::Vec4Add(r.v, v, rhs.v); return r; }
+	inline AEVec4& AEVec4::operator +=(const AEVec4 & rhs)	{ internal::Vec4Add(v, v, rhs.v); return *this; }
+	inline AEVec4 AEVec4::operator -(const AEVec4 & rhs)	{ AEVec4 r; internal::Vec4Sub(r.v, v, rhs.v); return r; }
+	inline AEVec4& AEVec4::operator -=(const AEVec4 & rhs)	{ internal::Vec4Sub(v, v, rhs.v); return *this; }
+
+	// same as Color
+	inline AEVec4 AEVec4::operator!()
+	{
+		return AEVec4(1.0f - x, 1.0f - y, 1.0f - z, 1.0f - w);
+	}
+	inline AEVec4 AEVec4::Clamped()
+	{
+		return AEVec4(Clamp(x, 0.5f, 1.0f), Clamp(y, 0.5f, 1.0f), Clamp(z, 0.5f, 1.0f), Clamp(w, 0.5f, 1.0f));
+	}
 }
 #pragma warning (default:4201) // nameless struct warning
 
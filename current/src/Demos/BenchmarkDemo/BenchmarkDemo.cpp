@@ -0,0 +1,874 @@
+#include "src\Engine\AEX.h"
+#include "BenchmarkDemo.h"
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+using namespace AEX;
+using std::cout;
+using std::endl;
+
+#pragma region Helpers
+// prints the time per iteration of a benchmark, in nanoseconds.
+void PrintResult(const char * name, f64 seconds, u32 iterations)
+{
+	cout << std::left << std::setw(48) << name
+		<< std::right << std::setw(10) << std::fixed << std::setprecision(2)
+		<< (seconds * 1e9 / iterations) << " ns/iter" << endl;
+}
+
+// written to by the benchmarks so that the optimizer keeps the work.
+volatile u32 gBenchSink = 0;
+#pragma endregion
+
+#pragma region Benchmark: Rtti IsDerived and aex_cast
+// deep hierarchy: DeepComp<N> -> DeepComp<N-1> -> ... -> DeepComp<0> -> IComp -> IBase
+template <u32 N> struct DeepComp : public DeepComp<N - 1>
+{
+	typedef DeepComp<N>		ThisType;
+	typedef DeepComp<N - 1>	ParentType;
+	AEX_RTTI_DECL(ThisType, ParentType);
+};
+template <> struct DeepComp<0> : public IComp
+{
+	AEX_RTTI_DECL(DeepComp<0>, IComp);
+};
+
+// previous implementation of Rtti::IsDerived: walks up the base pointers.
+bool IsDerivedWalk(const Rtti & type, const Rtti & otherType)
+{
+	const Rtti * temp = &type;
+	while (temp)
+	{
+		if (temp == &otherType)
+			return true;
+		temp = temp->GetBaseType();
+	}
+	return false;
+}
+
+void Bench_RttiIsDerived()
+{
+	const u32 iterations = 10000000;
+	DeepComp<31> deepest;
+	IComp * comp = &deepest;
+	const Rtti & root = DeepComp<0>::TYPE();
+	const Rtti & unrelated = GameObject::TYPE();
+
+	cout << "\n-------------- Rtti: depth " << 34 << " hierarchy --------------\n";
+
+	// derived from the root of the chain (walk goes all the way up)
+	f64 start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += IsDerivedWalk(comp->GetType(), root);
+	PrintResult("IsDerived (pointer walk, hit)", FRC::GetCPUTime() - start, iterations);
+
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += comp->GetType().IsDerived(root);
+	PrintResult("IsDerived (interval, hit)", FRC::GetCPUTime() - start, iterations);
+
+	// not derived: worst case for the walk
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += IsDerivedWalk(comp->GetType(), unrelated);
+	PrintResult("IsDerived (pointer walk, miss)", FRC::GetCPUTime() - start, iterations);
+
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += comp->GetType().IsDerived(unrelated);
+	PrintResult("IsDerived (interval, miss)", FRC::GetCPUTime() - start, iterations);
+
+	// checked casts
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += dynamic_cast<DeepComp<0>*>(comp) != NULL;
+	PrintResult("dynamic_cast", FRC::GetCPUTime() - start, iterations);
+
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < iterations; ++i)
+		gBenchSink += aex_cast<DeepComp<0>>(comp) != NULL;
+	PrintResult("aex_cast", FRC::GetCPUTime() - start, iterations);
+}
+#pragma endregion
+
+#pragma region Benchmark: Logic registry
+// a few logic component types, registered interleaved.
+struct BenchLogicBase : public LogicComp
+{
+	AEX_RTTI_DECL(BenchLogicBase, LogicComp);
+	u32 mCounter = 0;
+};
+template <u32 N> struct BenchLogicComp : public BenchLogicBase
+{
+	typedef BenchLogicComp<N>	ThisType;
+	AEX_RTTI_DECL(ThisType, BenchLogicBase);
+	virtual void Update() { mCounter += N + 1; }
+};
+
+// previous implementation of the Logic system: std::list with remove before push_back.
+struct ListLogic
+{
+	std::list<IComp *> mComps;
+	void AddComp(IComp * logicComp) {
+		mComps.remove(logicComp); // no duplicates
+		mComps.push_back(logicComp);
+	}
+	void Update() {
+		FOR_EACH(comp, mComps)
+			(*comp)->Update();
+	}
+};
+
+void Bench_LogicRegistry()
+{
+	const u32 compCount = 100000;
+	const u32 listInitCount = 10000;	// the list init is O(N^2), 100k takes minutes
+	const u32 frames = 100;
+
+	cout << "\n-------------- Logic: " << compCount << " components, 4 types --------------\n";
+
+	std::vector<LogicComp *> comps;
+	for (u32 i = 0; i < compCount; ++i)
+	{
+		switch (i % 4)
+		{
+		case 0: comps.push_back(IComp::Create<BenchLogicComp<0>>()); break;
+		case 1: comps.push_back(IComp::Create<BenchLogicComp<1>>()); break;
+		case 2: comps.push_back(IComp::Create<BenchLogicComp<2>>()); break;
+		case 3: comps.push_back(IComp::Create<BenchLogicComp<3>>()); break;
+		}
+	}
+
+	// objects are created and destroyed over time: register in a scattered order
+	std::shuffle(comps.begin(), comps.end(), std::mt19937(1234));
+
+	// init
+	ListLogic listLogic;
+	f64 start = FRC::GetCPUTime();
+	for (u32 i = 0; i < listInitCount; ++i)
+		listLogic.AddComp(comps[i]);
+	PrintResult("init, std::list (10k comps, per comp)", FRC::GetCPUTime() - start, listInitCount);
+	for (u32 i = listInitCount; i < compCount; ++i) // no duplicates by construction
+		listLogic.mComps.push_back(comps[i]);
+
+	Logic * logic = Logic::Instance();
+	logic->ClearComps();
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < compCount; ++i)
+		logic->AddComp(comps[i]);
+	PrintResult("init, dense registry (per comp)", FRC::GetCPUTime() - start, compCount);
+
+	// update
+	start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+		listLogic.Update();
+	PrintResult("update, std::list (per comp)", FRC::GetCPUTime() - start, frames * compCount);
+
+	start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+		logic->Update();
+	PrintResult("update, dense registry (per comp)", FRC::GetCPUTime() - start, frames * compCount);
+
+	// remove
+	start = FRC::GetCPUTime();
+	for (u32 i = 0; i < compCount; ++i)
+		logic->RemoveComp(comps[i]);
+	PrintResult("remove, dense registry (per comp)", FRC::GetCPUTime() - start, compCount);
+
+	FOR_EACH(it, comps)
+		gBenchSink += static_cast<BenchLogicBase*>(*it)->mCounter;
+	FOR_EACH(it, comps)
+		IComp::Destroy(*it);
+}
+#pragma endregion
+
+#pragma region Benchmark: Job system
+void EmptyJob(Job *, const void *) {}
+
+// embarrassingly parallel: some math per element, no sharing
+void HeavyRange(const void * context, u32 begin, u32 end)
+{
+	f32 * values = (f32*)context;
+	for (u32 i = begin; i < end; ++i)
+	{
+		f32 x = values[i];
+		for (u32 k = 0; k < 64; ++k)
+			x = x * 0.999f + 0.5f / (1.0f + x * x);
+		values[i] = x;
+	}
+}
+
+void Bench_JobSystem()
+{
+	JobSystem * jobs = aexJobSystem;
+	u32 hardwareThreads = std::thread::hardware_concurrency();
+	if (hardwareThreads == 0)
+		hardwareThreads = 1;
+
+	cout << "\n-------------- Job system: " << hardwareThreads << " hardware threads --------------\n";
+
+	// spawn overhead: create + run + execute + finish of empty jobs
+	const u32 batches = 1000, jobsPerBatch = 1000;
+	for (u32 threads = 1;; threads *= 2) // 1, 2, 4... and all of them
+	{
+		if (threads > hardwareThreads)
+			threads = hardwareThreads;
+		jobs->Start(threads);
+		f64 start = FRC::GetCPUTime();
+		for (u32 b = 0; b < batches; ++b)
+		{
+			Job * root = jobs->CreateJob(&EmptyJob);
+			for (u32 i = 0; i < jobsPerBatch; ++i)
+				jobs->Run(jobs->CreateChildJob(root, &EmptyJob));
+			jobs->RunAndWait(root);
+		}
+		std::stringstream name;
+		name << "empty job spawn+wait (" << threads << " threads)";
+		PrintResult(name.str().c_str(), FRC::GetCPUTime() - start, batches * (jobsPerBatch + 1));
+		if (threads == hardwareThreads)
+			break;
+	}
+
+	// scaling: same work, 1 to N threads
+	const u32 count = 1 << 20, frames = 10;
+	std::vector<f32> values(count, 1.0f);
+	f64 singleThread = 0.0;
+	for (u32 threads = 1; threads <= hardwareThreads; ++threads)
+	{
+		jobs->Start(threads);
+		f64 start = FRC::GetCPUTime();
+		for (u32 f = 0; f < frames; ++f)
+			jobs->ParallelFor(count, 4096, &HeavyRange, &values[0]);
+		f64 elapsed = FRC::GetCPUTime() - start;
+		if (threads == 1)
+			singleThread = elapsed;
+
+		std::stringstream name;
+		name << "parallel for, 1M elements (" << threads << " threads, x" << std::setprecision(2) << std::fixed << singleThread / elapsed << ")";
+		PrintResult(name.str().c_str(), elapsed, frames * count);
+	}
+	gBenchSink += (u32)values[count / 2];
+
+	// back to the default
+	jobs->Start();
+}
+#pragma endregion
+
+#pragma region Benchmark: Hash maps
+// builds the map from keys, then looks up every query (hits and misses)
+// passes times over. Q is the type used by the engine for the lookups.
+template <typename TMap, typename TKey, typename Q>
+void BenchMap(const char * name, const std::vector<TKey> & keys, const std::vector<Q> & queries, u32 passes)
+{
+	f64 start = FRC::GetCPUTime();
+	TMap map;
+	for (u32 i = 0; i < keys.size(); ++i)
+		map[keys[i]] = i;
+	f64 buildTime = FRC::GetCPUTime() - start;
+
+	start = FRC::GetCPUTime();
+	for (u32 pass = 0; pass < passes; ++pass)
+	{
+		for (u32 i = 0; i < queries.size(); ++i)
+		{
+			typename TMap::const_iterator it = static_cast<const TMap&>(map).find(queries[i]);
+			if (it != map.end())
+				gBenchSink += it->second;
+		}
+	}
+	f64 findTime = FRC::GetCPUTime() - start;
+
+	std::string label = std::string(name) + " insert";
+	PrintResult(label.c_str(), buildTime, keys.size());
+	label = std::string(name) + " find";
+	PrintResult(label.c_str(), findTime, passes * queries.size());
+}
+
+void Bench_HashMap()
+{
+	std::mt19937 rng(1234);
+
+	// Rtti ids: a few hundred type name hashes (archetype edges, Rtti registry)
+	{
+		std::vector<u32> keys, queries;
+		for (u32 i = 0; i < 256; ++i)
+		{
+			std::stringstream typeName;
+			typeName << "struct AEX::BenchComp" << i;
+			keys.push_back(StringId::Hash(typeName.str().c_str()));
+		}
+		for (u32 i = 0; i < 100000; ++i)
+			queries.push_back(keys[rng() % keys.size()]);
+
+		cout << "\n-------------- Maps: 256 Rtti ids (u32), lookups hit --------------\n";
+		BenchMap<std::map<u32, u32> >			("std::map", keys, queries, 20);
+		BenchMap<std::unordered_map<u32, u32> >	("std::unordered_map", keys, queries, 20);
+		BenchMap<FlatMap<u32, u32> >			("FlatMap", keys, queries, 20);
+		BenchMap<HashMap<u32, u32> >			("HashMap", keys, queries, 20);
+	}
+
+	// resources: StringId64 of file names, half the lookups miss
+	std::vector<std::string> names;
+	for (u32 i = 0; i < 20000; ++i)
+	{
+		std::stringstream resName;
+		resName << (i % 3 == 0 ? "data/textures/tex_" : i % 3 == 1 ? "data/models/mesh_" : "data/shaders/prog_") << i << ".res";
+		names.push_back(resName.str());
+	}
+	{
+		std::vector<u64> keys, queries;
+		for (u32 i = 0; i < names.size(); i += 2)
+			keys.push_back(StringId64::Hash(names[i].c_str()));
+		for (u32 i = 0; i < 100000; ++i)
+			queries.push_back(StringId64::Hash(names[rng() % names.size()].c_str()));
+
+		cout << "\n-------------- Maps: 10k resource ids (u64), 50% miss --------------\n";
+		BenchMap<std::map<u64, u32> >			("std::map", keys, queries, 10);
+		BenchMap<std::unordered_map<u64, u32> >	("std::unordered_map", keys, queries, 10);
+		BenchMap<FlatMap<u64, u32> >			("FlatMap", keys, queries, 10);
+		BenchMap<HashMap<u64, u32> >			("HashMap", keys, queries, 10);
+	}
+
+	// dictionaries: string keys looked up by const char * (factory, json)
+	{
+		std::vector<std::string> keys;
+		std::vector<const char *> queries;
+		for (u32 i = 0; i < names.size(); i += 2)
+			keys.push_back(names[i]);
+		for (u32 i = 0; i < 100000; ++i)
+			queries.push_back(names[rng() % names.size()].c_str());
+
+		cout << "\n-------------- Maps: 10k names (std::string) by const char *, 50% miss --------------\n";
+		BenchMap<std::map<std::string, u32> >			("std::map (builds a string)", keys, queries, 5);
+		BenchMap<std::unordered_map<std::string, u32> >	("std::unordered_map (builds a string)", keys, queries, 5);
+		BenchMap<FlatMap<std::string, u32> >			("FlatMap", keys, queries, 5);
+		BenchMap<HashMap<std::string, u32> >			("HashMap", keys, queries, 5);
+	}
+}
+#pragma endregion
+
+#pragma region Benchmark: GameObject pooling
+// bullet-like object: a transform and a logic component
+const u32 kBulletCount = 2000;	// live at once
+void BuildBullet(GameObject * obj)
+{
+	obj->NewComp<TransformComp>();
+	obj->NewComp<BenchLogicComp<0>>();
+}
+
+void Bench_ObjectPool()
+{
+	const u32 frames = 100;
+	Scene * scene = aexScene;
+	std::vector<GameObject *> bullets(kBulletCount);
+
+	cout << "\n-------------- Spawn/destroy: " << kBulletCount << " objects per frame --------------\n";
+
+	// built and torn down every time
+	f64 start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+	{
+		for (u32 i = 0; i < kBulletCount; ++i)
+		{
+			GameObject * obj = scene->NewObject("Bullet");
+			BuildBullet(obj);
+			obj->Initialize();
+			bullets[i] = obj;
+		}
+		for (u32 i = 0; i < kBulletCount; ++i)
+			scene->DestroyObject(bullets[i]);
+	}
+	PrintResult("new + build + initialize/destroy (per object)", FRC::GetCPUTime() - start, frames * kBulletCount);
+
+	// recycled: warmed up in LoadResources
+	ObjectPool * pool = aexObjectPool;
+	StringId key = AEX_SID("Bullet");
+	start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+	{
+		for (u32 i = 0; i < kBulletCount; ++i)
+			bullets[i] = pool->Spawn(key);
+		for (u32 i = 0; i < kBulletCount; ++i)
+			scene->DestroyObject(bullets[i]);
+	}
+	PrintResult("ObjectPool spawn/destroy (per object)", FRC::GetCPUTime() - start, frames * kBulletCount);
+
+	ObjectPoolStats stats = pool->GetStats(key);
+	cout << "hit rate " << std::setprecision(1) << 100.0f * stats.GetHitRate() << "%, peak " << stats.mPeakCount << endl;
+}
+#pragma endregion
+
+#pragma region Benchmark: Prefab instancing
+// enemy-like object: 2D and 3D transforms with non default values, a logic component
+const u32 kEnemyCount = 10000;
+void SetupEnemy(TransformComp * tr, TransformComp3D * tr3D, BenchLogicBase * logic)
+{
+	tr->SetScale(AEVec2(2.0f, 2.0f));
+	tr->SetRotationAngle(0.5f);
+	tr3D->SetScale(2.0f);
+	logic->mCounter = 100;
+}
+
+void Bench_Prefab()
+{
+	Scene * scene = aexScene;
+	std::vector<GameObject *> enemies(kEnemyCount);
+
+	cout << "\n-------------- Prefab: " << kEnemyCount << " objects --------------\n";
+
+	// by hand, component by component
+	f64 start = FRC::GetCPUTime();
+	for (u32 i = 0; i < kEnemyCount; ++i)
+	{
+		GameObject * obj = scene->NewObject("Enemy", "Enemies");
+		SetupEnemy(obj->NewComp<TransformComp>(), obj->NewComp<TransformComp3D>(), obj->NewComp<BenchLogicComp<1>>());
+		obj->Initialize();
+		enemies[i] = obj;
+	}
+	PrintResult("new + add components + initialize (per object)", FRC::GetCPUTime() - start, kEnemyCount);
+	for (u32 i = 0; i < kEnemyCount; ++i)
+		scene->DestroyObject(enemies[i]);
+
+	// compiled once, instanced in bulk
+	Prefab prefab("Enemy");
+	prefab.SetTag("Enemies");
+	SetupEnemy(prefab.AddComp<TransformComp>(), prefab.AddComp<TransformComp3D>(), prefab.AddComp<BenchLogicComp<1>>());
+	prefab.Compile();
+
+	AEX_PTR_ARRAY(GameObject) instances;
+	start = FRC::GetCPUTime();
+	prefab.Instantiate(kEnemyCount, instances);
+	PrintResult("Prefab::Instantiate (per object)", FRC::GetCPUTime() - start, kEnemyCount);
+
+	gBenchSink = instances.back()->GetComp<BenchLogicComp<1>>()->mCounter;
+	FOR_EACH(it, instances)
+		scene->DestroyObject(*it);
+}
+#pragma endregion
+
+#pragma region Benchmark: Math kernels
+// the math used to be in a dll: every operation was a call the compiler
+// couldn't inline. Modeled with calls through volatile function pointers.
+typedef void(*Mtx44ConcatFn)(f32 *, const f32 *, const f32 *);
+typedef bool(*Mtx44InverseFn)(f32 *, const f32 *);
+void Mtx44ConcatCall(f32 * r, const f32 * a, const f32 * b) { internal::Mtx44Concat_Scalar(r, a, b); }
+bool Mtx44InverseCall(f32 * r, const f32 * m) { return internal::Mtx44Inverse_Scalar(r, m); }
+Mtx44ConcatFn volatile gMtx44ConcatCall = &Mtx44ConcatCall;
+Mtx44InverseFn volatile gMtx44InverseCall = &Mtx44InverseCall;
+
+const u32 kMathCount = 1024, kMathPasses = 2000;
+
+// runs op(i) for every element, kMathPasses times. Prints the time per op
+// and the speedup over the baseline time, if given.
+template <typename Op>
+f64 BenchMath(const char * name, Op op, f64 baseline = 0.0)
+{
+	f64 start = FRC::GetCPUTime();
+	for (u32 p = 0; p < kMathPasses; ++p)
+		for (u32 i = 0; i < kMathCount; ++i)
+			op(i);
+	f64 elapsed = FRC::GetCPUTime() - start;
+
+	std::stringstream label;
+	label << name;
+	if (baseline > 0.0)
+		label << " (x" << std::setprecision(2) << std::fixed << baseline / elapsed << ")";
+	PrintResult(label.str().c_str(), elapsed, kMathPasses * kMathCount);
+	return elapsed;
+}
+
+void Bench_Math()
+{
+#if defined(AEX_MATH_AVX)
+	cout << "\n-------------- Math kernels: scalar, SSE, AVX --------------\n";
+#elif defined(AEX_MATH_SSE)
+	cout << "\n-------------- Math kernels: scalar, SSE --------------\n";
+#else
+	cout << "\n-------------- Math kernels: scalar only (AEX_MATH_NO_SIMD) --------------\n";
+#endif
+
+	// random matrices, made invertible by a heavy diagonal
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<f32> dist(-1.0f, 1.0f);
+	std::vector<AEMtx44> a(kMathCount), b(kMathCount), r(kMathCount);
+	std::vector<AEVec4> va(kMathCount), vb(kMathCount), vr(kMathCount);
+	std::vector<Quaternion> qa(kMathCount), qb(kMathCount), qr(kMathCount);
+	std::vector<f32> dots(kMathCount);
+	for (u32 i = 0; i < kMathCount; ++i)
+	{
+		for (u32 k = 0; k < 16; ++k)
+		{
+			a[i].v[k] = dist(rng) + ((k % 5) ? 0.0f : 4.0f);
+			b[i].v[k] = dist(rng);
+		}
+		va[i] = AEVec4(dist(rng), dist(rng), dist(rng), dist(rng));
+		vb[i] = AEVec4(dist(rng), dist(rng), dist(rng), dist(rng));
+		qa[i] = Quaternion::MakeEulerXYZ(dist(rng), dist(rng), dist(rng));
+		qb[i] = Quaternion::MakeEulerXYZ(dist(rng), dist(rng), dist(rng));
+	}
+
+	f64 base;
+	base = BenchMath("Mtx44 concat, dll call", [&](u32 i) { gMtx44ConcatCall(r[i].v, a[i].v, b[i].v); });
+	BenchMath("Mtx44 concat, scalar", [&](u32 i) { internal::Mtx44Concat_Scalar(r[i].v, a[i].v, b[i].v); }, base);
+#ifdef AEX_MATH_SSE
+	BenchMath("Mtx44 concat, SSE", [&](u32 i) { internal::Mtx44Concat_SSE(r[i].v, a[i].v, b[i].v); }, base);
+#endif
+#ifdef AEX_MATH_AVX
+	BenchMath("Mtx44 concat, AVX", [&](u32 i) { internal::Mtx44Concat_AVX(r[i].v, a[i].v, b[i].v); }, base);
+#endif
+	BenchMath("AEMtx44 * AEMtx44", [&](u32 i) { r[i] = a[i] * b[i]; }, base);
+	gBenchSink += (u32)r[kMathCount / 2].m[1][2];
+
+	base = BenchMath("Mtx44 inverse, dll call", [&](u32 i) { gMtx44InverseCall(r[i].v, a[i].v); });
+	BenchMath("Mtx44 inverse, scalar", [&](u32 i) { internal::Mtx44Inverse_Scalar(r[i].v, a[i].v); }, base);
+#ifdef AEX_MATH_SSE
+	BenchMath("Mtx44 inverse, SSE", [&](u32 i) { internal::Mtx44Inverse_SSE(r[i].v, a[i].v); }, base);
+#endif
+	gBenchSink += (u32)r[kMathCount / 2].m[1][2];
+
+	base = BenchMath("Mtx44 * vec, scalar", [&](u32 i) { internal::Mtx44MultVec_Scalar(vr[i].v, a[i].v, va[i].x, va[i].y, va[i].z, 1.0f); });
+#ifdef AEX_MATH_SSE
+	BenchMath("Mtx44 * vec, SSE", [&](u32 i) { internal::Mtx44MultVec_SSE(vr[i].v, a[i].v, va[i].x, va[i].y, va[i].z, 1.0f); }, base);
+#endif
+	gBenchSink += (u32)vr[kMathCount / 2].x;
+
+	base = BenchMath("Vec4 mul, scalar", [&](u32 i) { internal::Vec4Mul_Scalar(vr[i].v, va[i].v, vb[i].v); });
+#ifdef AEX_MATH_SSE
+	BenchMath("Vec4 mul, SSE", [&](u32 i) { internal::Vec4Mul_SSE(vr[i].v, va[i].v, vb[i].v); }, base);
+#endif
+	base = BenchMath("Vec4 dot, scalar", [&](u32 i) { dots[i] = internal::Vec4Dot_Scalar(va[i].v, vb[i].v); });
+#ifdef AEX_MATH_SSE
+	BenchMath("Vec4 dot, SSE", [&](u32 i) { dots[i] = internal::Vec4Dot_SSE(va[i].v, vb[i].v); }, base);
+#endif
+	gBenchSink += (u32)(vr[kMathCount / 2].x + dots[kMathCount / 2]);
+
+	base = BenchMath("Quaternion concat, scalar", [&](u32 i) { internal::QuatConcat_Scalar(qr[i].v, qa[i].v, qb[i].v); });
+#ifdef AEX_MATH_SSE
+	BenchMath("Quaternion concat, SSE", [&](u32 i) { internal::QuatConcat_SSE(qr[i].v, qa[i].v, qb[i].v); }, base);
+#endif
+	BenchMath("Quaternion * Quaternion (normalized)", [&](u32 i) { qr[i] = qa[i] * qb[i]; }, base);
+	gBenchSink += (u32)qr[kMathCount / 2].w;
+
+	// the conversions undo each other: Euler angles -> quaternion -> Euler
+	// angles, quaternion -> matrix -> quaternion (q or -q), and the matrix
+	// rotates like the quaternion
+	u32 mismatches = 0;
+	for (u32 i = 0; i < kMathCount; ++i)
+	{
+		AEVec3 angles(dist(rng), dist(rng), dist(rng));
+		mismatches += (Quaternion::MakeEulerXYZ(angles.x, angles.y, angles.z).ToEulerXYZ() - angles).Length() > 1e-4f;
+		Quaternion back = Quaternion().FromMtx44(qa[i].ToMtx44());
+		mismatches += 1.0f - fabsf(back.Dot(qa[i])) > 1e-5f;
+		AEVec3 point(va[i].x, va[i].y, va[i].z);
+		mismatches += (qa[i].ToMtx44() * point - qa[i] * point).Length() > 1e-4f;
+	}
+	cout << "  " << mismatches << " quaternion round trip mismatches\n";
+}
+#pragma endregion
+
+#pragma region Benchmark: Batch point transforms
+const u32 kPointCount = 1 << 20, kPointPasses = 10;
+
+// runs op over all the points kPointPasses times. Prints the time per
+// point and the speedup over the baseline time, if given.
+template <typename Op>
+f64 BenchPoints(const char * name, Op op, f64 baseline = 0.0)
+{
+	f64 start = FRC::GetCPUTime();
+	for (u32 p = 0; p < kPointPasses; ++p)
+		op();
+	f64 elapsed = FRC::GetCPUTime() - start;
+
+	std::stringstream label;
+	label << name;
+	if (baseline > 0.0)
+		label << " (x" << std::setprecision(2) << std::fixed << baseline / elapsed << ")";
+	PrintResult(label.str().c_str(), elapsed, kPointPasses * kPointCount);
+	return elapsed;
+}
+
+void Bench_PointTransforms()
+{
+	cout << "\n-------------- Batch point transforms: 1M points --------------\n";
+
+	// a rotation close to identity: the points stay in range pass after pass
+	AEMtx33 mtx = AEMtx33::Translate(0.001f, 0.002f) * AEMtx33::RotRad(0.001f);
+	AEMtx44 mtx4 = AEMtx44::Translate(0.001f, 0.002f, 0.003f) * AEMtx44::Rotate(0.001f, 0.002f, 0.003f);
+
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<f32> dist(-100.0f, 100.0f);
+	std::vector<Vertex> vertices(kPointCount);
+	std::vector<AEVec2> points(kPointCount);
+	std::vector<AEVec3> points3D(kPointCount);
+	std::vector<f32> xs(kPointCount), ys(kPointCount), zs(kPointCount);
+	for (u32 i = 0; i < kPointCount; ++i)
+	{
+		vertices[i].mPosition = points[i] = AEVec2(dist(rng), dist(rng));
+		points3D[i] = AEVec3(points[i].x, points[i].y, dist(rng));
+		xs[i] = points3D[i].x; ys[i] = points3D[i].y; zs[i] = points3D[i].z;
+	}
+
+	// vertex positions, in place: what Model::Transform does
+	f64 base = BenchPoints("Vertex, one AEMtx33MultVec each", [&]() {
+		for (u32 i = 0; i < kPointCount; ++i)
+			AEMtx33MultVec(&vertices[i].mPosition, &mtx, &vertices[i].mPosition);
+	});
+	BenchPoints("Vertex, strided, scalar kernel", [&]() {
+		internal::Mtx33MultPoints_Scalar(vertices[0].mPosition.v, sizeof(Vertex), mtx.v, vertices[0].mPosition.v, sizeof(Vertex), kPointCount);
+	}, base);
+	BenchPoints("Vertex, AEMtx33MultVecStrided", [&]() {
+		AEMtx33MultVecStrided(&vertices[0].mPosition, sizeof(Vertex), &mtx, kPointCount);
+	}, base);
+
+	// packed and SoA 2D points
+	BenchPoints("AEVec2[], AEMtx33MultVecArray", [&]() {
+		AEMtx33MultVecArray(&points[0], &mtx, kPointCount);
+	}, base);
+	BenchPoints("SoA 2D, scalar kernel", [&]() {
+		internal::Mtx33MultPointsSoA_Scalar(&xs[0], &ys[0], mtx.v, &xs[0], &ys[0], kPointCount);
+	}, base);
+	BenchPoints("SoA 2D, AEMtx33MultVecSoA", [&]() {
+		AEMtx33MultVecSoA(&xs[0], &ys[0], &mtx, kPointCount);
+	}, base);
+	gBenchSink += (u32)(vertices[kPointCount / 2].mPosition.x + points[kPointCount / 2].x + xs[kPointCount / 2]);
+
+	// 3D points
+	base = BenchPoints("AEVec3, one AEMtx44 * each", [&]() {
+		for (u32 i = 0; i < kPointCount; ++i)
+			points3D[i] = mtx4 * points3D[i];
+	});
+	BenchPoints("AEVec3[], AEMtx44MultVecArray", [&]() {
+		AEMtx44MultVecArray(&points3D[0], &mtx4, kPointCount);
+	}, base);
+	BenchPoints("SoA 3D, scalar kernel", [&]() {
+		internal::Mtx44MultPointsSoA_Scalar(&xs[0], &ys[0], &zs[0], mtx4.v, &xs[0], &ys[0], &zs[0], kPointCount);
+	}, base);
+	BenchPoints("SoA 3D, AEMtx44MultVecSoA", [&]() {
+		AEMtx44MultVecSoA(&xs[0], &ys[0], &zs[0], &mtx4, kPointCount);
+	}, base);
+	gBenchSink += (u32)(points3D[kPointCount / 2].z + zs[kPointCount / 2]);
+}
+#pragma endregion
+
+#pragma region Benchmark: Transform hierarchy
+// characters: a root, limbs, attachments on each limb
+const u32 kCharacterCount = 2000, kLimbCount = 8, kAttachmentCount = 4;
+
+// what gameplay code does without the hierarchy: multiply up the parents
+AEMtx44 WalkUpWorld(const std::vector<TransformComp*> & transforms, const std::vector<u32> & parents, u32 i)
+{
+	AEMtx44 world = transforms[i]->GetLocalToParent4x4();
+	for (u32 p = parents[i]; p != TransformHierarchy::kInvalidNode; p = parents[p])
+		world = transforms[p]->GetLocalToParent4x4() * world;
+	return world;
+}
+
+void Bench_TransformHierarchy()
+{
+	Scene * scene = aexScene;
+	TransformHierarchy * hierarchy = aexTransformHierarchy;
+	std::vector<TransformComp*> transforms;
+	std::vector<u32> parents, roots;
+
+	auto NewTransform = [&](u32 parent)
+	{
+		GameObject * obj = scene->NewObject("Node");
+		TransformComp * tr = obj->NewComp<TransformComp>();
+		obj->Initialize();
+		tr->SetPosition3D(AEVec3(1.0f, 0.5f, 0.0f));
+		tr->SetRotationAngle(0.1f);
+		if (parent != TransformHierarchy::kInvalidNode)
+			tr->SetParent(transforms[parent]);
+		transforms.push_back(tr);
+		parents.push_back(parent);
+		return (u32)transforms.size() - 1;
+	};
+	for (u32 c = 0; c < kCharacterCount; ++c)
+	{
+		u32 root = NewTransform(TransformHierarchy::kInvalidNode);
+		roots.push_back(root);
+		for (u32 l = 0; l < kLimbCount; ++l)
+		{
+			u32 limb = NewTransform(root);
+			for (u32 a = 0; a < kAttachmentCount; ++a)
+				NewTransform(limb);
+		}
+	}
+	u32 count = transforms.size();
+	hierarchy->Update();
+
+	cout << "\n-------------- Transform hierarchy: " << count << " transforms, " << hierarchy->GetLevelCount() << " levels --------------\n";
+
+	const u32 frames = 20;
+	f64 start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+	{
+		for (u32 i = 0; i < count; ++i)
+			gBenchSink += (u32)WalkUpWorld(transforms, parents, i).m[0][3];
+	}
+	PrintResult("walk up the parents, every object (per transform)", FRC::GetCPUTime() - start, frames * count);
+
+	// every character moves
+	for (u32 parallel = 0; parallel < 2; ++parallel)
+	{
+		hierarchy->SetParallel(parallel != 0);
+		start = FRC::GetCPUTime();
+		for (u32 f = 0; f < frames; ++f)
+		{
+			FOR_EACH(it, roots)
+				transforms[*it]->SetPosition(AEVec2((f32)f, 0.0f));
+			hierarchy->Update();
+		}
+		PrintResult(parallel ? "Update, all moved, parallel (per transform)" : "Update, all moved, serial (per transform)", FRC::GetCPUTime() - start, frames * count);
+	}
+
+	// 1% of the characters move: only their subtrees
+	start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+	{
+		for (u32 r = f % 100; r < roots.size(); r += 100)
+			transforms[roots[r]]->SetPosition(AEVec2((f32)f, 1.0f));
+		hierarchy->Update();
+	}
+	PrintResult("Update, 1% moved (per transform)", FRC::GetCPUTime() - start, frames * count);
+	cout << "  recomputed " << hierarchy->GetUpdatedCount() << " of " << count << " per frame\n";
+
+	start = FRC::GetCPUTime();
+	for (u32 f = 0; f < frames; ++f)
+		hierarchy->Update();
+	PrintResult("Update, nothing moved (per transform)", FRC::GetCPUTime() - start, frames * count);
+
+	gBenchSink += (u32)transforms.back()->GetModelToWorld4x4().m[0][3];
+	FOR_EACH(it, transforms)
+		scene->DestroyObject((*it)->GetOwner());
+	hierarchy->SetParallel(true);
+	hierarchy->Update();
+}
+#pragma endregion
+
+#pragma region Benchmark: Transform storage
+const u32 kSpriteCount = 50000;
+
+// the instance data of a sprite batch, built three ways: one transform at a
+// time (cached AoS matrices), walking the archetype chunks the transforms
+// live in, or by the SoA storage in one pass
+void Bench_TransformStorage()
+{
+	Scene * scene = aexScene;
+	TransformStorage * storage = aexTransformStorage;
+	ArchetypeStorage & archetypes = scene->GetArchetypes();
+	std::vector<TransformComp*> transforms;	// stable: no structural change until the end
+
+	storage->SetAutoAdd(true);
+	for (u32 i = 0; i < kSpriteCount; ++i)
+	{
+		TransformComp * tr = archetypes.NewComp<TransformComp>(scene->NewObject("Sprite"));
+		tr->GetOwner()->Initialize();
+		tr->SetPosition3D(AEVec3((f32)i, 0.5f, 0.0f));
+		tr->SetScale(AEVec2(2.0f, 3.0f));
+		tr->SetRotationAngle(0.001f * i);
+		transforms.push_back(tr);
+	}
+	storage->SetAutoAdd(false);
+	storage->Update();
+
+	// a game that spawned and destroyed for a while doesn't visit its
+	// components in memory order
+	std::shuffle(transforms.begin(), transforms.end(), std::mt19937(42));
+
+	cout << "\n-------------- Transform storage: " << kSpriteCount << " sprites --------------\n";
+
+	std::vector<AEMtx44> instances(kSpriteCount);
+	const u32 frames = 20;
+	for (u32 moved = 0; moved < 2; ++moved)
+	{
+		f64 perComp = 0.0, chunks = 0.0, pass = 0.0;
+		for (u32 f = 0; f < frames; ++f)
+		{
+			if (moved)
+			{
+				for (u32 i = 0; i < kSpriteCount; ++i)
+				{
+					transforms[i]->SetPosition(AEVec2((f32)f, (f32)i));
+					transforms[i]->SetRotationAngle(0.01f * f);
+				}
+			}
+
+			f64 start = FRC::GetCPUTime();
+			for (u32 i = 0; i < kSpriteCount; ++i)
+				instances[i] = transforms[i]->GetModelToWorld4x4();
+			perComp += FRC::GetCPUTime() - start;
+
+			start = FRC::GetCPUTime();
+			u32 instance = 0;
+			archetypes.ForEach<TransformComp>([&](u32 count, EntityId *, TransformComp * tr)
+			{
+				for (u32 i = 0; i < count; ++i)
+					instances[instance++] = tr[i].GetModelToWorld4x4();
+			});
+			chunks += FRC::GetCPUTime() - start;
+
+			start = FRC::GetCPUTime();
+			storage->Update();
+			pass += FRC::GetCPUTime() - start;
+		}
+		PrintResult(moved ? "per transform, all moved (per sprite)" : "per transform, nothing moved (per sprite)", perComp, frames * kSpriteCount);
+		PrintResult(moved ? "chunk ForEach, all moved (per sprite)" : "chunk ForEach, nothing moved (per sprite)", chunks, frames * kSpriteCount);
+		PrintResult(moved ? "storage Update, all moved (per sprite)" : "storage Update, nothing moved (per sprite)", pass, frames * kSpriteCount);
+	}
+
+	// same matrices
+	u32 mismatches = 0;
+	for (u32 i = 0; i < kSpriteCount; ++i)
+	{
+		const AEMtx44 & a = transforms[i]->GetModelToWorld4x4(), & b = storage->GetModelMatrix(transforms[i]->GetStorageSlot());
+		for (u32 k = 0; k < 16; ++k)
+			mismatches += fabsf(a.v[k] - b.v[k]) > 1e-4f * (1.0f + fabsf(a.v[k]));
+	}
+	cout << "  " << mismatches << " mismatched elements\n";
+
+	gBenchSink += (u32)instances.back().m[0][3] + (u32)storage->GetModelMatrices()[0].m[0][3];
+	// destroying moves the chunk transforms: owners first
+	std::vector<GameObject*> sprites;
+	FOR_EACH(it, transforms)
+		sprites.push_back((*it)->GetOwner());
+	FOR_EACH(it, sprites)
+		scene->DestroyObject(*it);
+}
+#pragma endregion
+
+#pragma region Gamestate functions - they just call the benchmark functions
+void BenchmarkDemo::Initialize()
+{
+	Bench_RttiIsDerived();
+	Bench_LogicRegistry();
+	Bench_JobSystem();
+	Bench_HashMap();
+	Bench_ObjectPool();
+	Bench_Prefab();
+	Bench_Math();
+	Bench_PointTransforms();
+	Bench_TransformHierarchy();
+	Bench_TransformStorage();
+	cout << "\n\n\n\n";
+	aexEngine->Quit();
+}
+void BenchmarkDemo::LoadResources()
+{
+	// pools are warmed up with the resources: no building during the game
+	aexObjectPool->Register("Bullet", &BuildBullet);
+	aexObjectPool->Prewarm(AEX_SID("Bullet"), kBulletCount);
+}
+void BenchmarkDemo::Update()
+{
+}
+void BenchmarkDemo::Render()
+{
+}
+#pragma endregion
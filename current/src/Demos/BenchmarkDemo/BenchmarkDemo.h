@@ -0,0 +1,10 @@
+#pragma once
+#include "src\Engine\Logic\AEXGameState.h"
+// benchmark game state: runs the engine micro-benchmarks and prints the results.
+class BenchmarkDemo : public AEX::IGameState
+{
+	virtual void Initialize();
+	virtual void LoadResources();
+	virtual void Update();
+	virtual void Render();
+};
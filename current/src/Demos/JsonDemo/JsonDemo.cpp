@@ -3,6 +3,7 @@
 #include "JsonDemo.h"
 #include <iostream>
 #include <fstream>
+#include <type_traits>
 using namespace AEX;
 using std::cout;
 using std::endl;
@@ -136,15 +137,18 @@ template<typename T>
 struct TCreator : public ICreator {
 	virtual IBase * Create()
 	{
-		return new T();
+		// components come from their type's pool, GameObject::RemoveComp frees them
+		return Create(std::is_base_of<IComp, T>());
 	}
+	IBase * Create(std::true_type)	{ return IComp::Create<T>(); }
+	IBase * Create(std::false_type)	{ return new T(); }
 };
 class Factory : public ISystem
 {
 	AEX_RTTI_DECL(Factory, ISystem);
 	AEX_SINGLETON(Factory);
 private: 
-	std::map<std::string, ICreator*> mCreators;
+	AEX_PTR_DICTIONARY(ICreator) mCreators;
 public:
 	void Register(const char * typeName, ICreator * creator)
 	{
@@ -154,8 +158,10 @@ public:
 	IBase * Create(const char * typeName)
 	{
 		// IMPORTANT: FIND THE CREATOR HERE
-		if (mCreators.find(typeName) != mCreators.end())
-			return mCreators[typeName]->Create();
+		// (looked up by const char *, no std::string is built)
+		AEX_PTR_DICTIONARY(ICreator)::iterator it = mCreators.find(typeName);
+		if (it != mCreators.end())
+			return it->second->Create();
 		// NO CREATOR REGISTERED
 		return NULL;
 	}
@@ -287,7 +293,7 @@ nlohmann::json& operator<<(nlohmann::json& j, const AEX::Transform & tr)
 }
 nlohmann::json& operator<<(nlohmann::json& j, const AEX::TransformComp& mtr)
 {
-	j["local"] << mtr.mLocal;
+	j["local"] << mtr.GetLocal();
 	return j;
 }
 
@@ -325,7 +331,7 @@ AEX::Transform& operator>>(const nlohmann::json& j, AEX::Transform& mtr)
 AEX::TransformComp& operator>>(const nlohmann::json& j, AEX::TransformComp& mtr)
 {
 	if(j.find("local") != j.end())
-		j["local"] >> mtr.mLocal;
+		j["local"] >> mtr.EditLocal();
 	return mtr;
 }
 
@@ -410,7 +416,7 @@ public:
 	virtual json& operator<< (json&j)  const
 	{
 		// serialize name (todo: implement this as a Property). 
-		j["name"] = mName;
+		j["name"] = GetName();
 
 		// serialize components
 		json & comps = j["comps"];
@@ -1,11 +1,20 @@
 #include "src\Engine\AEX.h"
 #include <iostream>
+#include <cstring>
 #include "Simple Demo\SimpleDemo.h"
 #include "JsonDemo\JsonDemo.h"
+#include "BenchmarkDemo\BenchmarkDemo.h"
 
-void main(void)
+// -benchmark runs the engine benchmarks (BenchmarkDemo) then quits
+int main(int argc, char * argv[])
 {
+	bool benchmark = argc > 1 && strcmp(argv[1], "-benchmark") == 0;
+
 	aexEngine->Initialize();
-	aexEngine->Run(new JsonDemo);
+	if (benchmark)
+		aexEngine->Run(new BenchmarkDemo);
+	else
+		aexEngine->Run(new JsonDemo);
 	AEX::AEXEngine::ReleaseInstance();
+	return 0;
 }
@@ -105,11 +105,20 @@ void DemoGameState::Update()
 	if (aexInput->KeyTriggered('F'))
 		mainWin->SetFullScreen(!mainWin->GetFullScreen());
 
+	// allocation tracking: on, then off with a report of what is live
+	if (aexInput->KeyTriggered('M'))
+	{
+		AllocTracker::SetEnabled(!AllocTracker::IsEnabled());
+		if (!AllocTracker::IsEnabled())
+			AllocTracker::Report();
+	}
+
 	f32 fps = (f32)aexTime->GetFrameRate();
-	std::string wintitle = "Simple Demo - FPS: "; wintitle += std::to_string(fps);
+	FrameString wintitle = "Simple Demo - FPS: "; wintitle += std::to_string(fps).c_str();	// frame temporary, no heap
 	if (aexTime->FrameRateLocked())	wintitle += "(LOCKED)";
 	wintitle += " - VSYNC: ";	wintitle +=	aexGraphics->GetVSyncEnabled() ? "ON" : "OFF";
-	wintitle += " - Controls: FPS: 'B', '+/-'. VSYNC: 'V'";
+	if (AllocTracker::IsEnabled()) { wintitle += " - ALLOCS: "; wintitle += std::to_string(AllocTracker::GetLastFrame().mAllocCount).c_str(); }
+	wintitle += " - Controls: FPS: 'B', '+/-'. VSYNC: 'V'. ALLOC TRACKING: 'M'";
 	aexWindowMgr->GetMainWindow()->SetTitle(wintitle.c_str());
 
 
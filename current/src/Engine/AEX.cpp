@@ -1,18 +1,30 @@
 #include "AEX.h"
 namespace AEX{
-	AEXEngine::AEXEngine(){}
+	AEXEngine::AEXEngine() : mpGameState(nullptr), mbQuit(false){}
 	AEXEngine::~AEXEngine()
 	{
+		Scene::ReleaseInstance();
+		ObjectPool::ReleaseInstance();	// after the scene: gets the live objects back
+		TransformHierarchy::ReleaseInstance();	// after the objects: their transforms leave it
+		TransformStorage::ReleaseInstance();	// same
 		Graphics::ReleaseInstance();
 		FRC::ReleaseInstance();
 		Input::ReleaseInstance();
 		WindowManager::ReleaseInstance();
+		DeferredCommands::ReleaseInstance();
+		JobSystem::ReleaseInstance();
+
+		// what is still live now is leaked, or owned by statics
+		if (AllocTracker::IsEnabled())
+			AllocTracker::Report();
 	}
 	bool AEXEngine::Initialize()
 	{
 		// note, here'were creating and initializing at the same
 		// time. by typing the maccro, we're creating the singleton
 		// pointer which is returned, we then call initialize on it.
+		if (!aexJobSystem->Initialize())return false; // this thread becomes worker 0
+		if (!aexCommands->Initialize())return false;
 		if (!aexWindowMgr->Initialize())return false;
 		if (!aexInput->Initialize())return false;
 		if (!aexTime->Initialize())return false;
@@ -23,6 +35,31 @@ namespace AEX{
 		aexTime->SetMaxFrameRate(60.0);
 		aexGraphics->SetVSyncEnabled(true);
 
+		// frame graph, same order as before: window, input, game state update
+		// and render, all on the main thread (OS messages and GL context).
+		// The deferred structural changes are applied between update and render,
+		// then the parented transforms get their world matrices and the stored
+		// ones their model matrices (independent, they can run side by side).
+		u32 window = mScheduler.AddSystem(aexWindowMgr);	// Process OS messages and respond to window events.
+		u32 input = mScheduler.AddSystem(aexInput);			// Process Input specific messages.
+		u32 update = mScheduler.AddTask("GameState::Update", [this]() { mpGameState->Update(); });
+		u32 commands = mScheduler.AddSystem(aexCommands);
+		u32 transforms = mScheduler.AddSystem(aexTransformHierarchy);
+		u32 storage = mScheduler.AddSystem(aexTransformStorage);
+		u32 render = mScheduler.AddTask("GameState::Render", [this]() { mpGameState->Render(); });
+		mScheduler.AddDependency(input, window);
+		mScheduler.AddDependency(update, input);
+		mScheduler.AddDependency(commands, update);
+		mScheduler.AddDependency(transforms, commands);
+		mScheduler.AddDependency(storage, commands);
+		mScheduler.AddDependency(render, transforms);
+		mScheduler.AddDependency(render, storage);
+		mScheduler.SetMainThread(window);
+		mScheduler.SetMainThread(input);
+		mScheduler.SetMainThread(update);
+		mScheduler.SetMainThread(commands);
+		mScheduler.SetMainThread(render);
+
 		// all good -> return true
 		return true;
 	}
@@ -32,6 +69,9 @@ namespace AEX{
 		if (!gameState)
 			return;
 
+		mpGameState = gameState;
+		mbQuit = false;
+
 		// load game state resources
 		gameState->LoadResources();
 
@@ -42,33 +82,33 @@ namespace AEX{
 		aexTime->Reset();
 
 		// run the game loop
-		while (aexInput->KeyTriggered(VK_ESCAPE) == false &&
+		while (!mbQuit && aexInput->KeyTriggered(VK_ESCAPE) == false &&
 			aexWindowMgr->GetMainWindow()->Exists())
 		{
 			aexTime->StartFrame();
-			aexWindowMgr->Update();		// Process OS messages and respond to window events.
-			aexInput->Update();			// Process Input specific messages. 
 			// 
-			// TODO: add physics, collisions, interpolations, etc...
+			// TODO: add physics, collisions, interpolations, etc... to the scheduler
 			// 
-			gameState->Update();
-			gameState->Render(); 
+			mScheduler.Run();
 			aexTime->EndFrame();
 
 			// poor man's reset
 			if (Input::Instance()->KeyPressed('R'))
 			{
 				gameState->Shutdown();
+				aexScene->Clear();
 				gameState->Initialize();
 			}
 		}
 
 		gameState->Shutdown();
+		aexScene->Clear();	// whatever the game state left
 
 		// unload resources
 		gameState->FreeResources();
 
 		// delete gameState
 		delete gameState;
+		mpGameState = nullptr;
 	}
 }
\ No newline at end of file
@@ -2,10 +2,14 @@
 #define AEX_H_
 
 #include "Debug\MyDebug.h"
+#include "Debug\AEXAllocTracker.h"
 #include "Core\AEXCore.h"
 #include "Platform\AEXPlatform.h"
 #include "Composition\AEXComposition.h"
 #include "Scene\AEXTransformComp.h"
+#include "Scene\AEXTransformHierarchy.h"
+#include "Scene\AEXTransformStorage.h"
+#include "Scene\AEXScene.h"
 #include "Logic\AEXGameState.h"
 #include "Logic\AEXLogic.h"
 #include "Graphics\AEXGraphics.h"
@@ -24,6 +28,16 @@ namespace AEX{
 		virtual ~AEXEngine();
 		virtual bool Initialize();
 		void Run(IGameState*gameState = nullptr);
+		void Quit() { mbQuit = true; }		// Run returns after the current frame (before the first one if called from Initialize)
+
+		// per-frame work. Register new systems here, with their dependencies
+		// or the component types they read and write.
+		SystemScheduler & GetScheduler() { return mScheduler; }
+
+	private:
+		SystemScheduler mScheduler;
+		IGameState *	mpGameState;	// of the current Run
+		bool			mbQuit;
 	};
 }
 #pragma warning (default:4251) // dll and STL
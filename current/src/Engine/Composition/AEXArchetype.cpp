@@ -0,0 +1,455 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXArchetype.cpp
+// Purpose:	Archetype (chunk based) component storage
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include "AEXArchetype.h"
+#include "AEXGameObject.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// ----------------------------------------------------------------------------
+	// COMPONENT TYPE
+
+	u32 ComponentType::sTypeCount = 0;
+
+	u32 ComponentType::GetTypeCount()
+	{
+		return sTypeCount;
+	}
+
+	// sorts the component types of an archetype
+	static bool CompareComponentTypes(const ComponentType * lhs, const ComponentType * rhs)
+	{
+		return lhs->mId < rhs->mId;
+	}
+
+	// ----------------------------------------------------------------------------
+	// ----------------------------------------------------------------------------
+	// ARCHETYPE
+
+	Archetype::Archetype(const std::vector<const ComponentType*> & types)
+		: mTypes(types)
+		, mCapacity(0)
+	{
+		// bytes per entity, and worst case alignment padding between the arrays
+		u32 rowSize = sizeof(EntityId);
+		u32 padding = 0;
+		FOR_EACH(it, mTypes)
+		{
+			rowSize += (*it)->mSize;
+			padding += (*it)->mAlign;
+		}
+		mCapacity = (kChunkSize - padding) / rowSize;
+		DebugAssert(mCapacity > 0, "Archetype: components don't fit in a %u bytes chunk", kChunkSize);
+
+		// one packed array per type after the entity ids
+		u32 offset = sizeof(EntityId) * mCapacity;
+		FOR_EACH(it, mTypes)
+		{
+			u32 align = (*it)->mAlign;
+			offset = (offset + align - 1) / align * align;
+			mOffsets.push_back(offset);
+			offset += (*it)->mSize * mCapacity;
+		}
+	}
+	Archetype::~Archetype()
+	{
+		FOR_EACH(it, mChunks)
+		{
+			delete[] (*it)->mAllocation;
+			delete (*it);
+		}
+	}
+
+	u32 Archetype::FindColumn(u32 typeId) const
+	{
+		// archetypes have few types, linear is fine
+		for (u32 i = 0; i < mTypes.size(); ++i)
+			if (mTypes[i]->mId == typeId)
+				return i;
+		return mTypes.size();
+	}
+	u32 Archetype::GetEntityCount() const
+	{
+		if (mChunks.empty())
+			return 0;
+		return (mChunks.size() - 1) * mCapacity + mChunks.back()->mCount;
+	}
+
+	void Archetype::AllocateRow(u32 & chunk, u32 & row)
+	{
+		// last chunk is full -> new chunk
+		if (mChunks.empty() || mChunks.back()->mCount == mCapacity)
+		{
+			Chunk * newChunk = new Chunk;
+			newChunk->mAllocation = new u8[kChunkSize + kCacheLine];
+			newChunk->mData = newChunk->mAllocation + (kCacheLine - (size_t)newChunk->mAllocation % kCacheLine) % kCacheLine;
+			newChunk->mCount = 0;
+			mChunks.push_back(newChunk);
+		}
+		chunk = mChunks.size() - 1;
+		row = mChunks.back()->mCount++;
+	}
+	void Archetype::FreeLastChunkIfEmpty()
+	{
+		if (!mChunks.empty() && mChunks.back()->mCount == 0)
+		{
+			delete[] mChunks.back()->mAllocation;
+			delete mChunks.back();
+			mChunks.pop_back();
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	// ----------------------------------------------------------------------------
+	// ARCHETYPE STORAGE
+
+	ArchetypeStorage::ArchetypeStorage()
+		: mEntityCount(0)
+	{
+		mEmpty = FindOrCreateArchetype(std::vector<const ComponentType*>());
+	}
+	ArchetypeStorage::~ArchetypeStorage()
+	{
+		// destroy the live entities (their IComps leave their game objects)
+		for (u32 i = 0; i < mEntities.size(); ++i)
+		{
+			if (mEntities[i].mArchetype)
+			{
+				EntityId entity = { i, mEntities[i].mGeneration };
+				DestroyEntity(entity);
+			}
+		}
+		FOR_EACH(it, mArchetypes)
+			delete (*it);
+	}
+
+	#pragma region// ENTITIES
+
+	EntityId ArchetypeStorage::CreateEntity(GameObject * owner)
+	{
+		// reuse a free slot if possible
+		u32 index;
+		if (!mFreeEntities.empty())
+		{
+			index = mFreeEntities.back();
+			mFreeEntities.pop_back();
+		}
+		else
+		{
+			index = mEntities.size();
+			EntityRecord newRecord = { NULL, 0, 0, 0, NULL };
+			mEntities.push_back(newRecord);
+		}
+
+		EntityRecord & record = mEntities[index];
+		record.mArchetype = mEmpty;
+		record.mOwner = NULL;
+		mEmpty->AllocateRow(record.mChunk, record.mRow);
+
+		EntityId entity = { index, record.mGeneration };
+		mEmpty->GetEntities(mEmpty->GetChunk(record.mChunk))[record.mRow] = entity;
+		++mEntityCount;
+		if (owner)
+			BindObject(entity, owner);
+		return entity;
+	}
+	void ArchetypeStorage::DestroyEntity(EntityId entity)
+	{
+		EntityRecord * record = GetRecord(entity);
+		if (!record)
+			return;
+
+		// the IComps leave their owner first: shut down, then released one at
+		// a time (each removal moves the entity, the next type takes the column)
+		for (u32 column = 0; column < record->mArchetype->GetTypeCount();)
+		{
+			const ComponentType & type = record->mArchetype->GetType(column);
+			IComp * comp = type.mAsComp ? type.mAsComp(GetComponent(entity, type)) : NULL;
+			if (comp && comp->mOwner)
+				comp->mOwner->RemoveComp(comp);
+			else
+				++column;
+		}
+
+		// destroy the other components
+		Archetype * archetype = record->mArchetype;
+		Chunk & chunk = archetype->GetChunk(record->mChunk);
+		for (u32 column = 0; column < archetype->GetTypeCount(); ++column)
+			archetype->GetType(column).mDestruct(archetype->GetComponent(chunk, column, record->mRow));
+		RemoveRow(archetype, record->mChunk, record->mRow);
+
+		// free the slot. new generation invalidates existing handles
+		if (record->mOwner)
+			record->mOwner->mpArchetypes = NULL;
+		record->mArchetype = NULL;
+		record->mOwner = NULL;
+		++record->mGeneration;
+		mFreeEntities.push_back(entity.mIndex);
+		--mEntityCount;
+	}
+	bool ArchetypeStorage::IsAlive(EntityId entity) const
+	{
+		return GetRecord(entity) != NULL;
+	}
+
+	void ArchetypeStorage::BindObject(EntityId entity, GameObject * owner)
+	{
+		EntityRecord * record = GetRecord(entity);
+		if (!record || !owner || record->mOwner == owner)
+			return;
+		if (DebugErrorIf(record->mOwner || owner->mpArchetypes, "ArchetypeStorage::BindObject: \"%s\" or the entity is already bound", owner->GetName()))
+			return;
+
+		record->mOwner = owner;
+		owner->mpArchetypes = this;
+		owner->mEntity = entity;
+
+		Archetype * archetype = record->mArchetype;
+		Chunk & chunk = archetype->GetChunk(record->mChunk);
+		for (u32 column = 0; column < archetype->GetTypeCount(); ++column)
+			AttachComp(*record, archetype->GetType(column), archetype->GetComponent(chunk, column, record->mRow));
+	}
+	GameObject * ArchetypeStorage::GetObject(EntityId entity) const
+	{
+		const EntityRecord * record = GetRecord(entity);
+		return record ? record->mOwner : NULL;
+	}
+	EntityId ArchetypeStorage::GetEntity(GameObject * owner)
+	{
+		if (!owner->mpArchetypes)
+			return CreateEntity(owner);
+		DebugAssert(owner->mpArchetypes == this, "ArchetypeStorage::GetEntity: \"%s\" is bound to another storage", owner->GetName());
+		return owner->mEntity;
+	}
+
+	#pragma endregion
+
+	#pragma region// COMPONENTS
+
+	void * ArchetypeStorage::AddComponent(EntityId entity, const ComponentType & type)
+	{
+		EntityRecord * record = GetRecord(entity);
+		if (!record)
+			return NULL;
+
+		// no duplicates
+		if (void * existing = GetComponent(entity, type))
+			return existing;
+
+		// move to the archetype with the new type (default constructs it)
+		MoveEntity(entity.mIndex, GetArchetypeWith(record->mArchetype, type));
+
+		void * obj = GetComponent(entity, type);
+		AttachComp(*record, type, obj);
+		return obj;
+	}
+	void ArchetypeStorage::RemoveComponent(EntityId entity, const ComponentType & type)
+	{
+		void * obj = GetComponent(entity, type);
+		if (!obj)
+			return;
+
+		// an IComp in a game object is removed from it (shut down), which
+		// releases it back here. Otherwise move to the archetype without the type.
+		IComp * comp = type.mAsComp ? type.mAsComp(obj) : NULL;
+		if (comp && comp->mOwner)
+			comp->mOwner->RemoveComp(comp);
+		else
+			MoveEntity(entity.mIndex, GetArchetypeWithout(GetRecord(entity)->mArchetype, type));
+	}
+	void * ArchetypeStorage::GetComponent(EntityId entity, const ComponentType & type)
+	{
+		EntityRecord * record = GetRecord(entity);
+		if (!record)
+			return NULL;
+
+		Archetype * archetype = record->mArchetype;
+		u32 column = archetype->FindColumn(type.mId);
+		if (column == archetype->GetTypeCount())
+			return NULL;
+		return archetype->GetComponent(archetype->GetChunk(record->mChunk), column, record->mRow);
+	}
+	void ArchetypeStorage::ReleaseComp(EntityId entity, IComp * comp)
+	{
+		EntityRecord * record = GetRecord(entity);
+		if (!record)
+			return;
+
+		Archetype * archetype = record->mArchetype;
+		Chunk & chunk = archetype->GetChunk(record->mChunk);
+		for (u32 column = 0; column < archetype->GetTypeCount(); ++column)
+		{
+			const ComponentType & type = archetype->GetType(column);
+			if (type.mAsComp && type.mAsComp(archetype->GetComponent(chunk, column, record->mRow)) == comp)
+			{
+				MoveEntity(entity.mIndex, GetArchetypeWithout(archetype, type));
+				return;
+			}
+		}
+	}
+
+	#pragma endregion
+
+	#pragma region// INTERNALS
+
+	ArchetypeStorage::EntityRecord * ArchetypeStorage::GetRecord(EntityId entity)
+	{
+		if (entity.mIndex < mEntities.size())
+		{
+			EntityRecord & record = mEntities[entity.mIndex];
+			if (record.mArchetype && record.mGeneration == entity.mGeneration)
+				return &record;
+		}
+		return NULL;
+	}
+	const ArchetypeStorage::EntityRecord * ArchetypeStorage::GetRecord(EntityId entity) const
+	{
+		return const_cast<ArchetypeStorage*>(this)->GetRecord(entity);
+	}
+
+	Archetype * ArchetypeStorage::FindOrCreateArchetype(const std::vector<const ComponentType*> & types)
+	{
+		// few archetypes and the edges cache the common transitions
+		FOR_EACH(it, mArchetypes)
+			if ((*it)->mTypes == types)
+				return (*it);
+
+		Archetype * archetype = new Archetype(types);
+		mArchetypes.push_back(archetype);
+		return archetype;
+	}
+	Archetype * ArchetypeStorage::GetArchetypeWith(Archetype * src, const ComponentType & type)
+	{
+		AEX_HASH_MAP(u32, Archetype*)::iterator it = src->mAddEdges.find(type.mId);
+		if (it != src->mAddEdges.end())
+			return it->second;
+
+		std::vector<const ComponentType*> types = src->mTypes;
+		types.push_back(&type);
+		std::sort(types.begin(), types.end(), CompareComponentTypes);
+
+		Archetype * dst = FindOrCreateArchetype(types);
+		src->mAddEdges[type.mId] = dst;
+		dst->mRemoveEdges[type.mId] = src;
+		return dst;
+	}
+	Archetype * ArchetypeStorage::GetArchetypeWithout(Archetype * src, const ComponentType & type)
+	{
+		AEX_HASH_MAP(u32, Archetype*)::iterator it = src->mRemoveEdges.find(type.mId);
+		if (it != src->mRemoveEdges.end())
+			return it->second;
+
+		std::vector<const ComponentType*> types = src->mTypes;
+		types.erase(types.begin() + src->FindColumn(type.mId));
+
+		Archetype * dst = FindOrCreateArchetype(types);
+		src->mRemoveEdges[type.mId] = dst;
+		dst->mAddEdges[type.mId] = src;
+		return dst;
+	}
+
+	void ArchetypeStorage::MoveEntity(u32 entityIndex, Archetype * dst)
+	{
+		EntityRecord & record = mEntities[entityIndex];
+		Archetype * src = record.mArchetype;
+		Chunk & srcChunk = src->GetChunk(record.mChunk);
+
+		// new row in the destination
+		u32 dstChunkIndex, dstRow;
+		dst->AllocateRow(dstChunkIndex, dstRow);
+		Chunk & dstChunk = dst->GetChunk(dstChunkIndex);
+		dst->GetEntities(dstChunk)[dstRow] = src->GetEntities(srcChunk)[record.mRow];
+
+		// move the components both archetypes have, destroy the others
+		for (u32 column = 0; column < src->GetTypeCount(); ++column)
+		{
+			const ComponentType & type = src->GetType(column);
+			void * srcObj = src->GetComponent(srcChunk, column, record.mRow);
+			u32 dstColumn = dst->FindColumn(type.mId);
+			if (dstColumn < dst->GetTypeCount())
+				MoveComp(type, dst->GetComponent(dstChunk, dstColumn, dstRow), srcObj);
+			else
+				type.mDestruct(srcObj);	// IComps were removed from their owner already
+		}
+
+		// default construct the new ones
+		for (u32 column = 0; column < dst->GetTypeCount(); ++column)
+		{
+			const ComponentType & type = dst->GetType(column);
+			if (!src->HasType(type.mId))
+			{
+				void * obj = dst->GetComponent(dstChunk, column, dstRow);
+				type.mConstruct(obj);
+				if (type.mAsComp)
+					type.mAsComp(obj)->mbOwnedByStorage = true;
+			}
+		}
+
+		// fill the hole in the source
+		RemoveRow(src, record.mChunk, record.mRow);
+		record.mArchetype = dst;
+		record.mChunk = dstChunkIndex;
+		record.mRow = dstRow;
+	}
+	void ArchetypeStorage::RemoveRow(Archetype * archetype, u32 chunkIndex, u32 row)
+	{
+		// the components of the row are already destroyed or moved. move the
+		// last entity of the archetype in the hole so that the arrays stay packed.
+		Chunk & chunk = archetype->GetChunk(chunkIndex);
+		Chunk & last = *archetype->mChunks.back();
+		u32 lastRow = last.mCount - 1;
+		if (&chunk != &last || row != lastRow)
+		{
+			for (u32 column = 0; column < archetype->GetTypeCount(); ++column)
+			{
+				MoveComp(archetype->GetType(column),
+					archetype->GetComponent(chunk, column, row),
+					archetype->GetComponent(last, column, lastRow));
+			}
+			EntityId moved = archetype->GetEntities(last)[lastRow];
+			archetype->GetEntities(chunk)[row] = moved;
+			mEntities[moved.mIndex].mChunk = chunkIndex;
+			mEntities[moved.mIndex].mRow = row;
+		}
+		--last.mCount;
+		archetype->FreeLastChunkIfEmpty();
+	}
+
+	// ----------------------------------------------------------------------------
+	// IComp adapter: keeps the owner game object in sync with the chunks
+	void ArchetypeStorage::AttachComp(EntityRecord & record, const ComponentType & type, void * obj)
+	{
+		if (type.mAsComp && record.mOwner)
+			record.mOwner->AddComp(type.mAsComp(obj));
+	}
+	void ArchetypeStorage::MoveComp(const ComponentType & type, void * dst, void * src)
+	{
+		IComp * oldComp = type.mAsComp ? type.mAsComp(src) : NULL;
+		type.mMove(dst, src);
+
+		// the owner still points to the old address
+		if (oldComp)
+		{
+			IComp * newComp = type.mAsComp(dst);
+			if (newComp->mOwner)
+				newComp->mOwner->ReplaceComp(oldComp, newComp);
+		}
+	}
+
+	bool ArchetypeStorage::HasAllTypes(const Archetype & archetype, const u32 * typeIds, u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+			if (!archetype.HasType(typeIds[i]))
+				return false;
+		return true;
+	}
+
+	#pragma endregion
+}
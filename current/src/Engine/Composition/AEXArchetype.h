@@ -0,0 +1,281 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXArchetype.h
+// Purpose:	Archetype (chunk based) component storage
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_ARCHETYPE_H_
+#define AEX_ARCHETYPE_H_
+// ----------------------------------------------------------------------------
+#include <new>				// placement new
+#include <utility>			// std::move
+#include <type_traits>		// std::is_base_of
+#include "AEXComponent.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	class GameObject;
+	class Archetype;
+	class ArchetypeStorage;
+
+	// ----------------------------------------------------------------------------
+	// \struct	EntityId
+	// \brief	Handle to an entity in an ArchetypeStorage. The generation detects
+	//			handles to destroyed entities whose slot was reused.
+	struct EntityId
+	{
+		u32 mIndex;
+		u32 mGeneration;
+
+		bool operator==(const EntityId & rhs) const { return mIndex == rhs.mIndex && mGeneration == rhs.mGeneration; }
+		bool operator!=(const EntityId & rhs) const { return !(*this == rhs); }
+	};
+
+	// ----------------------------------------------------------------------------
+	// \struct	ComponentType
+	// \brief	Type erased description of a type that can be stored in a chunk.
+	//			Any default constructible, copy or move constructible type works.
+	//			IComp derived types are additionally exposed to their owner
+	//			GameObject (see ArchetypeStorage::BindObject).
+	struct ComponentType
+	{
+		u32				mId;		// dense id, registration order
+		u32				mSize;
+		u32				mAlign;
+		std::string		mName;
+
+		void	(*mConstruct)(void * dst);
+		void	(*mDestruct)(void * obj);
+		void	(*mMove)(void * dst, void * src);	// move constructs dst, destroys src
+		IComp*	(*mAsComp)(void * obj);				// NULL if not an IComp
+
+		template <typename T> static const ComponentType & Get();
+		static u32 GetTypeCount();
+
+	private:
+		static u32 sTypeCount;
+	};
+
+	namespace internal
+	{
+		template <typename T> void ConstructComponent(void * dst)	{ new (dst) T(); }
+		template <typename T> void DestructComponent(void * obj)	{ static_cast<T*>(obj)->~T(); }
+		template <typename T> void MoveComponent(void * dst, void * src)
+		{
+			new (dst) T(std::move(*static_cast<T*>(src)));
+			static_cast<T*>(src)->~T();
+		}
+		template <typename T> IComp * CompFromComponent(void * obj) { return static_cast<T*>(obj); }
+
+		template <typename T, bool isComp = std::is_base_of<IComp, T>::value> struct CompCast
+		{
+			static IComp* (*Get())(void*) { return &CompFromComponent<T>; }
+		};
+		template <typename T> struct CompCast<T, false>
+		{
+			static IComp* (*Get())(void*) { return NULL; }
+		};
+	}
+
+	template <typename T>
+	const ComponentType & ComponentType::Get()
+	{
+		static const ComponentType sType = {
+			sTypeCount++, sizeof(T), alignof(T), Rtti::GetTypeName<T>(),
+			&internal::ConstructComponent<T>, &internal::DestructComponent<T>,
+			&internal::MoveComponent<T>, internal::CompCast<T>::Get() };
+		return sType;
+	}
+
+	// ----------------------------------------------------------------------------
+	// \struct	Chunk
+	// \brief	16 KB block holding up to Archetype::GetChunkCapacity() entities.
+	//			Layout: [EntityId x capacity][Comp0 x capacity][Comp1 x capacity]...
+	struct Chunk
+	{
+		u8 *	mData;			// kChunkSize bytes, cache line aligned
+		u32		mCount;			// live entities in this chunk
+		u8 *	mAllocation;	// unaligned allocation (freed)
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	Archetype
+	// \brief	All the entities that have exactly the same set of component types.
+	//			Every chunk but the last one is full.
+	class Archetype
+	{
+		friend class ArchetypeStorage;
+	public:
+		static const u32 kChunkSize = 16 * 1024;
+		static const u32 kCacheLine = 64;
+
+		Archetype(const std::vector<const ComponentType*> & types);
+		~Archetype();
+
+		// types (sorted by ComponentType::mId)
+		u32 GetTypeCount() const { return mTypes.size(); }
+		const ComponentType & GetType(u32 column) const { return *mTypes[column]; }
+		u32 FindColumn(u32 typeId) const; // returns GetTypeCount() if not found
+		bool HasType(u32 typeId) const { return FindColumn(typeId) != GetTypeCount(); }
+
+		// chunks
+		u32 GetChunkCapacity() const { return mCapacity; }
+		u32 GetChunkCount() const { return mChunks.size(); }
+		Chunk & GetChunk(u32 index) { return *mChunks[index]; }
+		u32 GetEntityCount() const;
+
+		// packed arrays of a chunk
+		EntityId * GetEntities(Chunk & chunk) { return reinterpret_cast<EntityId*>(chunk.mData); }
+		void * GetColumn(Chunk & chunk, u32 column) { return chunk.mData + mOffsets[column]; }
+		void * GetComponent(Chunk & chunk, u32 column, u32 row) { return chunk.mData + mOffsets[column] + row * mTypes[column]->mSize; }
+		template <typename T> T * GetArray(Chunk & chunk)
+		{
+			u32 column = FindColumn(ComponentType::Get<T>().mId);
+			return column < GetTypeCount() ? static_cast<T*>(GetColumn(chunk, column)) : NULL;
+		}
+
+	private:
+		// adds an uninitialized row at the end, returns the chunk index and row.
+		void AllocateRow(u32 & chunk, u32 & row);
+		void FreeLastChunkIfEmpty();
+
+		std::vector<const ComponentType*>	mTypes;
+		std::vector<u32>					mOffsets;	// per column, in bytes from chunk start
+		u32									mCapacity;
+		std::vector<Chunk*>					mChunks;
+
+		// cached archetype graph: adding/removing type id -> archetype
+		AEX_HASH_MAP(u32, Archetype*) mAddEdges;
+		AEX_HASH_MAP(u32, Archetype*) mRemoveEdges;
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	ArchetypeStorage
+	// \brief	Owns entities and their components, grouped by archetype so that
+	//			systems can iterate tightly packed arrays of components.
+	//
+	//	IComp adapter: an entity can be bound to a GameObject. IComp derived
+	//	components stored in the chunks are then added to that GameObject, so
+	//	existing code (GetComp<T>, Initialize, Shutdown, handles...) keeps
+	//	working: removing one from the object (or destroying the object)
+	//	shuts it down and removes it from the chunks. The storage updates the
+	//	GameObject and the handle table whenever a component moves in memory.
+	//	Pointers to chunk components are only stable until the next structural
+	//	change (create/destroy entity, add/remove component): keep handles.
+	//	Components that register their address elsewhere (ex: LogicComp and
+	//	its groups) can't live in chunks; TransformComp does (see
+	//	Scene::GetArchetypes).
+	class ArchetypeStorage
+	{
+	public:
+		ArchetypeStorage();
+		~ArchetypeStorage();
+
+		// entities
+		EntityId CreateEntity(GameObject * owner = NULL);
+		void DestroyEntity(EntityId entity);
+		bool IsAlive(EntityId entity) const;
+		u32 GetEntityCount() const { return mEntityCount; }
+
+		// binds the GameObject that sees this entity's IComp components, once.
+		// The object then owns the entity: deleting it destroys the entity.
+		void BindObject(EntityId entity, GameObject * owner);
+		GameObject * GetObject(EntityId entity) const;
+		EntityId GetEntity(GameObject * owner);		// the entity bound to owner, created the first time
+
+		// GameObject::NewComp for components stored in the chunks
+		template <typename T> T * NewComp(GameObject * owner, const char * compName = NULL)
+		{
+			T * comp = AddComponent<T>(GetEntity(owner));
+			if (compName)
+				comp->SetName(compName);
+			return comp;
+		}
+
+		// components
+		template <typename T> T * AddComponent(EntityId entity)
+		{
+			return static_cast<T*>(AddComponent(entity, ComponentType::Get<T>()));
+		}
+		template <typename T> void RemoveComponent(EntityId entity)
+		{
+			RemoveComponent(entity, ComponentType::Get<T>());
+		}
+		template <typename T> T * GetComponent(EntityId entity)
+		{
+			return static_cast<T*>(GetComponent(entity, ComponentType::Get<T>()));
+		}
+		template <typename T> bool HasComponent(EntityId entity)
+		{
+			return GetComponent(entity, ComponentType::Get<T>()) != NULL;
+		}
+		void * AddComponent(EntityId entity, const ComponentType & type);
+		void RemoveComponent(EntityId entity, const ComponentType & type);
+		void * GetComponent(EntityId entity, const ComponentType & type);
+
+		// called by GameObject::FreeComp: comp has left its owner and was shut
+		// down, the entity moves to the archetype without it.
+		void ReleaseComp(EntityId entity, IComp * comp);
+
+		// ------------------------------------------------------------------------
+		// Iteration: calls fn(count, entities, T* array, Ts*... arrays) once per
+		// chunk of every archetype that has all of T, Ts. Arrays are packed: element i of
+		// each array belongs to entities[i]. Don't add/remove entities or
+		// components from inside fn.
+		template <typename T, typename... Ts, typename Fn> void ForEach(Fn fn)
+		{
+			const u32 typeIds[] = { ComponentType::Get<T>().mId, ComponentType::Get<Ts>().mId... };
+			FOR_EACH(it, mArchetypes)
+			{
+				Archetype * archetype = *it;
+				if (!HasAllTypes(*archetype, typeIds, 1 + sizeof...(Ts)))
+					continue;
+				for (u32 c = 0; c < archetype->GetChunkCount(); ++c)
+				{
+					Chunk & chunk = archetype->GetChunk(c);
+					fn(chunk.mCount, archetype->GetEntities(chunk), archetype->GetArray<T>(chunk), archetype->GetArray<Ts>(chunk)...);
+				}
+			}
+		}
+
+		// archetypes
+		u32 GetArchetypeCount() const { return mArchetypes.size(); }
+		Archetype & GetArchetype(u32 index) { return *mArchetypes[index]; }
+
+	private:
+		ArchetypeStorage(const ArchetypeStorage &);
+		ArchetypeStorage & operator=(const ArchetypeStorage &);
+
+		struct EntityRecord
+		{
+			Archetype *		mArchetype;		// NULL if the slot is free
+			u32				mChunk;
+			u32				mRow;
+			u32				mGeneration;
+			GameObject *	mOwner;
+		};
+
+		EntityRecord * GetRecord(EntityId entity);
+		const EntityRecord * GetRecord(EntityId entity) const;
+		Archetype * FindOrCreateArchetype(const std::vector<const ComponentType*> & types);
+		Archetype * GetArchetypeWith(Archetype * src, const ComponentType & type);
+		Archetype * GetArchetypeWithout(Archetype * src, const ComponentType & type);
+		void MoveEntity(u32 entityIndex, Archetype * dst);
+		void RemoveRow(Archetype * archetype, u32 chunk, u32 row);
+		void AttachComp(EntityRecord & record, const ComponentType & type, void * obj);
+		void MoveComp(const ComponentType & type, void * dst, void * src);
+		static bool HasAllTypes(const Archetype & archetype, const u32 * typeIds, u32 count);
+
+		AEX_PTR_ARRAY(Archetype)	mArchetypes;
+		Archetype *					mEmpty;			// archetype with no components
+		AEX_ARRAY(EntityRecord)		mEntities;
+		AEX_ARRAY(u32)				mFreeEntities;
+		u32							mEntityCount;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
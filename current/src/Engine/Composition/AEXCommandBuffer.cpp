@@ -0,0 +1,287 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXCommandBuffer.cpp
+// Purpose:	Deferred structural changes (create/destroy objects, add/remove
+//			components), recorded per thread and applied at a sync point.
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstring>
+#include "AEXCommandBuffer.h"
+#include "..\Scene\AEXScene.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	#pragma region// COMMAND BUFFER
+	const u32 CommandBuffer::kNoName;
+
+	CommandBuffer::CommandBuffer()
+	{}
+
+	GameObject * CommandBuffer::CreateObject(const char * name)
+	{
+		GameObject * obj = new GameObject();
+		if (name)
+			obj->SetName(name);
+		Record(eCreateObject, obj, NULL);
+		return obj;
+	}
+	void CommandBuffer::DestroyObject(GameObject * obj)
+	{
+		if (obj)
+			Record(eDestroyObject, obj, NULL);
+	}
+	void CommandBuffer::AddComp(GameObject * obj, CompFactory factory, const char * compName)
+	{
+		if (!obj || !factory)
+			return;
+		Record(eAddComp, obj, compName);
+		mCommands.back().mFactory = factory;
+	}
+	void CommandBuffer::RemoveComp(GameObject * obj, IComp * comp)
+	{
+		if (!obj || !comp)
+			return;
+		Record(eRemoveComp, obj, NULL);
+		mCommands.back().mComp = comp;
+	}
+	void CommandBuffer::RemoveCompType(GameObject * obj, const Rtti & compType)
+	{
+		if (!obj)
+			return;
+		Record(eRemoveCompType, obj, NULL);
+		mCommands.back().mCompType = &compType;
+	}
+
+	void CommandBuffer::Record(ECommand command, GameObject * obj, const char * name)
+	{
+		Command cmd = { command, obj, NULL, NULL, NULL, kNoName };
+		if (name)
+		{
+			cmd.mName = mNames.size();
+			mNames.insert(mNames.end(), name, name + strlen(name) + 1);
+		}
+		mCommands.push_back(cmd);
+	}
+	const char * CommandBuffer::GetName(const Command & command) const
+	{
+		return command.mName != kNoName ? &mNames[command.mName] : NULL;
+	}
+	void CommandBuffer::Clear()
+	{
+		// keeps the capacity for the next frame
+		mCommands.clear();
+		mNames.clear();
+	}
+	void CommandBuffer::Swap(CommandBuffer & other)
+	{
+		mCommands.swap(other.mCommands);
+		mNames.swap(other.mNames);
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// DEFERRED COMMANDS
+
+	DeferredCommands::DeferredCommands()
+	{}
+	DeferredCommands::~DeferredCommands()
+	{
+		FOR_EACH(it, mBuffers)
+			delete *it;
+		FOR_EACH(it, mApplying)
+			delete *it;
+	}
+	bool DeferredCommands::Initialize()
+	{
+		// one buffer per thread, before any job can record
+		while (mBuffers.size() < aexJobSystem->GetThreadCount())
+			mBuffers.push_back(new CommandBuffer);
+		while (mApplying.size() < mBuffers.size() + 1)
+			mApplying.push_back(new CommandBuffer);
+		return true;
+	}
+
+	template <typename Fn>
+	void DeferredCommands::Record(const Fn & fn)
+	{
+		u32 thread = aexJobSystem->GetThreadIndex();
+		if (thread < mBuffers.size())
+			fn(*mBuffers[thread]);
+		else
+		{
+			std::lock_guard<std::mutex> lock(mSharedMutex);
+			fn(mSharedBuffer);
+		}
+	}
+
+	GameObject * DeferredCommands::CreateObject(const char * name)
+	{
+		GameObject * obj = NULL;
+		Record([&](CommandBuffer & buffer) { obj = buffer.CreateObject(name); });
+		return obj;
+	}
+	void DeferredCommands::DestroyObject(GameObject * obj)
+	{
+		Record([&](CommandBuffer & buffer) { buffer.DestroyObject(obj); });
+	}
+	void DeferredCommands::AddComp(GameObject * obj, CommandBuffer::CompFactory factory, const char * compName)
+	{
+		Record([&](CommandBuffer & buffer) { buffer.AddComp(obj, factory, compName); });
+	}
+	void DeferredCommands::RemoveComp(GameObject * obj, IComp * comp)
+	{
+		Record([&](CommandBuffer & buffer) { buffer.RemoveComp(obj, comp); });
+	}
+	void DeferredCommands::RemoveCompType(GameObject * obj, const Rtti & compType)
+	{
+		Record([&](CommandBuffer & buffer) { buffer.RemoveCompType(obj, compType); });
+	}
+
+	void DeferredCommands::Apply()
+	{
+		// the job system may have been restarted with more threads
+		Initialize();
+
+		// the commands are swapped out, then applied without the lock: the
+		// components record again from Initialize or Shutdown, and the other
+		// threads keep recording. Repeated until nothing new comes in.
+		for (;;)
+		{
+			bool empty = true;
+			for (u32 i = 0; i < mBuffers.size(); ++i)
+			{
+				mApplying[i]->Swap(*mBuffers[i]);
+				empty = empty && mApplying[i]->IsEmpty();
+			}
+			{
+				std::lock_guard<std::mutex> lock(mSharedMutex);
+				mApplying[mBuffers.size()]->Swap(mSharedBuffer);
+			}
+			if (empty && mApplying[mBuffers.size()]->IsEmpty())
+				break;
+			ApplyBuffers(mApplying);
+		}
+	}
+	void DeferredCommands::Apply(CommandBuffer & buffer)
+	{
+		ApplyBuffers(AEX_PTR_ARRAY(CommandBuffer)(1, &buffer));
+	}
+
+	namespace
+	{
+		struct PendingAdd
+		{
+			CommandBuffer::CompFactory	mFactory;
+			GameObject *				mObject;
+			const char *				mName;
+			u32							mOrder;		// keeps the recording order per type
+		};
+		bool operator<(const PendingAdd & a, const PendingAdd & b)
+		{
+			if (a.mFactory != b.mFactory)
+				return std::less<CommandBuffer::CompFactory>()(a.mFactory, b.mFactory);
+			return a.mOrder < b.mOrder;
+		}
+	}
+
+	void DeferredCommands::ApplyBuffers(const AEX_PTR_ARRAY(CommandBuffer) & buffers)
+	{
+		DebugAssert(aexJobSystem->GetThreadIndex() == 0 || !aexJobSystem->IsRunning(),
+			"DeferredCommands must be applied on the main thread.");
+
+		// sort the commands by kind
+		AEX_ARRAY(PendingAdd) adds;
+		AEX_ARRAY(GameObject*) created, destroyed;
+		FOR_EACH(b, buffers)
+		{
+			CommandBuffer & buffer = **b;
+			FOR_EACH(cmd, buffer.mCommands)
+			{
+				switch (cmd->mCommand)
+				{
+				case CommandBuffer::eCreateObject:
+					created.push_back(cmd->mObject);
+					break;
+				case CommandBuffer::eAddComp:
+				{
+					PendingAdd add = { cmd->mFactory, cmd->mObject, buffer.GetName(*cmd), (u32)adds.size() };
+					adds.push_back(add);
+					break;
+				}
+				case CommandBuffer::eDestroyObject:
+					destroyed.push_back(cmd->mObject);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		std::sort(created.begin(), created.end());
+		std::sort(destroyed.begin(), destroyed.end());
+		destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+
+		// 1. add, one type (pool) at a time, then remove
+		std::sort(adds.begin(), adds.end());
+		AEX_PTR_ARRAY(IComp) addedToLive;
+		FOR_EACH(it, adds)
+		{
+			IComp * comp = it->mFactory();
+			if (it->mName)
+				comp->SetName(it->mName);
+			it->mObject->AddComp(comp);
+			if (!std::binary_search(created.begin(), created.end(), it->mObject))
+				addedToLive.push_back(comp);
+		}
+		FOR_EACH(b, buffers)
+		{
+			FOR_EACH(cmd, (*b)->mCommands)
+			{
+				if (cmd->mCommand == CommandBuffer::eRemoveComp)
+				{
+					// may have been removed by another command already
+					addedToLive.erase(std::remove(addedToLive.begin(), addedToLive.end(), cmd->mComp), addedToLive.end());
+					cmd->mObject->RemoveComp(cmd->mComp);
+				}
+				else if (cmd->mCommand == CommandBuffer::eRemoveCompType)
+				{
+					IComp * comp = cmd->mObject->GetComp(*cmd->mCompType);
+					addedToLive.erase(std::remove(addedToLive.begin(), addedToLive.end(), comp), addedToLive.end());
+					cmd->mObject->RemoveComp(comp);
+				}
+			}
+		}
+
+		// 2. initialize, skipping what gets destroyed anyway
+		FOR_EACH(it, created)
+		{
+			if (!std::binary_search(destroyed.begin(), destroyed.end(), *it))
+			{
+				aexScene->AddObject(*it);
+				(*it)->Initialize();
+			}
+		}
+		FOR_EACH(it, addedToLive)
+			if (!std::binary_search(destroyed.begin(), destroyed.end(), (*it)->GetOwner()))
+				(*it)->Initialize();
+
+		// 3. destroy
+		FOR_EACH(it, destroyed)
+		{
+			if (aexScene->Contains(*it))
+				aexScene->DestroyObject(*it);
+			else
+			{
+				(*it)->RemoveAllComp();
+				delete *it;
+			}
+		}
+
+		FOR_EACH(b, buffers)
+			(*b)->Clear();
+	}
+	#pragma endregion
+}
@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXCommandBuffer.h
+// Purpose:	Deferred structural changes (create/destroy objects, add/remove
+//			components), recorded per thread and applied at a sync point.
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_COMMAND_BUFFER_H_
+#define AEX_COMMAND_BUFFER_H_
+
+#include "AEXGameObject.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	namespace internal
+	{
+		template <typename T> IComp * CreatePooledComp()
+		{
+			return IComp::Create<T>();
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	// \class	CommandBuffer
+	// \brief	Structural changes recorded by one thread. Not thread safe on
+	//			its own: use DeferredCommands, which keeps one per thread.
+	class CommandBuffer
+	{
+		friend class DeferredCommands;
+
+	public:
+		typedef IComp * (*CompFactory)();
+
+		CommandBuffer();
+
+		// the object is allocated right away (so that it can be used in later
+		// commands) but it is only added to the Scene and initialized when the
+		// buffer is applied.
+		GameObject * CreateObject(const char * name = NULL);
+		void DestroyObject(GameObject * obj);
+
+		// the component is created from its pool when the buffer is applied,
+		// then initialized unless obj is created in the same Apply.
+		template <typename T> void AddComp(GameObject * obj, const char * compName = NULL)
+		{
+			AddComp(obj, &internal::CreatePooledComp<T>, compName);
+		}
+		void AddComp(GameObject * obj, CompFactory factory, const char * compName = NULL);
+		void RemoveComp(GameObject * obj, IComp * comp);
+		void RemoveCompType(GameObject * obj, const Rtti & compType);
+
+		bool IsEmpty() const { return mCommands.empty(); }
+		u32 GetCommandCount() const { return mCommands.size(); }
+
+	private:
+		enum ECommand { eCreateObject, eAddComp, eRemoveComp, eRemoveCompType, eDestroyObject };
+		struct Command
+		{
+			ECommand		mCommand;
+			GameObject *	mObject;
+			IComp *			mComp;		// eRemoveComp
+			const Rtti *	mCompType;	// eRemoveCompType
+			CompFactory		mFactory;	// eAddComp
+			u32				mName;		// offset in mNames, kNoName if none
+		};
+		static const u32 kNoName = 0xFFFFFFFF;
+
+		void Record(ECommand command, GameObject * obj, const char * name);
+		const char * GetName(const Command & command) const;
+		void Clear();
+		void Swap(CommandBuffer & other);
+
+		AEX_ARRAY(Command)	mCommands;
+		AEX_ARRAY(char)		mNames;		// null terminated names, one allocation for all
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	DeferredCommands
+	// \brief	Makes structural changes safe while systems iterate, and from
+	//			worker threads: each job system thread records into its own
+	//			CommandBuffer (other threads share one behind a lock) and Apply
+	//			performs everything on the main thread, once per frame.
+	//
+	//	Apply works in bulk, per kind of command instead of in recording order:
+	//	1. components added, grouped by type (one pool at a time), then the
+	//	   removed components.
+	//	2. created objects added to the Scene and initialized, then the
+	//	   components added to existing objects.
+	//	3. destroyed objects: their components are removed and the object is
+	//	   deleted (and leaves the Scene). Destroying an object twice is fine.
+	//	So adding and removing a type in the same frame replaces the old
+	//	component, and destroying an object wins over everything else.
+	class DeferredCommands : public ISystem
+	{
+		AEX_RTTI_DECL(DeferredCommands, ISystem);
+		AEX_SINGLETON(DeferredCommands);
+
+	public:
+		virtual ~DeferredCommands();
+		virtual bool Initialize();
+		virtual void Update() { Apply(); }
+
+		// buffer of the calling thread, valid until the next Apply.
+		GameObject * CreateObject(const char * name = NULL);
+		void DestroyObject(GameObject * obj);
+		template <typename T> void AddComp(GameObject * obj, const char * compName = NULL)
+		{
+			AddComp(obj, &internal::CreatePooledComp<T>, compName);
+		}
+		void AddComp(GameObject * obj, CommandBuffer::CompFactory factory, const char * compName = NULL);
+		void RemoveComp(GameObject * obj, IComp * comp);
+		void RemoveCompType(GameObject * obj, const Rtti & compType);
+
+		// sync point, main thread only: applies and clears all the buffers.
+		// What the components record while it runs (ex: from Initialize) is
+		// applied too, before it returns.
+		void Apply();
+		void Apply(CommandBuffer & buffer);
+
+	private:
+		template <typename Fn> void Record(const Fn & fn);	// on the calling thread's buffer
+		void ApplyBuffers(const AEX_PTR_ARRAY(CommandBuffer) & buffers);
+
+		AEX_PTR_ARRAY(CommandBuffer)	mBuffers;		// one per job system thread
+		AEX_PTR_ARRAY(CommandBuffer)	mApplying;		// swapped with mBuffers (then the shared one) by Apply
+		CommandBuffer					mSharedBuffer;	// other threads
+		std::mutex						mSharedMutex;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexCommands (AEX::DeferredCommands::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
@@ -15,6 +15,8 @@ namespace AEX
 	IComp::IComp()
 		: mOwner(NULL)
 		, mbEnabled(true)
+		, mbOwnedByStorage(false)
+		, mpDestroy(NULL)
 	{}
 	IComp::~IComp()
 	{}
@@ -24,6 +26,30 @@ namespace AEX
 		return mOwner;
 	}
 
+	// ----------------------------------------------------------------------------
+	// Allocation
+	void IComp::Destroy(IComp * comp)
+	{
+		if (!comp)
+			return;
+		if (comp->mpDestroy)
+			comp->mpDestroy(comp);
+		else
+			delete comp;
+	}
+
+	// ----------------------------------------------------------------------------
+	// Handles
+	HandleTable<IComp> & IComp::GetHandleTable()
+	{
+		static HandleTable<IComp> sHandles;
+		return sHandles;
+	}
+	IComp * IComp::Get(const CompHandle & handle)
+	{
+		return GetHandleTable().Get(handle);
+	}
+
 	// ----------------------------------------------------------------------------
 	// PUBLIC - State Methods - By default they do nothing in this component
 	//void IComp::OnCreate()
@@ -34,6 +60,10 @@ namespace AEX
 	{}
 	void IComp::Update()
 	{}
+	void IComp::Reset()
+	{}
+	void IComp::Recycle()
+	{}
 
 	// ----------------------------------------------------------------------------
 	bool IComp::IsEnabled()
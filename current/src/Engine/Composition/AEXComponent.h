@@ -9,10 +9,15 @@
 #ifndef AEX_COMPONENT_H_
 #define AEX_COMPONENT_H_
 
+#include <new>
 #include "..\Core\AEXCore.h"
+#include "..\Utilities\AEXPoolAllocator.h"
 
 namespace AEX
 {
+	class IComp;
+	typedef Handle<IComp> CompHandle;
+
 	// ----------------------------------------------------------------------------
 	// \class	IComp 
 	// \brief	Base component class
@@ -20,6 +25,7 @@ namespace AEX
 	{
 		AEX_RTTI_DECL(IComp, IBase);
 		friend class GameObject;
+		friend class Prefab;
 
 	public:
 		IComp();
@@ -32,15 +38,53 @@ namespace AEX
 		virtual void Initialize();		// Called when the owner object is finishhed being assembled.
 		virtual void Update();			// Called by the system at each update.
 		virtual void Shutdown();		// Called by the owner object when destroyed
+		virtual void Reset();			// Called when a pooled owner is reused: back to the state after Initialize
+		virtual void Recycle();			// Called when a pooled owner goes back to its pool, before its handle is released
 
 		// Gets the owner, only the gameobject class can modify this
 		GameObject* GetOwner(void);
 
+		// Allocation: Create<T> allocates from T's pool (see TypedPool). Destroy
+		// returns a component to the pool it came from, or deletes it if it
+		// was created with new.
+		template <typename T> static T * Create();
+		static void Destroy(IComp * comp);
+
+		// Handle: assigned when the component is added to a game object,
+		// released when it is removed. Pooled components get a new one each
+		// time their owner is spawned. Stays the same if the component moves.
+		CompHandle GetHandle() const { return mHandle; }
+		static IComp * Get(const CompHandle & handle);	// NULL if stale
+
 	//protected:
 	public:
 		GameObject			*mOwner; // owner object
 		bool				mbEnabled;
+		bool				mbOwnedByStorage; // lives in an ArchetypeStorage chunk, the owner must not delete it
+		void				(*mpDestroy)(IComp * comp); // set by Create<T>, NULL if created with new
+		CompHandle			mHandle;
+
+	private:
+		static HandleTable<IComp> & GetHandleTable();
 	};
+
+	namespace internal
+	{
+		template <typename T> void DestroyPooledComp(IComp * comp)
+		{
+			T * obj = static_cast<T*>(comp);
+			obj->~T();
+			TypedPool<T>::Get().Free(obj);
+		}
+	}
+
+	template <typename T>
+	T * IComp::Create()
+	{
+		T * comp = new (TypedPool<T>::Get().Allocate()) T();
+		comp->mpDestroy = &internal::DestroyPooledComp<T>;
+		return comp;
+	}
 }
 
 
@@ -3,4 +3,8 @@
 
 #include "AEXComponent.h"
 #include "AEXGameObject.h"
+#include "AEXArchetype.h"
+#include "AEXCommandBuffer.h"
+#include "AEXObjectPool.h"
+#include "AEXPrefab.h"
 #endif
\ No newline at end of file
@@ -7,6 +7,7 @@
 // Copyright DigiPen Institute of Technology
 // ----------------------------------------------------------------------------
 #include "AEXComposition.h"
+#include "..\Scene\AEXScene.h"
 
 namespace AEX
 {
@@ -15,11 +16,24 @@ namespace AEX
 	// ----------------------------------------------------------------------------
 	// AEXOBJECT
 
+	const u32 GameObject::kNotPooled;
+
 	GameObject::GameObject()
 		: IBase()
-	{}
+		, mbEnabled(true)
+		, mNameSlot(0)
+		, mTagSlot(0)
+		, mPool(kNotPooled)
+		, mpArchetypes(NULL)
+	{
+		mEntity.mIndex = mEntity.mGeneration = 0;
+	}
 	GameObject::~GameObject()
-	{}
+	{
+		// what is left of the entity (its IComps are usually removed already)
+		if (mpArchetypes)
+			mpArchetypes->DestroyEntity(mEntity);
+	}
 
 	// ----------------------------------------------------------------------------
 	#pragma region// STATE METHODS
@@ -49,6 +63,49 @@ namespace AEX
 		FOR_EACH(it, mComps)
 			(*it)->Shutdown();
 	}
+	void GameObject::Reset()
+	{
+		// back to the state of a new object, components stay initialized.
+		// New handles first: Reset can register the components again.
+		FOR_EACH(it, mComps)
+		{
+			if ((*it)->mHandle.IsNull())
+				(*it)->mHandle = IComp::GetHandleTable().Insert(*it);
+		}
+		FOR_EACH(it, mComps)
+			(*it)->Reset();
+	}
+	void GameObject::Recycle()
+	{
+		// the components leave their systems, then the handles to them go stale
+		FOR_EACH(it, mComps)
+			(*it)->Recycle();
+		FOR_EACH(it, mComps)
+		{
+			IComp::GetHandleTable().Remove((*it)->mHandle);
+			(*it)->mHandle = CompHandle();
+		}
+	}
+
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// NAME, TAG & HANDLE
+
+	void GameObject::SetName(const char * name)
+	{
+		u32 oldHash = GetNameHash();
+		IBase::SetName(name);
+		if (!mHandle.IsNull())
+			aexScene->OnNameChanged(this, oldHash);
+	}
+	void GameObject::SetTag(const char * tag)
+	{
+		u32 oldHash = GetTagHash();
+		mTag = StringId::Intern(tag);
+		if (!mHandle.IsNull())
+			aexScene->OnTagChanged(this, oldHash);
+	}
 
 	#pragma endregion
 
@@ -68,38 +125,28 @@ namespace AEX
 	}
 	IComp* GameObject::GetComp(const char * type) const
 	{
-		// go throught the components and look for the same type
-		for (auto it = mComps.begin(); it != mComps.end(); ++it)
-		{
-			std::string typeName = (*it)->GetType().GetName();
-			if (typeName == type)
-				return (*it);
-		}
-		return NULL;
+		// the registry confirms the name, then binary search the lookup table
+		const Rtti * rtti = Rtti::FindType(type);
+		return rtti ? FindComp(*rtti, NULL) : NULL;
 	}
 	IComp* GameObject::GetComp(const Rtti & type) const
 	{
-		// go throught the components and look for the same type
-		for (auto it = mComps.begin(); it != mComps.end(); ++it)
-		{
-			if ((*it)->GetType().IsExactly(type))
-				return (*it);
-		}
-		return NULL;
+		return FindComp(type, NULL);
 	}
 	IComp* GameObject::GetCompName(const char * compName, const char *compType) const
 	{
+		// type specified -> only look in that type's range
+		if (compType)
+		{
+			const Rtti * rtti = Rtti::FindType(compType);
+			return rtti ? FindComp(*rtti, compName) : NULL;
+		}
+
+		// any type -> compare names
 		for (auto it = mComps.begin(); it != mComps.end(); ++it)
 		{
-			// found a match with the name
-			if (strcmp((*it)->GetName(), compName) == 0)
-			{
-				// not same type -> continue
-				if (compType && strcmp(compType, (*it)->GetType().GetName()) != 0)
-					continue;
-				// same type or don't care about type -> return
+			if ((*it)->HasName(compName))
 				return (*it);
-			}
 		}
 		return NULL;
 	}
@@ -109,7 +156,12 @@ namespace AEX
 	{
 		if (pComp) {
 			pComp->mOwner = this;
+			if (pComp->mHandle.IsNull())
+				pComp->mHandle = IComp::GetHandleTable().Insert(pComp);
 			mComps.push_back(pComp);
+
+			CompSlot entry = { pComp->GetType().GetId(), mComps.size() - 1 };
+			InsertCompSlot(entry);
 		}
 		return pComp;
 	}
@@ -117,14 +169,25 @@ namespace AEX
 	{
 		if (!pComp)
 			return;
-		//pComp->Shutdown(); //TODO: make sure that we indeed don't need that
-		// NOTE this will create memory leaks.
-		for (auto it = mComps.begin(); it != mComps.end(); ++it)
+		for (u32 slot = 0; slot < mComps.size(); ++slot)
 		{
-			if ((*it) == pComp)
+			if (mComps[slot] == pComp)
 			{
-				pComp->mOwner = NULL;
-				mComps.erase(it);
+				mComps.erase(mComps.begin() + slot);
+
+				// drop the entry and shift the slots after it
+				for (u32 i = 0; i < mCompLookup.size();)
+				{
+					if (mCompLookup[i].mSlot == slot)
+						mCompLookup.erase(mCompLookup.begin() + i);
+					else
+					{
+						if (mCompLookup[i].mSlot > slot)
+							--mCompLookup[i].mSlot;
+						++i;
+					}
+				}
+				FreeComp(pComp);
 				return;
 			}
 		}
@@ -145,41 +208,137 @@ namespace AEX
 	}
 
 	// Removes all components encoutered that match the search criteria
+	// single pass over the components, then one rebuild of the lookup table.
 	void GameObject::RemoveAllCompType(const char * compType)
 	{
-		IComp* pComp = GetComp(compType);
-		while (pComp)
-		{
-			RemoveComp(pComp);
-			pComp = GetComp(compType);
-		}
+		if (const Rtti * rtti = Rtti::FindType(compType))
+			RemoveAllCompType(*rtti);
 	}
 	void GameObject::RemoveAllCompType(const Rtti & compType)
 	{
-		IComp* pComp = GetComp(compType);
-		while (pComp)
+		u32 kept = 0;
+		for (u32 i = 0; i < mComps.size(); ++i)
 		{
-			RemoveComp(pComp);
-			pComp = GetComp(compType);
+			if (mComps[i]->GetType().IsExactly(compType))
+				FreeComp(mComps[i]);
+			else
+				mComps[kept++] = mComps[i];
 		}
+		mComps.resize(kept);
+		RebuildCompLookup();
 	}
 	void GameObject::RemoveAllCompName(const char * compName, const char * compType)
 	{
-		IComp* pComp = GetCompName(compName, compType);
-		while (pComp)
+		const Rtti * rtti = compType ? Rtti::FindType(compType) : NULL;
+		if (compType && !rtti)
+			return;
+		u32 kept = 0;
+		for (u32 i = 0; i < mComps.size(); ++i)
 		{
-			RemoveComp(pComp);
-			pComp = GetCompName(compName, compType);
+			IComp * comp = mComps[i];
+			if (comp->HasName(compName) && (!rtti || comp->GetType().IsExactly(*rtti)))
+				FreeComp(comp);
+			else
+				mComps[kept++] = comp;
 		}
+		mComps.resize(kept);
+		RebuildCompLookup();
 	}
 
 	void GameObject::RemoveAllComp()
 	{
 		while (mComps.size())
 		{
-			mComps.back()->Shutdown();
-			delete mComps.back();
+			IComp * comp = mComps.back();
 			mComps.pop_back();
+			FreeComp(comp);
+		}
+		mCompLookup.clear();
+	}
+	void GameObject::FreeComp(IComp * pComp)
+	{
+		IComp::GetHandleTable().Remove(pComp->mHandle);
+		pComp->mHandle = CompHandle();
+		pComp->Shutdown();
+		pComp->mOwner = NULL;
+
+		// chunk memory: the entity moves to the archetype without it
+		if (pComp->mbOwnedByStorage)
+			mpArchetypes->ReleaseComp(mEntity, pComp);
+		else
+			IComp::Destroy(pComp);
+	}
+
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// COMPONENT LOOKUP
+
+	u32 GameObject::FindFirstCompSlot(u32 typeId) const
+	{
+		// lower bound
+		u32 first = 0, count = mCompLookup.size();
+		while (count > 0)
+		{
+			u32 half = count / 2;
+			if (mCompLookup[first + half].mTypeId < typeId)
+			{
+				first += half + 1;
+				count -= half + 1;
+			}
+			else
+				count = half;
+		}
+		return first;
+	}
+	IComp* GameObject::FindComp(const Rtti & type, const char * compName) const
+	{
+		const u32 typeId = type.GetId();
+		for (u32 i = FindFirstCompSlot(typeId); i < mCompLookup.size() && mCompLookup[i].mTypeId == typeId; ++i)
+		{
+			IComp * comp = mComps[mCompLookup[i].mSlot];
+
+			// different types can share a hash
+			if (!comp->GetType().IsExactly(type))
+				continue;
+
+			// not same name -> continue
+			if (compName && !comp->HasName(compName))
+				continue;
+
+			// same name or don't care about the name
+			return comp;
+		}
+		return NULL; // not found
+	}
+	void GameObject::InsertCompSlot(const CompSlot & entry)
+	{
+		// entry always has the highest slot so far -> goes after the same type entries
+		u32 i = FindFirstCompSlot(entry.mTypeId);
+		while (i < mCompLookup.size() && mCompLookup[i].mTypeId == entry.mTypeId)
+			++i;
+		mCompLookup.insert(mCompLookup.begin() + i, entry);
+	}
+	void GameObject::ReplaceComp(IComp * oldComp, IComp * newComp)
+	{
+		// same type -> the lookup entries don't change
+		for (u32 slot = 0; slot < mComps.size(); ++slot)
+		{
+			if (mComps[slot] == oldComp)
+			{
+				mComps[slot] = newComp;
+				IComp::GetHandleTable().Set(newComp->mHandle, newComp);
+				return;
+			}
+		}
+	}
+	void GameObject::RebuildCompLookup()
+	{
+		mCompLookup.clear();
+		for (u32 slot = 0; slot < mComps.size(); ++slot)
+		{
+			CompSlot entry = { mComps[slot]->GetType().GetId(), slot };
+			InsertCompSlot(entry);
 		}
 	}
 
@@ -10,15 +10,25 @@
 #define AEX_OBJECT_H_
 // ----------------------------------------------------------------------------
 #include "AEXComponent.h"
+#include "AEXArchetype.h"
 
 #pragma warning (disable:4251) // dll and STL
 namespace AEX
 {
+	class GameObject;
+	typedef Handle<GameObject> GameObjectHandle;
+
 	class GameObject : public IBase
 	{
 		AEX_RTTI_DECL(GameObject, IBase);
+		friend class ArchetypeStorage;
+		friend class Scene;
+		friend class ObjectPool;
+		friend class Prefab;
 
 	public:
+		// most objects have 2 to 6 components: kept inside the object
+		typedef AEX_SMALL_PTR_ARRAY(IComp, 6) CompArray;
 
 		GameObject();
 		virtual ~GameObject();
@@ -27,6 +37,27 @@ namespace AEX
 		virtual void SetEnabled(bool enabled); // Call Set Enabled on all components
 		virtual void Initialize();	// Calls initialize on all components
 		virtual void Shutdown();
+		virtual void Reset();		// Calls Reset on all components, see ObjectPool
+		virtual void Recycle();		// Calls Recycle on all components, see ObjectPool
+
+		// created by an ObjectPool: destroying it gives it back to the pool
+		bool IsPooled() const { return mPool != kNotPooled; }
+
+		// --------------------------------------------------------------------
+		#pragma region// NAME, TAG & HANDLE
+		// the Scene indexes objects by name and by tag
+		virtual void SetName(const char * name);
+		const char * GetTag() const { return mTag.GetString(); }
+		void SetTag(const char * tag);
+		StringId GetTagId() const { return mTag; }
+		u32 GetTagHash() const { return mTag.GetHash(); }
+		bool HasTag(const char * tag) const { return mTag.Matches(tag); }
+		bool HasTag(StringId tag) const { return mTag == tag; }
+
+		// null until the object is added to the Scene
+		GameObjectHandle GetHandle() const { return mHandle; }
+		#pragma endregion
+
 		// --------------------------------------------------------------------
 		#pragma region// COMPONENT MANAGEMENT
 
@@ -47,7 +78,8 @@ namespace AEX
 		template<typename T>
 		T * NewComp(const char * name = NULL);
 
-		// Add/Remove by address
+		// Add/Remove by address. Removed components are shut down and freed
+		// (see IComp::Destroy), unless they live in an ArchetypeStorage.
 		IComp* AddComp(IComp * pComp);
 		void RemoveComp(IComp * pComp);
 
@@ -65,33 +97,53 @@ namespace AEX
 		void RemoveAllComp();
 
 
-		// debug only!!
-		std::vector<IComp*> &GetComps()  { return mComps; }
-		const std::vector<IComp*> &GetComps() const { return mComps; }
+		// debug only!! (don't add or remove through these, the lookup table won't know)
+		CompArray &GetComps()  { return mComps; }
+		const CompArray &GetComps() const { return mComps; }
 
 	protected:
-		AEX_PTR_ARRAY(IComp) mComps;
+		CompArray mComps;
 		bool mbEnabled;
+		StringId mTag;				// interned
+		GameObjectHandle mHandle;	// set by the Scene
+		u32 mNameSlot;				// position in the Scene's name and tag buckets
+		u32 mTagSlot;
+		u32 mPool;					// set by the ObjectPool
+		static const u32 kNotPooled = 0xFFFFFFFF;
+		ArchetypeStorage * mpArchetypes;	// storage of its entity, set by ArchetypeStorage::BindObject
+		EntityId mEntity;					// valid if mpArchetypes isn't NULL
+
+		// --------------------------------------------------------------------
+		#pragma region// COMPONENT LOOKUP
+		// Component index sorted by type id (then by slot), kept in sync with
+		// mComps by AddComp/RemoveComp. Objects have a handful of components so
+		// a binary search in this small array is effectively constant time.
+		struct CompSlot
+		{
+			u32 mTypeId;	// Rtti::GetId() of the component
+			u32 mSlot;		// index in mComps
+		};
+		AEX_SMALL_ARRAY(CompSlot, 6) mCompLookup;
+
+		u32  FindFirstCompSlot(u32 typeId) const;	// first entry with mTypeId >= typeId
+		IComp* FindComp(const Rtti & type, const char * compName) const;
+		void InsertCompSlot(const CompSlot & entry);
+		void RebuildCompLookup();
+		#pragma endregion
+
+		// swaps the address of a component (same type), used by ArchetypeStorage
+		// when it moves a component in memory.
+		void ReplaceComp(IComp * oldComp, IComp * newComp);
+
+		// unlinks a removed component, then shuts it down and frees it (chunk
+		// components: the storage destroys it).
+		void FreeComp(IComp * pComp);
 	};
 
 	template<class T>
 	T* GameObject::GetComp(const char * compName)
 	{
-		// go throught the components and look for the same type
-		for (auto it = mComps.begin(); it != mComps.end(); ++it)
-		{
-			if ((*it)->GetType().IsExactly(T::TYPE()))
-			{
-				// not same name -> continue
-				if (compName && strcmp(compName, (*it)->GetName()) != 0)
-					continue;
-
-				// same name or don't care about the name
-				// return
-				return (T*)(*it);
-			}
-		}
-		return NULL; // not found
+		return (T*)FindComp(T::TYPE(), compName);
 	}
 	template<class T>
 	T* GameObject::GetCompDerived(const char * compName)
@@ -102,7 +154,7 @@ namespace AEX
 			if ((*it)->GetType().IsDerived(T::TYPE()))
 			{
 				// not same name -> continue
-				if (compName && strcmp(compName, (*it)->GetName()) != 0)
+				if (compName && !(*it)->HasName(compName))
 					continue;
 
 				// same name or don't care about the name
@@ -115,10 +167,10 @@ namespace AEX
 
 	template<typename T>
 	T * GameObject::NewComp(const char * compName) {
-		T* newComp = new T;
+		T* newComp = IComp::Create<T>();
 		if (compName)
 			newComp->SetName(compName);
-		return dynamic_cast<T*>(AddComp(newComp));
+		return aex_cast<T>(AddComp(newComp));
 	}
 }
 #pragma warning (default:4251) // dll and STL
@@ -0,0 +1,204 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXObjectPool.cpp
+// Purpose:	Recycles game objects with their components, per composition
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include "AEXObjectPool.h"
+#include "AEXPrefab.h"
+#include "..\Scene\AEXScene.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	ObjectPool::ObjectPool()
+	{}
+	ObjectPool::~ObjectPool()
+	{
+		Clear();
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// POOLS
+
+	StringId ObjectPool::Register(const char * key, ObjectBuilder builder)
+	{
+		StringId keyId = StringId::Intern(key);
+		if (DebugErrorIf(IsRegistered(keyId), "ObjectPool: \"%s\" is already registered", key))
+			return keyId;
+
+		Pool pool;
+		pool.mKey = keyId;
+		pool.mBuilder = builder;
+		pool.mPrefab = NULL;
+		memset(&pool.mStats, 0, sizeof(pool.mStats));
+		mPoolByKey[keyId.GetHash()] = mPools.size();
+		mPools.push_back(pool);
+		return keyId;
+	}
+	StringId ObjectPool::Register(const Prefab & prefab)
+	{
+		if (DebugErrorIf(!prefab.IsCompiled(), "ObjectPool: prefab \"%s\" isn't compiled", prefab.GetName().GetString()))
+			return prefab.GetName();
+		StringId keyId = Register(prefab.GetName().GetString(), NULL);
+		mPools[mPoolByKey[keyId.GetHash()]].mPrefab = &prefab;
+		return keyId;
+	}
+	bool ObjectPool::IsRegistered(StringId key) const
+	{
+		return FindPool(key) != NULL;
+	}
+
+	void ObjectPool::Prewarm(StringId key, u32 count)
+	{
+		Pool * pool = FindPool(key);
+		if (DebugErrorIf(!pool, "ObjectPool::Prewarm: \"%s\" is not registered", key.GetString()))
+			return;
+
+		u32 poolIndex = pool - &mPools[0];
+		pool->mFree.reserve(pool->mFree.size() + count);
+		for (u32 i = 0; i < count; ++i)
+		{
+			// disabled first: the components initialize without registering
+			GameObject * obj = Build(poolIndex);
+			obj->SetEnabled(false);
+			obj->Initialize();
+			obj->Recycle();
+			mPools[poolIndex].mFree.push_back(obj);
+		}
+		ObjectPoolStats & stats = mPools[poolIndex].mStats;
+		stats.mFreeCount = mPools[poolIndex].mFree.size();
+		if (stats.mLiveCount + stats.mFreeCount > stats.mPeakCount)
+			stats.mPeakCount = stats.mLiveCount + stats.mFreeCount;
+	}
+
+	void ObjectPool::Clear(StringId key)
+	{
+		Pool * pool = FindPool(key);
+		if (!pool)
+			return;
+		FOR_EACH(it, pool->mFree)
+		{
+			(*it)->mPool = GameObject::kNotPooled;
+			(*it)->RemoveAllComp();
+			delete *it;
+		}
+		pool->mFree.clear();
+		pool->mStats.mFreeCount = 0;
+	}
+	void ObjectPool::Clear()
+	{
+		FOR_EACH(it, mPools)
+			Clear(it->mKey);
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// OBJECTS
+
+	GameObject * ObjectPool::Spawn(StringId key, const char * name)
+	{
+		Pool * pool = FindPool(key);
+		if (DebugErrorIf(!pool, "ObjectPool::Spawn: \"%s\" is not registered", key.GetString()))
+			return NULL;
+
+		ObjectPoolStats & stats = pool->mStats;
+		++stats.mSpawnCount;
+		++stats.mLiveCount;
+
+		GameObject * obj;
+		if (!pool->mFree.empty())
+		{
+			// hit: already built and initialized
+			obj = pool->mFree.back();
+			pool->mFree.pop_back();
+			--stats.mFreeCount;
+			++stats.mHitCount;
+
+			if (name && !obj->HasName(name))
+				obj->SetName(name);
+			else if (!name && obj->GetNameId() != key)
+				obj->SetName(key.GetString());
+			aexScene->AddObject(obj);
+			obj->Reset();
+			obj->SetEnabled(true);
+			return obj;
+		}
+
+		// miss: build it, same steps as a new object
+		if (stats.mLiveCount + stats.mFreeCount > stats.mPeakCount)
+			stats.mPeakCount = stats.mLiveCount + stats.mFreeCount;
+		obj = Build(pool - &mPools[0]);
+		if (name)
+			obj->SetName(name);
+		aexScene->AddObject(obj);
+		obj->Initialize();
+		return obj;
+	}
+
+	void ObjectPool::Release(GameObject * obj)
+	{
+		if (!obj || !obj->IsPooled())
+			return;
+		DebugErrorIf(!obj->GetHandle().IsNull(), "ObjectPool::Release: \"%s\" is still in the scene", obj->GetName());
+
+		Pool & pool = mPools[obj->mPool];
+		obj->SetEnabled(false);
+		obj->Recycle();
+		pool.mFree.push_back(obj);
+		--pool.mStats.mLiveCount;
+		++pool.mStats.mFreeCount;
+	}
+
+	GameObject * ObjectPool::Build(u32 poolIndex)
+	{
+		Pool & pool = mPools[poolIndex];
+		GameObject * obj = new GameObject();
+		obj->mPool = poolIndex;
+		obj->SetName(pool.mKey.GetString());
+		if (pool.mPrefab)
+			pool.mPrefab->Build(obj);
+		else if (pool.mBuilder)
+			pool.mBuilder(obj);
+		return obj;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// STATS
+
+	ObjectPoolStats ObjectPool::GetStats(StringId key) const
+	{
+		const Pool * pool = FindPool(key);
+		if (pool)
+			return pool->mStats;
+		ObjectPoolStats stats;
+		memset(&stats, 0, sizeof(stats));
+		return stats;
+	}
+	void ObjectPool::PrintStats() const
+	{
+		MyPrintFunction("%-32s %8s %8s %8s %8s %8s\n", "Object pool", "Spawns", "Hit %", "Live", "Free", "Peak");
+		FOR_EACH(it, mPools)
+		{
+			const ObjectPoolStats & stats = it->mStats;
+			MyPrintFunction("%-32s %8u %8.1f %8u %8u %8u\n", it->mKey.GetString(), stats.mSpawnCount, 100.0f * stats.GetHitRate(),
+				stats.mLiveCount, stats.mFreeCount, stats.mPeakCount);
+		}
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	ObjectPool::Pool * ObjectPool::FindPool(StringId key)
+	{
+		AEX_HASH_MAP(u32, u32)::iterator it = mPoolByKey.find(key.GetHash());
+		return it != mPoolByKey.end() ? &mPools[it->second] : NULL;
+	}
+	const ObjectPool::Pool * ObjectPool::FindPool(StringId key) const
+	{
+		AEX_HASH_MAP(u32, u32)::const_iterator it = mPoolByKey.find(key.GetHash());
+		return it != mPoolByKey.end() ? &mPools[it->second] : NULL;
+	}
+}
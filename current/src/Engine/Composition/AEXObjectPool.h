@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXObjectPool.h
+// Purpose:	Recycles game objects with their components, per composition
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_OBJECT_POOL_H_
+#define AEX_OBJECT_POOL_H_
+
+#include "AEXGameObject.h"
+#include "..\Core\AEXSystem.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// stats of one pool
+	struct ObjectPoolStats
+	{
+		u32 mSpawnCount;	// Spawn calls
+		u32 mHitCount;		// Spawn calls that reused an object
+		u32 mLiveCount;		// spawned, in the scene
+		u32 mFreeCount;		// waiting to be reused
+		u32 mPeakCount;		// most objects the pool had at once (live + free)
+
+		f32 GetHitRate() const { return mSpawnCount ? f32(mHitCount) / f32(mSpawnCount) : 0.0f; }
+	};
+
+	class Prefab;
+
+	// ----------------------------------------------------------------------------
+	// \class	ObjectPool
+	// \brief	Keeps destroyed game objects, with their components, to spawn
+	//			them again without allocating. One pool per composition: a key
+	//			(composition or prefab name) and the builder that adds its
+	//			components.
+	//
+	//	Spawn reuses a free object if there is one: GameObject::Reset (new
+	//	component handles, then each component's Reset) then SetEnabled(true).
+	//	Otherwise it builds a new one and initializes it. Either way the object
+	//	is added to the Scene. Destroying a pooled object through the Scene (or
+	//	aexCommands) disables it and gives it back to its pool instead of
+	//	deleting it: the components stay initialized, disabled LogicComps
+	//	leave the Logic registry, and GameObject::Recycle (each component's
+	//	Recycle) releases the component handles, which stop resolving like
+	//	those of destroyed components.
+	//
+	//	Prewarm the pools in IGameState::LoadResources so that spawns never
+	//	build during the game. Main thread only, like the Scene, and released
+	//	after it (~AEXEngine): the scene gives the live objects back first.
+	class ObjectPool : public ISystem
+	{
+		AEX_RTTI_DECL(ObjectPool, ISystem);
+		AEX_SINGLETON(ObjectPool);
+
+	public:
+		typedef void (*ObjectBuilder)(GameObject * obj);	// adds the components
+
+		virtual ~ObjectPool();
+
+		// ------------------------------------------------------------------------
+		// pools
+		StringId Register(const char * key, ObjectBuilder builder);
+		StringId Register(const Prefab & prefab);	// keyed by the prefab name, which must outlive the pool
+		bool IsRegistered(StringId key) const;
+
+		// builds objects up front, they wait disabled and out of the scene
+		void Prewarm(StringId key, u32 count);
+
+		// deletes the free objects of a pool, or of all of them. Live objects
+		// still come back to their pool when destroyed.
+		void Clear(StringId key);
+		void Clear();
+
+		// ------------------------------------------------------------------------
+		// objects
+		// enabled and in the scene. Named name, or key if NULL. NULL if the key
+		// isn't registered.
+		GameObject * Spawn(StringId key, const char * name = NULL);
+		GameObject * Spawn(const char * key, const char * name = NULL) { return Spawn(StringId(StringId::Hash(key)), name); }
+
+		// called by Scene::DestroyObject, once the object is out of the scene
+		void Release(GameObject * obj);
+
+		// ------------------------------------------------------------------------
+		// stats
+		ObjectPoolStats GetStats(StringId key) const;
+		void PrintStats() const;	// one line per pool, through MyPrintFunction (all builds)
+
+	private:
+		struct Pool
+		{
+			StringId				mKey;
+			ObjectBuilder			mBuilder;
+			const Prefab *			mPrefab;	// builds instead of mBuilder if set
+			AEX_PTR_ARRAY(GameObject)	mFree;
+			ObjectPoolStats			mStats;
+		};
+
+		Pool * FindPool(StringId key);
+		const Pool * FindPool(StringId key) const;
+		GameObject * Build(u32 poolIndex);
+
+		AEX_ARRAY(Pool)			mPools;
+		AEX_HASH_MAP(u32, u32)	mPoolByKey;		// key hash -> index in mPools
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexObjectPool (AEX::ObjectPool::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
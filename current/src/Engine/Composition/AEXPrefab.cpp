@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXPrefab.cpp
+// Purpose:	Prefab templates: a component layout and default values, copied
+//			to stamp out many identical objects
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include <algorithm>
+#include "AEXPrefab.h"
+#include "..\Scene\AEXScene.h"
+#include "..\Scene\AEXTransformComp.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	Prefab::Prefab(const char * name)
+		: mName(StringId::Intern(name))
+		, mBlob(NULL)
+		, mBlobAllocation(NULL)
+		, mBlobSize(0)
+	{}
+	Prefab::~Prefab()
+	{
+		FOR_EACH(it, mEntries)
+		{
+			if (IsCompiled())
+				it->mType->mDestruct(it->mDefaults);
+			else
+				delete it->mType->mAsComp(it->mDefaults);	// virtual destructor
+		}
+		delete[] mBlobAllocation;
+	}
+
+	void Prefab::CheckNotCompiled() const
+	{
+		DebugAssert(!IsCompiled(), "Prefab \"%s\": components can't be added once compiled", mName.GetString());
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// COMPILE
+
+	void Prefab::Compile()
+	{
+		if (DebugErrorIf(IsCompiled(), "Prefab \"%s\" is already compiled", mName.GetString()))
+			return;
+
+		// layout: each component at its alignment, in definition order
+		u32 size = 0, maxAlign = 1;
+		FOR_EACH(it, mEntries)
+		{
+			// bitwise instances would share the default's hierarchy node or storage slot
+			const IComp * comp = it->mType->mAsComp(it->mDefaults);
+			const TransformComp * transform = aex_cast<TransformComp>(comp);
+			const TransformComp3D * transform3D = aex_cast<TransformComp3D>(comp);
+			DebugAssert(!transform || (!transform->IsInHierarchy() && !transform->IsStored()),
+				"Prefab \"%s\": a default transform is in the hierarchy or stored", mName.GetString());
+			DebugAssert(!transform3D || !transform3D->IsInHierarchy(),
+				"Prefab \"%s\": a default transform is in the hierarchy", mName.GetString());
+
+			u32 align = it->mType->mAlign;
+			size = (size + align - 1) & ~(align - 1);
+			it->mOffset = size;
+			size += it->mType->mSize;
+			if (align > maxAlign)
+				maxAlign = align;
+		}
+		mBlobSize = size;
+		mBlobAllocation = new u8[size + maxAlign];
+		mBlob = reinterpret_cast<u8*>((reinterpret_cast<size_t>(mBlobAllocation) + maxAlign - 1) & ~size_t(maxAlign - 1));
+
+		// the defaults move into the blob
+		mLookup.clear();
+		for (u32 i = 0; i < mEntries.size(); ++i)
+		{
+			Entry & entry = mEntries[i];
+			void * dst = mBlob + entry.mOffset;
+			entry.mType->mCopy(dst, entry.mDefaults);
+			delete entry.mType->mAsComp(entry.mDefaults);
+			entry.mDefaults = dst;
+
+			GameObject::CompSlot slot = { entry.mType->mAsComp(dst)->GetType().GetId(), i };
+			mLookup.push_back(slot);
+		}
+		std::sort(mLookup.begin(), mLookup.end(), [](const GameObject::CompSlot & a, const GameObject::CompSlot & b) {
+			return a.mTypeId != b.mTypeId ? a.mTypeId < b.mTypeId : a.mSlot < b.mSlot;
+		});
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// INSTANCES
+
+	IComp * Prefab::NewComp(const Entry & entry) const
+	{
+		const PrefabCompType & type = *entry.mType;
+		void * mem = type.mGetPool().Allocate();
+		if (type.mbBitwise)
+			memcpy(mem, mBlob + entry.mOffset, type.mSize);
+		else
+			type.mCopy(mem, mBlob + entry.mOffset);
+
+		// what the copy brought from the defaults that isn't theirs
+		IComp * comp = type.mAsComp(mem);
+		comp->mOwner = NULL;
+		comp->mHandle = CompHandle();
+		comp->mbOwnedByStorage = false;
+		comp->mpDestroy = type.mDestroy;
+		comp->mUID = IComp::NewUID();
+		return comp;
+	}
+
+	GameObject * Prefab::NewObject(StringId name) const
+	{
+		GameObject * obj = new GameObject();
+		obj->mName = name;	// already interned
+		obj->mTag = mTag;
+		return obj;
+	}
+
+	void Prefab::Build(GameObject * obj) const
+	{
+		if (DebugErrorIf(!IsCompiled(), "Prefab \"%s\" isn't compiled", mName.GetString()))
+			return;
+
+		if (!mTag.IsEmpty() && obj->mTag != mTag)
+			obj->SetTag(mTag.GetString());
+
+		// empty object: the lookup is the compiled one
+		if (obj->mComps.empty())
+		{
+			obj->mComps.reserve(mEntries.size());
+			FOR_EACH(it, mEntries)
+			{
+				IComp * comp = NewComp(*it);
+				comp->mOwner = obj;
+				comp->mHandle = IComp::GetHandleTable().Insert(comp);
+				obj->mComps.push_back(comp);
+			}
+			obj->mCompLookup = mLookup;
+			return;
+		}
+		FOR_EACH(it, mEntries)
+			obj->AddComp(NewComp(*it));
+	}
+
+	GameObject * Prefab::Instantiate(const char * name) const
+	{
+		if (DebugErrorIf(!IsCompiled(), "Prefab \"%s\" isn't compiled", mName.GetString()))
+			return NULL;
+
+		GameObject * obj = NewObject(name ? StringId::Intern(name) : mName);
+		Build(obj);
+		aexScene->AddObject(obj);
+		obj->Initialize();
+		return obj;
+	}
+
+	void Prefab::Instantiate(u32 count, AEX_PTR_ARRAY(GameObject) & out, const char * name) const
+	{
+		if (DebugErrorIf(!IsCompiled(), "Prefab \"%s\" isn't compiled", mName.GetString()))
+			return;
+
+		StringId nameId = name ? StringId::Intern(name) : mName;
+		u32 first = out.size();
+		out.reserve(first + count);
+		for (u32 i = 0; i < count; ++i)
+		{
+			GameObject * obj = NewObject(nameId);
+			obj->mComps.reserve(mEntries.size());
+			obj->mCompLookup = mLookup;
+			out.push_back(obj);
+		}
+
+		// component by component: one pool and one default blob at a time
+		FOR_EACH(it, mEntries)
+		{
+			for (u32 i = first; i < out.size(); ++i)
+			{
+				IComp * comp = NewComp(*it);
+				comp->mOwner = out[i];
+				comp->mHandle = IComp::GetHandleTable().Insert(comp);
+				out[i]->mComps.push_back(comp);
+			}
+		}
+
+		for (u32 i = first; i < out.size(); ++i)
+		{
+			aexScene->AddObject(out[i]);
+			out[i]->Initialize();
+		}
+	}
+	#pragma endregion
+}
@@ -0,0 +1,151 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXPrefab.h
+// Purpose:	Prefab templates: a component layout and default values, copied
+//			to stamp out many identical objects
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_PREFAB_H_
+#define AEX_PREFAB_H_
+
+#include <new>
+#include "AEXGameObject.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \struct	PrefabTraits
+	// \brief	kBitwiseCopy: instances of T can be copied with memcpy from the
+	//			prefab defaults instead of the copy constructor. Only for types
+	//			that own nothing (no strings, containers or owning pointers).
+	//			Declare it with AEX_PREFAB_BITWISE after the class, in namespace
+	//			AEX.
+	template <typename T>
+	struct PrefabTraits
+	{
+		static const bool kBitwiseCopy = false;
+	};
+	#define AEX_PREFAB_BITWISE(type)								\
+		template <> struct PrefabTraits<type>						\
+		{															\
+			static const bool kBitwiseCopy = true;					\
+		}
+
+	// ----------------------------------------------------------------------------
+	// \struct	PrefabCompType
+	// \brief	Type erased component type of a prefab.
+	struct PrefabCompType
+	{
+		u32		mSize;
+		u32		mAlign;
+		bool	mbBitwise;
+		PoolAllocator & (*mGetPool)();
+		void	(*mCopy)(void * dst, const void * src);	// copy constructs
+		void	(*mDestruct)(void * obj);
+		IComp *	(*mAsComp)(void * obj);
+		void	(*mDestroy)(IComp * comp);					// back to the pool, see IComp::Create
+
+		template <typename T> static const PrefabCompType & Get();
+	};
+
+	namespace internal
+	{
+		template <typename T> PoolAllocator & GetCompPool()					{ return TypedPool<T>::Get(); }
+		template <typename T> void CopyPrefabComp(void * dst, const void * src)	{ new (dst) T(*static_cast<const T*>(src)); }
+		template <typename T> void DestructPrefabComp(void * obj)				{ static_cast<T*>(obj)->~T(); }
+		template <typename T> IComp * PrefabCompAsComp(void * obj)				{ return static_cast<T*>(obj); }
+	}
+
+	template <typename T>
+	const PrefabCompType & PrefabCompType::Get()
+	{
+		static const PrefabCompType sType = {
+			sizeof(T), alignof(T), PrefabTraits<T>::kBitwiseCopy,
+			&internal::GetCompPool<T>, &internal::CopyPrefabComp<T>, &internal::DestructPrefabComp<T>,
+			&internal::PrefabCompAsComp<T>, &internal::DestroyPooledComp<T> };
+		return sType;
+	}
+
+	// ----------------------------------------------------------------------------
+	// \class	Prefab
+	// \brief	Definition of an object: its components with their default
+	//			values. Compile packs the defaults in one blob and sorts the
+	//			component lookup once, so that an instance is a few pool
+	//			allocations and copies.
+	//
+	//	Components of bitwise types (see PrefabTraits) are memcpy'd from the
+	//	blob, the others are copy constructed. Instances are never
+	//	initialized by the copy: Instantiate initializes them once they are
+	//	in the scene. Use a prefab as an ObjectPool composition to recycle
+	//	the instances too.
+	class Prefab
+	{
+	public:
+		explicit Prefab(const char * name);
+		~Prefab();
+
+		// ------------------------------------------------------------------------
+		// definition, before Compile. Set the default values on the returned
+		// component; it is never initialized nor added to an object.
+		template <typename T> T * AddComp(const char * compName = NULL)
+		{
+			CheckNotCompiled();
+			T * comp = new T();
+			if (compName)
+				comp->SetName(compName);
+			Entry entry = { &PrefabCompType::Get<T>(), comp, 0 };
+			mEntries.push_back(entry);
+			return comp;
+		}
+		void SetTag(const char * tag) { mTag = StringId::Intern(tag); }
+
+		// lays out the blob, the defaults can't change after this
+		void Compile();
+		bool IsCompiled() const { return mBlob != NULL; }
+
+		StringId GetName() const { return mName; }
+		StringId GetTag() const { return mTag; }
+		u32 GetCompCount() const { return mEntries.size(); }
+		u32 GetBlobSize() const { return mBlobSize; }
+
+		// ------------------------------------------------------------------------
+		// instances
+		// adds copies of the components to an object without any (ObjectPool
+		// builder), not initialized
+		void Build(GameObject * obj) const;
+
+		// new objects in the scene, initialized. Named name, or like the prefab.
+		GameObject * Instantiate(const char * name = NULL) const;
+		void Instantiate(u32 count, AEX_PTR_ARRAY(GameObject) & out, const char * name = NULL) const;
+
+	private:
+		struct Entry
+		{
+			const PrefabCompType *	mType;
+			void *					mDefaults;	// the T: heap before Compile, in the blob after
+			u32						mOffset;	// in the blob
+		};
+
+		// not copyable: owns the blob and the defaults
+		Prefab(const Prefab &);
+		const Prefab & operator=(const Prefab &);
+
+		void CheckNotCompiled() const;
+		IComp * NewComp(const Entry & entry) const;
+		GameObject * NewObject(StringId name) const;
+
+		StringId					mName;
+		StringId					mTag;
+		AEX_ARRAY(Entry)			mEntries;
+		AEX_SMALL_ARRAY(GameObject::CompSlot, 6)	mLookup;	// compiled GameObject::mCompLookup
+		u8 *						mBlob;			// aligned, in mBlobAllocation
+		u8 *						mBlobAllocation;
+		u32							mBlobSize;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
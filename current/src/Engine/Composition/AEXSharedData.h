@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXSharedData.h
+// Purpose:	Immutable, reference counted component data shared between
+//			instances, copied on write
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_SHARED_DATA_H_
+#define AEX_SHARED_DATA_H_
+
+#include <atomic>
+#include "..\Utilities\AEXAllocator.h"
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	SharedData
+	// \brief	Pointer to a block of T shared by the components that hold it
+	//			(flyweight): copying a SharedData, or a component holding one,
+	//			shares the block instead of copying T. Read with Get or ->.
+	//			Edit gives a private copy first if the block is shared, so an
+	//			instance overriding a field never changes the others.
+	//
+	//	Default constructed, it shares one default T per type and allocates
+	//	nothing. The count is atomic: holders can be copied and destroyed on
+	//	any thread. Editing the same holder from two threads is not safe, like
+	//	any other component field.
+	template <typename T>
+	class SharedData
+	{
+	public:
+		SharedData() : mBlock(GetDefaultBlock())	{ AddRef(); }
+		explicit SharedData(const T & data) : mBlock(EngineAllocator::New<Block>(eMT_General, data)) {}
+		SharedData(const SharedData & other) : mBlock(other.mBlock)	{ AddRef(); }
+		~SharedData()	{ Release(); }
+
+		SharedData & operator=(const SharedData & other)
+		{
+			if (mBlock != other.mBlock)
+			{
+				other.AddRef();
+				Release();
+				mBlock = other.mBlock;
+			}
+			return *this;
+		}
+
+		// ------------------------------------------------------------------------
+		// read
+		const T & Get() const			{ return mBlock->mData; }
+		const T * operator->() const	{ return &mBlock->mData; }
+
+		// write: copy on write if anyone else holds the block
+		T & Edit()
+		{
+			if (IsShared())
+			{
+				Block * copy = EngineAllocator::New<Block>(eMT_General, mBlock->mData);
+				Release();
+				mBlock = copy;
+			}
+			return mBlock->mData;
+		}
+
+		// ------------------------------------------------------------------------
+		// sharing
+		bool IsShared() const { return mBlock->mRefCount.load(std::memory_order_acquire) > 1; }
+		bool IsSharedWith(const SharedData & other) const { return mBlock == other.mBlock; }
+		u32 GetRefCount() const { return mBlock->mRefCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct Block
+		{
+			explicit Block(const T & data) : mRefCount(1), mData(data) {}
+			std::atomic<u32>	mRefCount;
+			T					mData;
+		};
+
+		// holds a reference on itself: never freed
+		static Block * GetDefaultBlock()
+		{
+			static Block * sDefault = EngineAllocator::New<Block>(eMT_General, T());
+			return sDefault;
+		}
+		void AddRef() const { mBlock->mRefCount.fetch_add(1, std::memory_order_relaxed); }
+		void Release()
+		{
+			if (mBlock->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				EngineAllocator::Delete(mBlock, eMT_General);
+		}
+
+		Block * mBlock;
+	};
+}
+
+// ----------------------------------------------------------------------------
+#endif
@@ -0,0 +1,18 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXBase.cpp
+// Purpose:	IBase unique ids
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <atomic>
+#include "AEXBase.h"
+
+namespace AEX
+{
+	u32 IBase::NewUID()
+	{
+		static std::atomic<u32> sNextUID(1);
+		return sNextUID.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -29,17 +29,41 @@ namespace AEX
 		// ----------------------------------------------------------------------------
 		#pragma region// NAME & UID
 	public:
-		const char * GetName()			{ return mName.c_str(); }
-		void SetName(const char * name)	{ mName = name; }
+		const char * GetName() const	{ return mName.GetString(); }
+		virtual void SetName(const char * name)	{ mName = StringId::Intern(name); }
+		StringId	 GetNameId() const	{ return mName; }
+		u32			 GetNameHash() const{ return mName.GetHash(); }
+		bool		 HasName(const char * name) const { return mName.Matches(name); }
+		bool		 HasName(StringId name) const { return mName == name; }
 		u32			 GetUID()			{ return mUID; }
 	protected:
-		std::string mName;	// Non-Unique name
-		u32			mUID;	// Unique number ID
+		StringId	mName;		// Non-Unique name, interned
+		u32			mUID;		// Unique number ID, from NewUID. Copies keep it.
+		static u32	NewUID();	// thread safe, starts at 1
 		#pragma endregion
 		
 	protected:
-		IBase() {} // only accessible from child classes. can't construct an IBase explicitly.
+		IBase() : mUID(NewUID()) {} // only accessible from child classes. can't construct an IBase explicitly.
 	};
+
+	// ----------------------------------------------------------------------------
+	// \fn		aex_cast
+	// \brief	Checked cast using the engine Rtti instead of dynamic_cast. Returns
+	//			NULL if pObj isn't a T. T must declare its own AEX_RTTI_DECL.
+	template <typename T>
+	T * aex_cast(IBase * pObj)
+	{
+		if (pObj && pObj->GetType().IsDerived(T::TYPE()))
+			return static_cast<T*>(pObj);
+		return NULL;
+	}
+	template <typename T>
+	const T * aex_cast(const IBase * pObj)
+	{
+		if (pObj && pObj->GetType().IsDerived(T::TYPE()))
+			return static_cast<const T*>(pObj);
+		return NULL;
+	}
 }
 // ----------------------------------------------------------------------------
 #endif
\ No newline at end of file
@@ -2,8 +2,12 @@
 #define AEX_FOUNDATION_H_
 
 #include "AEXDataTypes.h"		// Data typedefs
+#include "AEXStringId.h"		// Interned strings
 #include "AEXRtti.h"			// Rtti
 #include "AEXBase.h"			// Base object interface
+#include "AEXHandle.h"			// Generational handles
 #include "AEXSystem.h"			// Base system interface
+#include "AEXJobSystem.h"		// Job system
+#include "AEXSystemScheduler.h"	// Frame dependency graph
 
 #endif
\ No newline at end of file
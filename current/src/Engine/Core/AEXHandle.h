@@ -0,0 +1,119 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXHandle.h
+// Purpose:	Generational handles and the slot table that resolves them
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_HANDLE_H_
+#define AEX_HANDLE_H_
+
+#include <vector>
+#include "AEXDataTypes.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \struct	Handle
+	// \brief	Weak reference to an object in a HandleTable: slot index and the
+	//			generation of the slot when the handle was made. 8 bytes, safe to
+	//			store and to serialize (ToU64) instead of a pointer. Resolving a
+	//			handle to a removed object gives NULL.
+	template <typename T>
+	struct Handle
+	{
+		u32 mIndex;
+		u32 mGeneration;	// 0 is the null handle
+
+		Handle() : mIndex(0), mGeneration(0) {}
+		Handle(u32 index, u32 generation) : mIndex(index), mGeneration(generation) {}
+
+		bool IsNull() const { return mGeneration == 0; }
+		bool operator==(const Handle & other) const { return mIndex == other.mIndex && mGeneration == other.mGeneration; }
+		bool operator!=(const Handle & other) const { return !(*this == other); }
+
+		u64 ToU64() const { return ((u64)mGeneration << 32) | mIndex; }
+		static Handle FromU64(u64 value) { return Handle((u32)value, (u32)(value >> 32)); }
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	HandleTable
+	// \brief	Slot map from handles to pointers. Insert, Remove and Get are
+	//			O(1). Removing bumps the slot generation so that the old handles
+	//			stop resolving, and the slot is reused by the next Insert. Not
+	//			thread safe.
+	template <typename T>
+	class HandleTable
+	{
+	public:
+		HandleTable() : mFreeHead(kNoSlot), mCount(0) {}
+
+		Handle<T> Insert(T * object)
+		{
+			u32 index;
+			if (mFreeHead != kNoSlot)
+			{
+				index = mFreeHead;
+				mFreeHead = mSlots[index].mNextFree;
+			}
+			else
+			{
+				index = mSlots.size();
+				Slot slot = { NULL, 1, kNoSlot };
+				mSlots.push_back(slot);
+			}
+			mSlots[index].mObject = object;
+			mSlots[index].mNextFree = kNoSlot;
+			++mCount;
+			return Handle<T>(index, mSlots[index].mGeneration);
+		}
+		bool Remove(const Handle<T> & handle)
+		{
+			if (!Get(handle))
+				return false;
+			Slot & slot = mSlots[handle.mIndex];
+			slot.mObject = NULL;
+			if (++slot.mGeneration == 0)	// skip the null generation on wrap around
+				slot.mGeneration = 1;
+			slot.mNextFree = mFreeHead;
+			mFreeHead = handle.mIndex;
+			--mCount;
+			return true;
+		}
+
+		// NULL if the handle is null or stale
+		T * Get(const Handle<T> & handle) const
+		{
+			if (handle.mIndex < mSlots.size() && mSlots[handle.mIndex].mGeneration == handle.mGeneration)
+				return mSlots[handle.mIndex].mObject;
+			return NULL;
+		}
+		bool IsValid(const Handle<T> & handle) const { return Get(handle) != NULL; }
+
+		// the object moved in memory, the handle stays the same
+		void Set(const Handle<T> & handle, T * object)
+		{
+			if (Get(handle))
+				mSlots[handle.mIndex].mObject = object;
+		}
+
+		u32 GetCount() const { return mCount; }
+
+	private:
+		static const u32 kNoSlot = 0xFFFFFFFF;
+		struct Slot
+		{
+			T *	mObject;		// NULL when free
+			u32	mGeneration;
+			u32	mNextFree;		// free list link
+		};
+		std::vector<Slot>	mSlots;
+		u32					mFreeHead;
+		u32					mCount;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
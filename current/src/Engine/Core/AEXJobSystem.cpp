@@ -0,0 +1,347 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXJobSystem.cpp
+// Purpose:	Work-stealing job system
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>				// memcpy
+#include <chrono>
+#include "AEXJobSystem.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	namespace
+	{
+		const u32 kNoWorker = 0xFFFFFFFF;
+
+		// worker index of the current thread, kNoWorker outside of the job system.
+		thread_local u32 tWorkerIndex = kNoWorker;
+
+		// idle workers spin this many times before sleeping
+		const u32 kIdleSpins = 64;
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// JOB DEQUE
+	// Chase-Lev deque with the C11 memory orderings from "Correct and Efficient
+	// Work-Stealing for Weak Memory Models" (Le et al. 2013). Push uses a
+	// release store instead of a release fence (same cost, and visible to
+	// race detectors).
+
+	JobDeque::JobDeque()
+		: mTop(0)
+		, mBottom(0)
+	{
+		for (u32 i = 0; i < kCapacity; ++i)
+			mJobs[i].store(NULL, std::memory_order_relaxed);
+	}
+	void JobDeque::Push(Job * job)
+	{
+		s64 bottom = mBottom.load(std::memory_order_relaxed);
+		mJobs[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+		mBottom.store(bottom + 1, std::memory_order_release); // publishes the job to Steal
+	}
+	Job * JobDeque::Pop()
+	{
+		s64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+		mBottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		s64 top = mTop.load(std::memory_order_relaxed);
+
+		// empty
+		if (top > bottom)
+		{
+			mBottom.store(bottom + 1, std::memory_order_relaxed);
+			return NULL;
+		}
+
+		Job * job = mJobs[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// last job: race against the thieves
+			if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = NULL;
+			mBottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+	Job * JobDeque::Steal()
+	{
+		s64 top = mTop.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		s64 bottom = mBottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return NULL;
+
+		Job * job = mJobs[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+		if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return NULL; // lost the race
+		return job;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// JOB SYSTEM
+
+	struct JobSystem::Worker
+	{
+		JobDeque		mDeque;
+		Job *			mJobs;				// kMaxJobs ring buffer, see AllocateJob
+		u8 *			mJobMemory;			// unaligned allocation of mJobs
+		u32				mAllocated;
+		u32				mRandom;			// xorshift state to pick victims
+		std::thread		mThread;			// not joinable for worker 0
+	};
+
+	JobSystem::JobSystem()
+		: mbRunning(false)
+		, mSleeping(0)
+	{}
+	JobSystem::~JobSystem()
+	{
+		Stop();
+	}
+	bool JobSystem::Initialize()
+	{
+		return Start();
+	}
+
+	bool JobSystem::Start(u32 threadCount)
+	{
+		Stop();
+		if (threadCount == 0)
+			threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0)
+			threadCount = 1;
+
+		for (u32 i = 0; i < threadCount; ++i)
+		{
+			Worker * worker = new Worker;
+			worker->mJobMemory = new u8[kMaxJobs * sizeof(Job) + alignof(Job)];
+			worker->mJobs = reinterpret_cast<Job*>(worker->mJobMemory + (alignof(Job) - (size_t)worker->mJobMemory % alignof(Job)) % alignof(Job));
+			for (u32 j = 0; j < kMaxJobs; ++j)
+				new (worker->mJobs + j) Job();
+			worker->mAllocated = 0;
+			worker->mRandom = 2463534242u + i * 7919u;
+			mWorkers.push_back(worker);
+		}
+
+		// the calling thread is worker 0
+		tWorkerIndex = 0;
+		mbRunning = true;
+		for (u32 i = 1; i < threadCount; ++i)
+			mWorkers[i]->mThread = std::thread(&JobSystem::WorkerMain, this, i);
+		return true;
+	}
+	void JobSystem::Stop()
+	{
+		if (!IsRunning())
+			return;
+		DebugAssert(tWorkerIndex == 0, "JobSystem::Stop must be called from the thread that started it.");
+
+		// the workers drain their deques before leaving
+		mbRunning = false;
+		{
+			std::lock_guard<std::mutex> lock(mWakeMutex);
+			mWake.notify_all();
+		}
+		FOR_EACH(it, mWorkers)
+			if ((*it)->mThread.joinable())
+				(*it)->mThread.join();
+		FOR_EACH(it, mWorkers)
+		{
+			delete[] (*it)->mJobMemory;
+			delete *it;
+		}
+		mWorkers.clear();
+		tWorkerIndex = kNoWorker;
+	}
+	u32 JobSystem::GetThreadIndex() const
+	{
+		return tWorkerIndex;
+	}
+
+	// ----------------------------------------------------------------------------
+	// jobs
+	Job * JobSystem::AllocateJob()
+	{
+		DebugAssert(tWorkerIndex < mWorkers.size(), "Jobs can only be created from job system threads.");
+
+		// ring buffer: the slot is free again if the job that used it finished,
+		// which is the case when a thread has less than kMaxJobs jobs in flight.
+		Worker * worker = mWorkers[tWorkerIndex];
+		Job * job = &worker->mJobs[worker->mAllocated++ & (kMaxJobs - 1)];
+		DebugAssert(job->mUnfinished.load(std::memory_order_relaxed) == 0, "More than %u jobs in flight on one thread.", kMaxJobs);
+		return job;
+	}
+	Job * JobSystem::CreateJob(JobFunction function, const void * data, u32 dataSize)
+	{
+		return CreateChildJob(NULL, function, data, dataSize);
+	}
+	Job * JobSystem::CreateChildJob(Job * parent, JobFunction function, const void * data, u32 dataSize)
+	{
+		DebugAssert(dataSize <= Job::kDataSize, "Job data too big (%u bytes, max %u)", dataSize, Job::kDataSize);
+		if (parent)
+			parent->mUnfinished.fetch_add(1, std::memory_order_relaxed);
+
+		Job * job = AllocateJob();
+		job->mFunction = function;
+		job->mParent = parent;
+		job->mUnfinished.store(1, std::memory_order_relaxed);
+		if (data && dataSize)
+			memcpy(job->mData, data, dataSize);
+		return job;
+	}
+
+	void JobSystem::Run(Job * job)
+	{
+		DebugAssert(tWorkerIndex < mWorkers.size(), "Jobs can only be run from job system threads.");
+		mWorkers[tWorkerIndex]->mDeque.Push(job);
+
+		// wake a sleeper to steal it
+		if (mSleeping.load(std::memory_order_relaxed) > 0)
+			mWake.notify_one();
+	}
+	void JobSystem::Wait(const Job * job)
+	{
+		// help instead of blocking
+		while (!IsFinished(job))
+		{
+			if (Job * other = GetJob())
+				Execute(other);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	bool JobSystem::ExecuteOne()
+	{
+		if (tWorkerIndex >= mWorkers.size())
+			return false;
+		Job * job = GetJob();
+		if (job)
+			Execute(job);
+		return job != NULL;
+	}
+
+	Job * JobSystem::GetJob()
+	{
+		Worker * worker = mWorkers[tWorkerIndex];
+		if (Job * job = worker->mDeque.Pop())
+			return job;
+
+		// steal from a random victim
+		u32 count = mWorkers.size();
+		if (count <= 1)
+			return NULL;
+		worker->mRandom ^= worker->mRandom << 13;
+		worker->mRandom ^= worker->mRandom >> 17;
+		worker->mRandom ^= worker->mRandom << 5;
+		u32 victim = worker->mRandom % count;
+		for (u32 i = 0; i < count; ++i, victim = (victim + 1) % count)
+		{
+			if (victim == tWorkerIndex)
+				continue;
+			if (Job * job = mWorkers[victim]->mDeque.Steal())
+				return job;
+		}
+		return NULL;
+	}
+	void JobSystem::Execute(Job * job)
+	{
+		job->mFunction(job, job->mData);
+		Finish(job);
+	}
+	void JobSystem::Finish(Job * job)
+	{
+		// the last one out finishes the parent. Read the parent first: once the
+		// count hits 0 the waiter may move on and the job slot may be reused.
+		Job * parent = job->mParent;
+		if (job->mUnfinished.fetch_sub(1, std::memory_order_acq_rel) == 1 && parent)
+			Finish(parent);
+	}
+
+	void JobSystem::WorkerMain(u32 index)
+	{
+		tWorkerIndex = index;
+		u32 idle = 0;
+		for (;;)
+		{
+			if (Job * job = GetJob())
+			{
+				Execute(job);
+				idle = 0;
+			}
+			else if (!mbRunning)
+				break;
+			else if (++idle < kIdleSpins)
+				std::this_thread::yield();
+			else
+			{
+				// sleep until Run wakes us up. The timeout covers a Run that
+				// checked mSleeping just before we incremented it.
+				std::unique_lock<std::mutex> lock(mWakeMutex);
+				++mSleeping;
+				if (mbRunning)
+					mWake.wait_for(lock, std::chrono::milliseconds(1));
+				--mSleeping;
+				idle = 0;
+			}
+		}
+		tWorkerIndex = kNoWorker;
+	}
+
+	// ----------------------------------------------------------------------------
+	// parallel for
+	namespace
+	{
+		struct ParallelForRange
+		{
+			void			(*mFunction)(const void * context, u32 begin, u32 end);
+			const void *	mContext;
+			u32				mBegin;
+			u32				mEnd;
+			u32				mBatchSize;
+		};
+
+		void ParallelForJob(Job * job, const void * data)
+		{
+			const ParallelForRange & range = *static_cast<const ParallelForRange*>(data);
+			if (range.mEnd - range.mBegin <= range.mBatchSize)
+			{
+				range.mFunction(range.mContext, range.mBegin, range.mEnd);
+				return;
+			}
+
+			// split in halves, children of this job
+			u32 middle = range.mBegin + (range.mEnd - range.mBegin) / 2;
+			ParallelForRange left = range, right = range;
+			left.mEnd = middle;
+			right.mBegin = middle;
+			JobSystem * jobs = aexJobSystem;
+			jobs->Run(jobs->CreateChildJob(job, &ParallelForJob, &left, sizeof(left)));
+			jobs->Run(jobs->CreateChildJob(job, &ParallelForJob, &right, sizeof(right)));
+		}
+	}
+	void JobSystem::ParallelFor(u32 count, u32 batchSize, void(*function)(const void * context, u32 begin, u32 end), const void * context)
+	{
+		if (count == 0)
+			return;
+		if (batchSize == 0)
+			batchSize = 1;
+
+		// not started, not a job system thread or nothing to split: run inline
+		if (tWorkerIndex >= mWorkers.size() || mWorkers.size() == 1 || count <= batchSize)
+		{
+			for (u32 begin = 0; begin < count; begin += batchSize)
+				function(context, begin, count - begin < batchSize ? count : begin + batchSize);
+			return;
+		}
+
+		ParallelForRange range = { function, context, 0, count, batchSize };
+		RunAndWait(CreateJob(&ParallelForJob, &range, sizeof(range)));
+	}
+	#pragma endregion
+}
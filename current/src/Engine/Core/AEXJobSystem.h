@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXJobSystem.h
+// Purpose:	Work-stealing job system
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_JOB_SYSTEM_H_
+#define AEX_JOB_SYSTEM_H_
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new>					// placement new
+#include <type_traits>
+#include "AEXSystem.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	struct Job;
+	typedef void(*JobFunction)(Job * job, const void * data);
+
+	// ----------------------------------------------------------------------------
+	// \struct	Job
+	// \brief	A function and a few bytes of arguments, one cache line. A job is
+	//			finished when its function returned and all its children are
+	//			finished. Jobs are recycled: don't keep pointers across frames.
+	struct alignas(64) Job
+	{
+		// 52 bytes on Win32, 44 on x64: the pointers stay aligned without padding
+		static const u32 kDataSize = 64 - sizeof(JobFunction) - sizeof(Job*) - sizeof(std::atomic<s32>);
+
+		u8					mData[kDataSize];	// arguments. First: aligned like the job, whatever the pointer size
+		std::atomic<s32>	mUnfinished;		// 1 (itself) + unfinished children
+		JobFunction			mFunction;
+		Job *				mParent;
+	};
+	static_assert(sizeof(Job) == 64, "a Job must fill exactly one cache line");
+
+	// ----------------------------------------------------------------------------
+	// \class	JobDeque
+	// \brief	Chase-Lev work-stealing deque, fixed capacity. The owner thread
+	//			pushes and pops at the bottom (LIFO), other threads steal from
+	//			the top (FIFO).
+	class JobDeque
+	{
+	public:
+		static const u32 kCapacity = 4096; // power of 2
+
+		JobDeque();
+		void Push(Job * job);	// owner only
+		Job * Pop();			// owner only
+		Job * Steal();			// any thread
+
+	private:
+		std::atomic<s64>	mTop;		// thieves and owner write these: separate cache lines
+		u8					mPad[64 - sizeof(std::atomic<s64>)];
+		std::atomic<s64>	mBottom;
+		std::atomic<Job*>	mJobs[kCapacity];
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	JobSystem
+	// \brief	One worker thread per hardware thread, the thread that calls
+	//			Initialize (the main thread) being worker 0. Each worker owns a
+	//			deque and steals from the others when its own is empty. Waiting
+	//			on a job executes other jobs instead of blocking.
+	//
+	//	Jobs can only be created, run and waited on from worker threads (the
+	//	main thread or inside a job). A thread can have at most kMaxJobs
+	//	unfinished jobs.
+	class JobSystem : public ISystem
+	{
+		AEX_RTTI_DECL(JobSystem, ISystem);
+		AEX_SINGLETON(JobSystem);
+
+	public:
+		static const u32 kMaxJobs = JobDeque::kCapacity;	// per thread
+
+		virtual ~JobSystem();
+		virtual bool Initialize();	// starts one thread per hardware thread
+
+		// (re)starts with threadCount threads including the calling thread. 0 = hardware threads.
+		bool Start(u32 threadCount = 0);
+		void Stop();
+		bool IsRunning() const { return !mWorkers.empty(); }
+		u32 GetThreadCount() const { return mWorkers.size(); }
+		u32 GetThreadIndex() const;	// worker index of the calling thread
+
+		// ------------------------------------------------------------------------
+		// jobs
+		Job * CreateJob(JobFunction function, const void * data = NULL, u32 dataSize = 0);
+		Job * CreateChildJob(Job * parent, JobFunction function, const void * data = NULL, u32 dataSize = 0);
+		template <typename Fn> Job * CreateJob(const Fn & fn)				{ return CreateChildJob(NULL, fn); }
+		template <typename Fn> Job * CreateChildJob(Job * parent, const Fn & fn);
+
+		void Run(Job * job);				// queues the job on the calling thread
+		void Wait(const Job * job);			// executes jobs until job is finished
+		void RunAndWait(Job * job) { Run(job); Wait(job); }
+		bool ExecuteOne();					// runs one queued job, false if there was none
+		static bool IsFinished(const Job * job) { return job->mUnfinished.load(std::memory_order_acquire) <= 0; }
+
+		// ------------------------------------------------------------------------
+		// Calls fn(begin, end) on sub-ranges of [0, count) of at most batchSize
+		// elements, in parallel, and returns when all of them are done. The range
+		// is split in halves recursively so that idle threads steal big pieces.
+		template <typename Fn> void ParallelFor(u32 count, u32 batchSize, const Fn & fn);
+		void ParallelFor(u32 count, u32 batchSize, void(*function)(const void * context, u32 begin, u32 end), const void * context);
+
+	private:
+		struct Worker;
+
+		Job * AllocateJob();
+		Job * GetJob();						// own deque first, then steal
+		void Execute(Job * job);
+		void Finish(Job * job);
+		void WorkerMain(u32 index);
+
+		AEX_PTR_ARRAY(Worker)		mWorkers;
+		std::atomic<bool>			mbRunning;
+		std::atomic<u32>			mSleeping;	// idle workers waiting on mWake
+		std::mutex					mWakeMutex;
+		std::condition_variable		mWake;
+	};
+
+	// ----------------------------------------------------------------------------
+	// template implementation
+	namespace internal
+	{
+		template <typename Fn> void CallStoredFunctor(Job *, const void * data)
+		{
+			(*static_cast<const Fn*>(data))();
+		}
+		template <typename Fn> void CallRangeFunctor(const void * context, u32 begin, u32 end)
+		{
+			(*static_cast<const Fn*>(context))(begin, end);
+		}
+	}
+
+	template <typename Fn>
+	Job * JobSystem::CreateChildJob(Job * parent, const Fn & fn)
+	{
+		// the functor lives in the job data: it must be small and trivially destructible
+		static_assert(sizeof(Fn) <= Job::kDataSize, "functor too big for a job, capture less or by pointer");
+		static_assert(alignof(Fn) <= 16, "functor alignment too big for a job");
+		static_assert(std::is_trivially_destructible<Fn>::value, "functor is never destroyed");
+		Job * job = CreateChildJob(parent, &internal::CallStoredFunctor<Fn>);
+		new (job->mData) Fn(fn);
+		return job;
+	}
+
+	template <typename Fn>
+	void JobSystem::ParallelFor(u32 count, u32 batchSize, const Fn & fn)
+	{
+		ParallelFor(count, batchSize, &internal::CallRangeFunctor<Fn>, &fn);
+	}
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexJobSystem (AEX::JobSystem::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
@@ -1,33 +1,106 @@
+#include <deque>
 #include "AEXRtti.h"
+#include "..\Utilities\AEXContainers.h"
+#include "..\Debug\MyDebug.h"
 
 namespace AEX
 {
-	std::map<std::string, Rtti> Rtti::Types;
+	namespace
+	{
+		// Registry storage. Function statics so that types registering
+		// themselves before main never see an unconstructed container.
+		// The deque never moves its elements, so the Rtti addresses are
+		// stable; the hash map finds them by name hash.
+		std::deque<Rtti> & GetTypeStorage()
+		{
+			static std::deque<Rtti> sTypeStorage;
+			return sTypeStorage;
+		}
+		AEX_HASH_MAP(u32, Rtti*) & GetTypes()
+		{
+			static AEX_HASH_MAP(u32, Rtti*) sTypes;
+			return sTypes;
+		}
+		std::vector<Rtti*> & GetTypesByIndex()
+		{
+			static std::vector<Rtti*> sTypesByIndex;
+			return sTypesByIndex;
+		}
+	}
 
-	const Rtti & Rtti::RttiAdd(const char * typeName, const char * parentName)
+	const Rtti & Rtti::RttiAdd(const char * typeName, const Rtti * pBaseType, u32 size)
 	{
-		// TODO: insert return statement here
+		// already registered (i.e. same name from a different template instance).
+		// The id is the hash: a different name with the same hash can't get its
+		// own type, report it.
+		StringId name = StringId::Intern(typeName);
+		AEX_HASH_MAP(u32, Rtti*) & types = GetTypes();
+		AEX_HASH_MAP(u32, Rtti*)::iterator it = types.find(name.GetHash());
+		if (it != types.end())
+		{
+			DebugErrorIf(!it->second->mName.Matches(typeName), "Rtti: types \"%s\" and \"%s\" have the same id", it->second->GetName(), typeName);
+			return *it->second;
+		}
 
-			// parent isn't assumed to exists. so this might be the first time
-			// the parent type is encountered; (it depends on the call). 
-		auto & parentIt = Types[parentName];
-		parentIt.mName = parentName;
+		GetTypeStorage().push_back(Rtti());
+		Rtti & ref = GetTypeStorage().back();
+		types[name.GetHash()] = &ref;
+		ref.mName = name;
+		ref.mpBaseType = pBaseType;
+		ref.mId = name.GetHash();
+		ref.mIndex = GetTypesByIndex().size();
+		ref.mSize = size;
+		GetTypesByIndex().push_back(&ref);
 
-		std::map<std::string, Rtti>::iterator it = Types.find(typeName);
-		if (it == Types.end()) {
+		// add to parent
+		if (pBaseType)
+			const_cast<Rtti*>(pBaseType)->mChildren.push_back(&ref);
 
-			auto & ref = Types[typeName];
-			ref.mpBaseType = &parentIt;
-			ref.mName = typeName;
+		// new type -> intervals are stale
+		UpdateHierarchy();
 
-			// restore iterator
-			it = Types.find(typeName);
-		}
+		return ref;
+	}
 
-		// add to parent
-		parentIt.mChildren[typeName] = &it->second;
+	// ----------------------------------------------------------------------------
+	// Gives each type its [mPreOrder, mLastChild] interval in a depth-first walk
+	// of the type tree. A type is derived from another if its pre-order number
+	// falls in the other's interval. Registration happens (almost always) before
+	// main, so the full walk on each new type is cheap.
+	void Rtti::UpdateHierarchy()
+	{
+		u32 preOrder = 0;
+		std::vector<Rtti*> & types = GetTypesByIndex();
+		for (u32 i = 0; i < types.size(); ++i)
+		{
+			// roots only, the children are numbered recursively
+			if (types[i]->mpBaseType == NULL)
+				preOrder = NumberSubtree(types[i], preOrder) + 1;
+		}
+	}
+	u32 Rtti::NumberSubtree(Rtti * type, u32 preOrder)
+	{
+		type->mPreOrder = preOrder;
+		type->mLastChild = preOrder;
+		for (u32 i = 0; i < type->mChildren.size(); ++i)
+			type->mLastChild = NumberSubtree(type->mChildren[i], type->mLastChild + 1);
+		return type->mLastChild;
+	}
 
-		return it->second;
+	const Rtti * Rtti::FindType(const char * typeName)
+	{
+		AEX_HASH_MAP(u32, Rtti*)::iterator it = GetTypes().find(HashName(typeName));
+		if (it != GetTypes().end() && it->second->mName.Matches(typeName))
+			return it->second;
+		return NULL;
+	}
+	u32 Rtti::GetTypeCount()
+	{
+		return GetTypesByIndex().size();
+	}
+	const Rtti & Rtti::GetTypeByIndex(u32 index)
+	{
+		return *GetTypesByIndex()[index];
 	}
 
 	// ----------------------------------------------------------------------------
@@ -35,17 +108,28 @@ namespace AEX
 	Rtti::Rtti(const char * name, const Rtti * pBaseType)
 	{
 		// store the name
-		mName = name;
+		std::string typeName = name;
 		// remove the "class " prefix, returned by typeid().name() function
-		mName = mName.substr(mName.find_first_of(" ")+1); 
+		mName = StringId::Intern(typeName.substr(typeName.find_first_of(" ")+1).c_str());
 
 		// store the pointer to the base type
 		mpBaseType = pBaseType;
+
+		mId = mName.GetHash();
+		mIndex = 0;
+		mPreOrder = 0;
+		mLastChild = 0;
+		mSize = 0;
 	}
 
 	Rtti::Rtti()
-		: mName("no_name")
+		: mName(StringId::Intern("no_name"))
 		, mpBaseType(nullptr)
+		, mId(mName.GetHash())
+		, mIndex(0)
+		, mPreOrder(0)
+		, mLastChild(0)
+		, mSize(0)
 	{
 	}
 
@@ -53,7 +137,11 @@ namespace AEX
 	// getters
 	const char * Rtti::GetName() const
 	{
-		return mName.c_str();
+		return mName.GetString();
+	}
+	const Rtti * Rtti::GetBaseType() const
+	{
+		return mpBaseType;
 	}
 
 	// ----------------------------------------------------------------------------
@@ -62,21 +150,4 @@ namespace AEX
 	{
 		return this == &otherType;
 	}
-
-	// ----------------------------------------------------------------------------
-	// walks up the hierarchy comparing with address of otherType
-	bool Rtti::IsDerived(const Rtti & otherType) const
-	{
-		const Rtti * temp = this;
-		while (temp)
-		{
-			if (temp == &otherType)
-			{
-				return true;
-			}
-
-			temp = temp->mpBaseType;
-		}
-		return false;
-	}
-}
\ No newline at end of file
+}
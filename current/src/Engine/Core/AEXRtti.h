@@ -4,32 +4,92 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstring>
+#include "AEXDataTypes.h"
+#include "AEXStringId.h"
+
+// Decorated signature of the current function, used to extract type names
+// at compile time (see internal::RawTypeName below).
+#if defined(_MSC_VER)
+	#define AEX_RTTI_FUNCSIG __FUNCSIG__
+#else
+	#define AEX_RTTI_FUNCSIG __PRETTY_FUNCTION__
+#endif
 
 #pragma warning (disable:4251) // dll and STL: https://msdn.microsoft.com/en-us/library/esew7y1w.aspx
 namespace AEX
 {
+	namespace internal
+	{
+		// ----------------------------------------------------------------------------
+		// Non-owning, non null-terminated view of a type name.
+		struct TypeNameView
+		{
+			const char *	mData;
+			u32				mSize;
+			constexpr TypeNameView(const char * data, u32 size) : mData(data), mSize(size) {}
+		};
+
+		// constexpr string helpers (C++11 constexpr: single return statement)
+		constexpr bool StartsWith(const char * str, const char * prefix)
+		{
+			return *prefix == '\0' || (*str == *prefix && StartsWith(str + 1, prefix + 1));
+		}
+		constexpr u32 FindFirst(const char * str, const char * pattern, u32 pos = 0)
+		{
+			return str[pos] == '\0' ? pos : (StartsWith(str + pos, pattern) ? pos : FindFirst(str, pattern, pos + 1));
+		}
+
+		// Full signature of this function for type T:
+		// GCC/Clang:	"... RawSignature() [with T = AEX::GameObject]"
+		// MSVC:		"... __cdecl AEX::internal::RawSignature<class AEX::GameObject>(void)"
+		template <typename T>
+		constexpr TypeNameView RawSignature()
+		{
+			return TypeNameView(AEX_RTTI_FUNCSIG, sizeof(AEX_RTTI_FUNCSIG) - 1);
+		}
+
+		// probe a known type to find where the type name sits in the signature.
+		constexpr u32 kRawTypeNamePrefix = FindFirst(RawSignature<double>().mData, "double");
+		constexpr u32 kRawTypeNameSuffix = RawSignature<double>().mSize - kRawTypeNamePrefix - 6;
+
+		// Compile-time type name as the compiler spells it (MSVC keeps the "class "
+		// and "struct " keywords, Rtti::GetTypeName removes them).
+		template <typename T>
+		constexpr TypeNameView RawTypeName()
+		{
+			return TypeNameView(RawSignature<T>().mData + kRawTypeNamePrefix,
+				RawSignature<T>().mSize - kRawTypeNamePrefix - kRawTypeNameSuffix);
+		}
+	}
+
 	// ----------------------------------------------------------------------------
 	// RTTI
 	class Rtti
 	{
 	private:
-		std::string		mName;
-		const Rtti	* mpBaseType;
-		std::map<std::string, Rtti*> mChildren;
-		
+		StringId			mName;		// interned
+		const Rtti		*	mpBaseType;
+		std::vector<Rtti*>	mChildren;
+		u32					mId;		// mName hash, stable across runs
+		u32					mIndex;		// dense registration index [0, GetTypeCount())
+		u32					mPreOrder;	// position in a depth-first walk of the type tree
+		u32					mLastChild;	// mPreOrder of the last type in this subtree
+		u32					mSize;		// sizeof the type
+
 	public:
-		static std::map<std::string, Rtti> Types;
-		template<typename type> static const Rtti &  RttiAdd()
-		{
-			return RttiAdd(GetTypeName<type>().c_str(), "NULL");
-		}
+		// Registers a type (once) and returns the unique Rtti for that name.
+		static const Rtti & RttiAdd(const char * typeName, const Rtti * pBaseType, u32 size = 0);
 
-		template<typename type, typename parent> static const Rtti &  RttiAdd()
-		{
-			return RttiAdd(GetTypeName<type>().c_str(), GetTypeName<parent>().c_str());
-		}
+		// registry queries
+		static const Rtti * FindType(const char * typeName);
+		static u32			GetTypeCount();
+		static const Rtti & GetTypeByIndex(u32 index);
 
-		static const Rtti & RttiAdd(const char * typeName, const char * parentName);
+	private:
+		// renumbers the whole type tree, called when a type is registered.
+		static void UpdateHierarchy();
+		static u32	NumberSubtree(Rtti * type, u32 preOrder);
 
 	public:
 		// constructor
@@ -38,65 +98,99 @@ namespace AEX
 
 		// getters
 		const char * GetName() const;
+		const Rtti * GetBaseType() const;
+		StringId	 GetNameId() const { return mName; }
+		u32			 GetId() const { return mId; }
+		u32			 GetIndex() const { return mIndex; }
+		u32			 GetSize() const { return mSize; }
 
 		// compares this with address of otherType
 		bool IsExactly(const Rtti & otherType) const;
 
-		// walks up the hierarchy comparing with address of otherType
-		bool IsDerived(const Rtti & otherType) const;
+		// true if this type lies in otherType's subtree (two compares, no walk).
+		bool IsDerived(const Rtti & otherType) const
+		{
+			return otherType.mPreOrder <= mPreOrder && mPreOrder <= otherType.mLastChild;
+		}
+
+		// StringId hash (FNV-1a), usable at compile time on literals.
+		static constexpr u32 HashName(const char * str)
+		{
+			return StringId::Hash(str);
+		}
 
-		// convert from c++ rtti to ours
+		// convert from c++ type to our type name
 		template<typename T>
 		static std::string GetTypeName()
 		{
-			// remove class
-			std::string out = typeid(T).name();
-			std::size_t c = out.find("class ");
-			while (c != std::string::npos)
-			{
-				auto s = out.begin() + c;
-				auto e = s + strlen("class ");
-				out.replace(s, e, "");
-				c = out.find("class ");
-			}
-			// remove struct
-			c = out.find("struct ");
-			while (c != std::string::npos)
+			internal::TypeNameView raw = internal::RawTypeName<T>();
+			std::string out(raw.mData, raw.mSize);
+
+			// remove class and struct keywords (MSVC only)
+			const char * keywords[] = { "class ", "struct " };
+			for (const char * keyword : keywords)
 			{
-				auto s = out.begin() + c;
-				auto e = s + strlen("struct ");
-				out.replace(s, e, "");
-				c = out.find("struct ");
+				std::size_t c = out.find(keyword);
+				while (c != std::string::npos)
+				{
+					out.erase(c, strlen(keyword));
+					c = out.find(keyword);
+				}
 			}
 			return out;
 		}
 	};
 
+	// ----------------------------------------------------------------------------
+	// Per-type registration. The Rtti is cached in a function static so that
+	// TYPE() is a plain load after the first call, and sAutoRegister forces
+	// every type with a vtable to be registered before main.
+	template <typename T> struct RttiParent
+	{
+		static const Rtti * Get() { return &T::TYPE(); }
+	};
+	template <> struct RttiParent<void>
+	{
+		static const Rtti * Get() { return nullptr; }
+	};
 
+	template <typename T, typename Parent>
+	struct RttiRegistrar
+	{
+		static const Rtti & Get()
+		{
+			static const Rtti & sType = Rtti::RttiAdd(Rtti::GetTypeName<T>().c_str(), RttiParent<Parent>::Get(), sizeof(T));
+			(void)sAutoRegister;
+			return sType;
+		}
+		static const Rtti * const sAutoRegister;
+	};
+	template <typename T, typename Parent>
+	const Rtti * const RttiRegistrar<T, Parent>::sAutoRegister = &RttiRegistrar<T, Parent>::Get();
 }
 
 // Each class that supports Rtti must declare a new static
 // member variable and therefore must include this code
-// in its declaration. This maccro will save some time 
+// in its declaration. This maccro will save some time
 #define AEX_RTTI_DECL(thisType, parentType)											\
-	public:									\
-		virtual const AEX::Rtti& GetType() const						\
-		{	return AEX::Rtti::RttiAdd<thisType, parentType>();\
-		}\
-		static const AEX::Rtti& TYPE()\
-{return AEX::Rtti::RttiAdd<thisType, parentType>();\
-}\
-
-#define AEX_RTTI_DECL_BASE(thisType)											\
-	public:									\
-		virtual const AEX::Rtti& GetType() const						\
-		{	return AEX::Rtti::RttiAdd<thisType>();											\
-		}\
-		static const AEX::Rtti& TYPE()\
-{return AEX::Rtti::RttiAdd<thisType>();\
-}\
+	public:																			\
+		virtual const AEX::Rtti& GetType() const									\
+		{	return AEX::RttiRegistrar<thisType, parentType>::Get();					\
+		}																			\
+		static const AEX::Rtti& TYPE()												\
+		{	return AEX::RttiRegistrar<thisType, parentType>::Get();					\
+		}
+
+#define AEX_RTTI_DECL_BASE(thisType)												\
+	public:																			\
+		virtual const AEX::Rtti& GetType() const									\
+		{	return AEX::RttiRegistrar<thisType, void>::Get();						\
+		}																			\
+		static const AEX::Rtti& TYPE()												\
+		{	return AEX::RttiRegistrar<thisType, void>::Get();						\
+		}
 
 #pragma warning (default:4251) // dll and STL
 // ----------------------------------------------------------------------------
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXStringId.cpp
+// Purpose:	Interned strings identified by their hash
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include <mutex>
+#include "AEXStringId.h"
+#include "..\Utilities\AEXContainers.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	namespace
+	{
+		const u32 kChunkSize = 4096;
+
+		// ----------------------------------------------------------------------------
+		// One table per hash size. The strings are packed in chunks that are
+		// never freed, so GetString pointers stay valid for the whole run.
+		template <typename THash>
+		struct StringTable
+		{
+			std::mutex							mMutex;
+			AEX_HASH_MAP(THash, const char *)	mStrings;
+			AEX_PTR_ARRAY(char)					mChunks;
+			AEX_ARRAY(const char *)				mCollisions;	// strings whose hash was taken
+			u32									mChunkUsed;
+			u32									mBytes;
+
+			StringTable() : mChunkUsed(kChunkSize), mBytes(0)
+			{
+				mStrings[TStringId<THash>::Hash("")] = "";
+			}
+			~StringTable()
+			{
+				FOR_EACH(it, mChunks)
+					delete[] *it;
+			}
+			const char * Store(const char * str)
+			{
+				u32 size = strlen(str) + 1;
+				char * dst;
+				if (size > kChunkSize / 4)
+				{
+					// big: a chunk of its own, keeps filling the current one
+					dst = new char[size];
+					mChunks.insert(mChunks.begin(), dst);
+				}
+				else
+				{
+					if (mChunkUsed + size > kChunkSize)
+					{
+						mChunks.push_back(new char[kChunkSize]);
+						mChunkUsed = 0;
+					}
+					dst = mChunks.back() + mChunkUsed;
+					mChunkUsed += size;
+				}
+				memcpy(dst, str, size);
+				mBytes += size;
+				return dst;
+			}
+		};
+
+		// function static: Rtti interns type names before main
+		template <typename THash>
+		StringTable<THash> & GetTable()
+		{
+			static StringTable<THash> sTable;
+			return sTable;
+		}
+	}
+
+	template <typename THash>
+	TStringId<THash> TStringId<THash>::Intern(const char * str)
+	{
+		if (!str)
+			str = "";
+		TStringId id(Hash(str));
+		StringTable<THash> & table = GetTable<THash>();
+		std::lock_guard<std::mutex> lock(table.mMutex);
+		typename AEX_HASH_MAP(THash, const char *)::iterator it = table.mStrings.find(id.mHash);
+		if (it == table.mStrings.end())
+		{
+			id.mString = table.Store(str);
+			table.mStrings[id.mHash] = id.mString;
+			return id;
+		}
+		if (strcmp(it->second, str) == 0)
+		{
+			id.mString = it->second;
+			return id;
+		}
+
+		// collision: the id keeps its own string, stored once
+		FOR_EACH(col, table.mCollisions)
+		{
+			if (strcmp(*col, str) == 0)
+			{
+				id.mString = *col;
+				return id;
+			}
+		}
+		DebugErrorIf(true, "StringId: \"%s\" and \"%s\" have the same hash", it->second, str);
+		id.mString = table.Store(str);
+		table.mCollisions.push_back(id.mString);
+		return id;
+	}
+
+	template <typename THash>
+	const char * TStringId<THash>::FindString(THash hash)
+	{
+		StringTable<THash> & table = GetTable<THash>();
+		std::lock_guard<std::mutex> lock(table.mMutex);
+		typename AEX_HASH_MAP(THash, const char *)::const_iterator it = table.mStrings.find(hash);
+		return it != table.mStrings.end() ? it->second : "<unknown>";
+	}
+
+	template <typename THash>
+	u32 TStringId<THash>::GetInternedCount()
+	{
+		StringTable<THash> & table = GetTable<THash>();
+		std::lock_guard<std::mutex> lock(table.mMutex);
+		return table.mStrings.size();
+	}
+	template <typename THash>
+	u32 TStringId<THash>::GetInternedBytes()
+	{
+		StringTable<THash> & table = GetTable<THash>();
+		std::lock_guard<std::mutex> lock(table.mMutex);
+		return table.mBytes;
+	}
+
+	template class TStringId<u32>;
+	template class TStringId<u64>;
+}
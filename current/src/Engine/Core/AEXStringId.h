@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXStringId.h
+// Purpose:	Interned strings identified by their hash
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_STRING_ID_H_
+#define AEX_STRING_ID_H_
+
+#include <cstring>
+#include <type_traits>
+#include "AEXDataTypes.h"
+
+namespace AEX
+{
+	namespace internal
+	{
+		// FNV-1a, usable at compile time on literals (C++11 constexpr).
+		constexpr u32 HashString32(const char * str, u32 hash = 2166136261u)
+		{
+			return *str == '\0' ? hash : HashString32(str + 1, (hash ^ (u8)*str) * 16777619u);
+		}
+		constexpr u64 HashString64(const char * str, u64 hash = 14695981039346656037ull)
+		{
+			return *str == '\0' ? hash : HashString64(str + 1, (hash ^ (u8)*str) * 1099511628211ull);
+		}
+
+		template <typename T> struct StringHasher;
+		template <> struct StringHasher<u32> { static constexpr u32 Hash(const char * str) { return HashString32(str); } };
+		template <> struct StringHasher<u64> { static constexpr u64 Hash(const char * str) { return HashString64(str); } };
+	}
+
+	// ----------------------------------------------------------------------------
+	// \class	TStringId
+	// \brief	A string stored as its hash: copies and compares like an integer.
+	//			Intern adds the string to an engine-wide table (one copy per
+	//			distinct string, never freed) so that GetString can give it back.
+	//
+	//	Interned ids keep a pointer to their string: GetString is free.
+	//	Ids made from a hash (AEX_SID in release, or the constructor) don't
+	//	touch the table: use them for lookups. Their GetString looks the
+	//	table up, and is only known if the same string was interned
+	//	somewhere, which AEX_SID does in debug builds.
+	//
+	//	Two strings with the same hash compare equal as ids. Intern reports
+	//	it when it sees it happen, and the second string keeps its own
+	//	GetString; lookups by string confirm it with Matches.
+	//
+	//	StringId (32 bits) for names, StringId64 where many keys live in the
+	//	same map (resources).
+	template <typename THash>
+	class TStringId
+	{
+	public:
+		static constexpr THash Hash(const char * str) { return internal::StringHasher<THash>::Hash(str); }
+
+		constexpr TStringId() : mHash(Hash("")), mString("") {}
+		constexpr explicit TStringId(THash hash) : mHash(hash), mString(NULL) {}
+
+		// thread safe
+		static TStringId Intern(const char * str);
+
+		THash GetHash() const { return mHash; }
+		bool IsEmpty() const { return mHash == Hash(""); }
+		bool IsInterned() const { return mString != NULL; }	// false: made from a hash
+
+		// the interned string, "" for the empty id. Ids that were never
+		// interned give "<unknown>".
+		const char * GetString() const { return mString ? mString : FindString(mHash); }
+
+		// same hash and same string: what the by-name lookups use
+		bool Matches(const char * str) const { return mHash == Hash(str) && strcmp(GetString(), str) == 0; }
+
+		bool operator==(const TStringId & other) const { return mHash == other.mHash; }
+		bool operator!=(const TStringId & other) const { return mHash != other.mHash; }
+		bool operator<(const TStringId & other) const { return mHash < other.mHash; }
+
+		// debug: number of interned strings and bytes used by them
+		static u32 GetInternedCount();
+		static u32 GetInternedBytes();
+
+	private:
+		static const char * FindString(THash hash);	// thread safe
+
+		THash			mHash;
+		const char *	mString;	// NULL: made from a hash, look the table up
+	};
+
+	typedef TStringId<u32> StringId;
+	typedef TStringId<u64> StringId64;
+}
+
+// Id of a string literal, hashed at compile time. Debug builds also intern
+// the literal so that the id can be printed.
+#ifdef _DEBUG
+	#define AEX_SID(literal)	(AEX::StringId::Intern(literal))
+	#define AEX_SID64(literal)	(AEX::StringId64::Intern(literal))
+#else
+	#define AEX_SID(literal)	(AEX::StringId(std::integral_constant<u32, AEX::StringId::Hash(literal)>::value))
+	#define AEX_SID64(literal)	(AEX::StringId64(std::integral_constant<u64, AEX::StringId64::Hash(literal)>::value))
+#endif
+
+// ----------------------------------------------------------------------------
+#endif
@@ -59,7 +59,7 @@ namespace AEX
 	}\
 	virtual AEX::ISystem* RetrieveInstance()\
 	{\
-		return dynamic_cast<AEX::ISystem*>(classname::Instance());\
+		return AEX::aex_cast<AEX::ISystem>(classname::Instance());\
 	}\
 	static void ReleaseInstance()\
 	{\
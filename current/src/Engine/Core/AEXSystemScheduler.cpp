@@ -0,0 +1,359 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXSystemScheduler.cpp
+// Purpose:	Runs the per-frame system updates as a dependency graph
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include "AEXSystemScheduler.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	namespace
+	{
+		f64 GetTime()
+		{
+			return std::chrono::duration<f64>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+		void InsertSorted(AEX_ARRAY(u32) & values, u32 value)
+		{
+			AEX_ARRAY(u32)::iterator it = std::lower_bound(values.begin(), values.end(), value);
+			if (it == values.end() || *it != value)
+				values.insert(it, value);
+		}
+		bool Intersects(const AEX_ARRAY(u32) & a, const AEX_ARRAY(u32) & b)
+		{
+			// both sorted
+			u32 i = 0, j = 0;
+			while (i < a.size() && j < b.size())
+			{
+				if (a[i] == b[j])
+					return true;
+				if (a[i] < b[j]) ++i;
+				else ++j;
+			}
+			return false;
+		}
+	}
+
+	struct SystemScheduler::Node
+	{
+		std::string				mName;
+		std::function<void()>	mUpdate;
+		bool					mbMainThread;
+		AEX_ARRAY(u32)			mDependencies;	// explicit, then from Build
+		AEX_ARRAY(u32)			mReads;			// sorted Rtti indices
+		AEX_ARRAY(u32)			mWrites;		// sorted Rtti indices
+		AEX_ARRAY(u32)			mSuccessors;	// from Build
+		u32						mExplicitCount;	// mDependencies[0, mExplicitCount) are explicit
+		std::atomic<u32>		mPending;		// dependencies not done this frame
+		f64						mStart;			// relative to the frame start
+		f64						mEnd;
+	};
+
+	const u32 SystemScheduler::kInvalidNode;
+
+	SystemScheduler::SystemScheduler()
+		: mbDirty(false)
+		, mCompleted(0)
+		, mFrameStart(0.0)
+		, mFrameTime(0.0)
+		, mCriticalPathTime(0.0)
+		, mFrameCount(0)
+		, mReportInterval(0)
+	{}
+	SystemScheduler::~SystemScheduler()
+	{
+		FOR_EACH(it, mNodes)
+			delete *it;
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// REGISTRATION
+
+	u32 SystemScheduler::AddSystem(ISystem * system, const char * name)
+	{
+		return AddTask(name ? name : system->GetType().GetName(), [system]() { system->Update(); });
+	}
+	u32 SystemScheduler::AddTask(const char * name, const std::function<void()> & update)
+	{
+		Node * node = new Node;
+		node->mName = name;
+		node->mUpdate = update;
+		node->mbMainThread = false;
+		node->mExplicitCount = 0;
+		node->mPending = 0;
+		node->mStart = node->mEnd = 0.0;
+		mNodes.push_back(node);
+		mbDirty = true;
+		return mNodes.size() - 1;
+	}
+	u32 SystemScheduler::FindNode(const char * name) const
+	{
+		for (u32 i = 0; i < mNodes.size(); ++i)
+			if (mNodes[i]->mName == name)
+				return i;
+		return kInvalidNode;
+	}
+	const char * SystemScheduler::GetNodeName(u32 node) const
+	{
+		return mNodes[node]->mName.c_str();
+	}
+
+	void SystemScheduler::AddDependency(u32 node, u32 dependsOn)
+	{
+		DebugAssert(node < mNodes.size() && dependsOn < mNodes.size(), "SystemScheduler: invalid node");
+		Node * n = mNodes[node];
+		n->mDependencies.resize(n->mExplicitCount); // drop the derived ones, Build redoes them
+		if (std::find(n->mDependencies.begin(), n->mDependencies.end(), dependsOn) == n->mDependencies.end())
+			n->mDependencies.push_back(dependsOn);
+		n->mExplicitCount = n->mDependencies.size();
+		mbDirty = true;
+	}
+	void SystemScheduler::SetMainThread(u32 node, bool mainThread)
+	{
+		mNodes[node]->mbMainThread = mainThread;
+	}
+	void SystemScheduler::Reads(u32 node, const Rtti & type)
+	{
+		InsertSorted(mNodes[node]->mReads, type.GetIndex());
+		mbDirty = true;
+	}
+	void SystemScheduler::Writes(u32 node, const Rtti & type)
+	{
+		InsertSorted(mNodes[node]->mWrites, type.GetIndex());
+		mbDirty = true;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// BUILD
+
+	bool SystemScheduler::HasPath(u32 from, u32 to) const
+	{
+		// dependencies point backwards: walk them from 'to'
+		AEX_ARRAY(u32) stack(1, to);
+		AEX_ARRAY(bool) visited(mNodes.size(), false);
+		while (!stack.empty())
+		{
+			u32 n = stack.back();
+			stack.pop_back();
+			if (n == from)
+				return true;
+			if (visited[n])
+				continue;
+			visited[n] = true;
+			FOR_EACH(dep, mNodes[n]->mDependencies)
+				stack.push_back(*dep);
+		}
+		return false;
+	}
+
+	bool SystemScheduler::Build()
+	{
+		// data access -> dependencies, in registration order. Skipped when the
+		// order is already implied, to keep the graph small.
+		FOR_EACH(it, mNodes)
+			(*it)->mDependencies.resize((*it)->mExplicitCount);
+		for (u32 j = 0; j < mNodes.size(); ++j)
+		{
+			Node * later = mNodes[j];
+			for (u32 i = j; i-- > 0;)
+			{
+				Node * earlier = mNodes[i];
+				bool conflict = Intersects(earlier->mWrites, later->mWrites)
+					|| Intersects(earlier->mWrites, later->mReads)
+					|| Intersects(earlier->mReads, later->mWrites);
+				if (conflict && !HasPath(i, j) && !HasPath(j, i))
+					later->mDependencies.push_back(i);
+			}
+		}
+
+		// successors and topological order (Kahn)
+		AEX_ARRAY(u32) pending(mNodes.size());
+		FOR_EACH(it, mNodes)
+			(*it)->mSuccessors.clear();
+		for (u32 n = 0; n < mNodes.size(); ++n)
+		{
+			pending[n] = mNodes[n]->mDependencies.size();
+			FOR_EACH(dep, mNodes[n]->mDependencies)
+				mNodes[*dep]->mSuccessors.push_back(n);
+		}
+		mOrder.clear();
+		for (u32 n = 0; n < mNodes.size(); ++n)
+			if (pending[n] == 0)
+				mOrder.push_back(n);
+		for (u32 i = 0; i < mOrder.size(); ++i)
+		{
+			FOR_EACH(succ, mNodes[mOrder[i]]->mSuccessors)
+				if (--pending[*succ] == 0)
+					mOrder.push_back(*succ);
+		}
+
+		mbDirty = false;
+		if (DebugErrorIf(mOrder.size() != mNodes.size(), "SystemScheduler: the dependencies have a cycle"))
+		{
+			mOrder.clear();
+			return false;
+		}
+		return true;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// RUN
+
+	void SystemScheduler::Run()
+	{
+		if (mbDirty && !Build())
+			return;
+		if (mOrder.empty())
+			return;
+
+		mFrameStart = GetTime();
+		JobSystem * jobs = aexJobSystem;
+		bool parallel = jobs->IsRunning() && jobs->GetThreadIndex() < jobs->GetThreadCount();
+		if (!parallel)
+		{
+			// no job system on this thread: topological order
+			FOR_EACH(it, mOrder)
+				RunNode(*it);
+		}
+		else
+		{
+			FOR_EACH(it, mNodes)
+				(*it)->mPending = (*it)->mDependencies.size();
+			mCompleted = 0;
+			mMainQueue.clear();
+
+			// roots
+			CompleteNode(kInvalidNode);
+
+			// main thread: run the main thread nodes, help with the others
+			while (mCompleted.load(std::memory_order_acquire) < mNodes.size())
+			{
+				u32 node = kInvalidNode;
+				{
+					std::lock_guard<std::mutex> lock(mMainQueueMutex);
+					if (!mMainQueue.empty())
+					{
+						node = mMainQueue.back();
+						mMainQueue.pop_back();
+					}
+				}
+				if (node != kInvalidNode)
+				{
+					RunNode(node);
+					CompleteNode(node);
+				}
+				else if (!jobs->ExecuteOne())
+					std::this_thread::yield();
+			}
+		}
+		mFrameTime = GetTime() - mFrameStart;
+
+		UpdateCriticalPath();
+		if (mReportInterval && ++mFrameCount % mReportInterval == 0)
+			PrintCriticalPath();
+	}
+
+	void SystemScheduler::RunNode(u32 node)
+	{
+		Node * n = mNodes[node];
+		n->mStart = GetTime() - mFrameStart;
+		n->mUpdate();
+		n->mEnd = GetTime() - mFrameStart;
+	}
+
+	// node done (kInvalidNode to start the frame): starts the successors that
+	// have nothing left to wait for.
+	void SystemScheduler::CompleteNode(u32 node)
+	{
+		const AEX_ARRAY(u32) * ready = NULL;
+		AEX_ARRAY(u32) roots;
+		if (node == kInvalidNode)
+		{
+			for (u32 n = 0; n < mNodes.size(); ++n)
+				if (mNodes[n]->mDependencies.empty())
+					roots.push_back(n);
+			ready = &roots;
+		}
+		else
+			ready = &mNodes[node]->mSuccessors;
+
+		FOR_EACH(it, *ready)
+		{
+			u32 succ = *it;
+			Node * n = mNodes[succ];
+			if (node != kInvalidNode && n->mPending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				continue;
+
+			if (n->mbMainThread)
+			{
+				std::lock_guard<std::mutex> lock(mMainQueueMutex);
+				mMainQueue.push_back(succ);
+			}
+			else
+			{
+				SystemScheduler * self = this;
+				aexJobSystem->Run(aexJobSystem->CreateJob([self, succ]()
+				{
+					self->RunNode(succ);
+					self->CompleteNode(succ);
+				}));
+			}
+		}
+
+		if (node != kInvalidNode)
+			mCompleted.fetch_add(1, std::memory_order_release);
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// CRITICAL PATH
+
+	f64 SystemScheduler::GetNodeTime(u32 node) const
+	{
+		return mNodes[node]->mEnd - mNodes[node]->mStart;
+	}
+
+	// longest chain of node times through the dependencies
+	void SystemScheduler::UpdateCriticalPath()
+	{
+		AEX_ARRAY(f64) pathTime(mNodes.size(), 0.0);
+		AEX_ARRAY(u32) pathPrev(mNodes.size(), kInvalidNode);
+		u32 last = kInvalidNode;
+		FOR_EACH(it, mOrder)
+		{
+			u32 n = *it;
+			FOR_EACH(dep, mNodes[n]->mDependencies)
+			{
+				if (pathTime[*dep] > pathTime[n] || pathPrev[n] == kInvalidNode)
+				{
+					pathTime[n] = pathTime[*dep];
+					pathPrev[n] = *dep;
+				}
+			}
+			pathTime[n] += GetNodeTime(n);
+			if (last == kInvalidNode || pathTime[n] > pathTime[last])
+				last = n;
+		}
+
+		mCriticalPath.clear();
+		mCriticalPathTime = last != kInvalidNode ? pathTime[last] : 0.0;
+		for (u32 n = last; n != kInvalidNode; n = pathPrev[n])
+			mCriticalPath.push_back(n);
+		std::reverse(mCriticalPath.begin(), mCriticalPath.end());
+	}
+	void SystemScheduler::PrintCriticalPath() const
+	{
+		DebugPrint("Frame %.3f ms, critical path %.3f ms:", mFrameTime * 1000.0, mCriticalPathTime * 1000.0);
+		FOR_EACH(it, mCriticalPath)
+			DebugPrint(" %s (%.3f ms)%s", GetNodeName(*it), GetNodeTime(*it) * 1000.0,
+				it + 1 != mCriticalPath.end() ? " ->" : "\n");
+	}
+	#pragma endregion
+}
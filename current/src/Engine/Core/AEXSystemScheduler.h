@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXSystemScheduler.h
+// Purpose:	Runs the per-frame system updates as a dependency graph
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_SYSTEM_SCHEDULER_H_
+#define AEX_SYSTEM_SCHEDULER_H_
+
+#include <functional>
+#include "AEXJobSystem.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	SystemScheduler
+	// \brief	Graph of the work done each frame. A node is a system Update (or
+	//			any function) with:
+	//			- explicit dependencies: runs after the given nodes.
+	//			- data access: the Rtti types it reads and writes. A node that
+	//			  writes a type runs after the nodes registered before it that
+	//			  read or write that type, and the other way around.
+	//			- main thread: for work tied to the OS window or the GL context.
+	//
+	//	The graph is sorted once (Build, called by Run when nodes changed).
+	//	Run then starts each node as soon as its dependencies are done: nodes
+	//	on the job system, main thread nodes on the calling thread, which also
+	//	executes jobs while it waits.
+	//
+	//	Critical path: the chain of dependent nodes with the longest total time
+	//	in the last frame, i.e. the nodes to optimize to shorten the frame.
+	class SystemScheduler
+	{
+	public:
+		static const u32 kInvalidNode = 0xFFFFFFFF;
+
+		SystemScheduler();
+		~SystemScheduler();
+
+		// ------------------------------------------------------------------------
+		// registration
+		u32 AddSystem(ISystem * system, const char * name = NULL);	// calls system->Update()
+		u32 AddTask(const char * name, const std::function<void()> & update);
+		u32 FindNode(const char * name) const;
+		u32 GetNodeCount() const { return mNodes.size(); }
+		const char * GetNodeName(u32 node) const;
+
+		void AddDependency(u32 node, u32 dependsOn);
+		void SetMainThread(u32 node, bool mainThread = true);
+		template <typename T> void Reads(u32 node)	{ Reads(node, T::TYPE()); }
+		template <typename T> void Writes(u32 node)	{ Writes(node, T::TYPE()); }
+		void Reads(u32 node, const Rtti & type);
+		void Writes(u32 node, const Rtti & type);
+
+		// sorts the graph, asserts on cycles.
+		bool Build();
+
+		// runs one frame, returns when every node is done.
+		void Run();
+
+		// ------------------------------------------------------------------------
+		// timings of the last frame, in seconds
+		f64 GetNodeTime(u32 node) const;
+		f64 GetFrameTime() const { return mFrameTime; }
+		const AEX_ARRAY(u32) & GetCriticalPath() const { return mCriticalPath; }
+		f64 GetCriticalPathTime() const { return mCriticalPathTime; }
+		void PrintCriticalPath() const;		// through DebugPrint
+
+		// prints the critical path every 'frames' frames, 0 disables it.
+		void SetReportInterval(u32 frames) { mReportInterval = frames; }
+
+	private:
+		struct Node;
+
+		bool HasPath(u32 from, u32 to) const;
+		void RunNode(u32 node);
+		void CompleteNode(u32 node);
+		void UpdateCriticalPath();
+
+		AEX_PTR_ARRAY(Node)		mNodes;
+		AEX_ARRAY(u32)			mOrder;			// topological order, from Build
+		bool					mbDirty;
+
+		// per frame
+		std::atomic<u32>		mCompleted;
+		std::mutex				mMainQueueMutex;
+		AEX_ARRAY(u32)			mMainQueue;		// main thread nodes ready to run
+		f64						mFrameStart;
+		f64						mFrameTime;
+
+		AEX_ARRAY(u32)			mCriticalPath;
+		f64						mCriticalPathTime;
+		u32						mFrameCount;
+		u32						mReportInterval;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
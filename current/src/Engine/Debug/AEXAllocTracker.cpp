@@ -0,0 +1,485 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXAllocTracker.cpp
+// Purpose:	Opt-in allocation tracking: per frame counts, live allocations
+//			by call site and by type
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include "AEXAllocTracker.h"
+#include "MyDebug.h"
+
+#if defined(AEX_ALLOC_TRACKING) && defined(_WIN32)
+	#include <Windows.h>	// RtlCaptureStackBackTrace
+	#include <intrin.h>		// _ReturnAddress
+#endif
+
+namespace AEX
+{
+	namespace
+	{
+		// Everything here is used from inside operator new: fixed size,
+		// zero initialized, no constructors and nothing that allocates.
+		const u32 kMaxThreads = 128;
+		const u32 kSiteCount = 4096;		// power of two
+		const u32 kTypeCount = 1024;		// power of two
+		const u32 kMaxProbes = 32;
+		const u32 kNone = 0xFFFFFFFF;
+
+		// one per thread, only written by its thread
+		struct ThreadCounters
+		{
+			std::atomic<u64> mAllocCount;
+			std::atomic<u64> mAllocBytes;
+			std::atomic<u64> mFreeCount;
+			std::atomic<u64> mFreeBytes;
+		};
+
+		struct SiteEntry
+		{
+			std::atomic<u64>	mKey;		// 0: free
+			std::atomic<void*>	mAddress;
+			std::atomic<u32>	mTypeId;
+			std::atomic<s64>	mLiveBytes;
+			std::atomic<s64>	mLiveCount;
+			std::atomic<u64>	mTotalCount;
+			u64					mFrameStart;	// NewFrame only
+			u64					mLastFrame;
+		};
+
+		struct TypeEntry
+		{
+			std::atomic<u32>	mKey;		// 0: free
+			std::atomic<s64>	mLiveBytes;
+			std::atomic<s64>	mLiveCount;
+			std::atomic<u64>	mTotalCount;
+		};
+
+		struct Tracker
+		{
+			std::atomic<bool>	mEnabled;
+			std::atomic<u32>	mThreadCount;
+			ThreadCounters		mThreads[kMaxThreads];
+			SiteEntry			mSites[kSiteCount + 1];	// last: <other>
+			TypeEntry			mTypes[kTypeCount + 1];	// last: <other>
+
+			// NewFrame only
+			AllocCounters		mFrameStart;
+			AllocCounters		mLastFrame;
+			bool				mHasBudget;
+			u32					mFrameBudget;
+			u32					mBudgetViolations;
+		};
+
+		// zero initialized before any code runs, never destroyed: allocations
+		// are tracked from static init to static destruction.
+		Tracker gTracker;
+		thread_local u32 tThreadIndex = kNone;
+		thread_local u32 tTypeScope = 0;
+
+		inline u64 Mix64(u64 k)
+		{
+			k ^= k >> 33;
+			k *= 0xff51afd7ed558ccdull;
+			k ^= k >> 33;
+			k *= 0xc4ceb9fe1a85ec53ull;
+			k ^= k >> 33;
+			return k;
+		}
+
+		ThreadCounters & GetThreadCounters()
+		{
+			// threads past the limit share the last counters
+			if (tThreadIndex == kNone)
+			{
+				u32 index = gTracker.mThreadCount.fetch_add(1, std::memory_order_relaxed);
+				tThreadIndex = index < kMaxThreads ? index : kMaxThreads - 1;
+			}
+			return gTracker.mThreads[tThreadIndex];
+		}
+
+		// open addressing, keys are never removed
+		u32 FindSite(u64 key, void * address, u32 typeId)
+		{
+			for (u32 i = 0; i < kMaxProbes; ++i)
+			{
+				u32 index = u32(key + i) & (kSiteCount - 1);
+				SiteEntry & entry = gTracker.mSites[index];
+				u64 current = entry.mKey.load(std::memory_order_acquire);
+				if (current == 0)
+				{
+					if (entry.mKey.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+					{
+						entry.mAddress.store(address, std::memory_order_relaxed);
+						entry.mTypeId.store(typeId, std::memory_order_relaxed);
+						return index;
+					}
+					// lost the race: current holds the new key
+				}
+				if (current == key)
+					return index;
+			}
+			return kSiteCount;
+		}
+		u32 FindType(u32 typeId)
+		{
+			u32 hash = u32(Mix64(typeId));
+			for (u32 i = 0; i < kMaxProbes; ++i)
+			{
+				u32 index = (hash + i) & (kTypeCount - 1);
+				TypeEntry & entry = gTracker.mTypes[index];
+				u32 current = entry.mKey.load(std::memory_order_acquire);
+				if (current == 0 && entry.mKey.compare_exchange_strong(current, typeId, std::memory_order_acq_rel))
+					return index;
+				if (current == typeId)
+					return index;
+			}
+			return kTypeCount;
+		}
+
+		void CountAlloc(u64 size)
+		{
+			ThreadCounters & counters = GetThreadCounters();
+			counters.mAllocCount.fetch_add(1, std::memory_order_relaxed);
+			counters.mAllocBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+		void CountFree(u64 size)
+		{
+			ThreadCounters & counters = GetThreadCounters();
+			counters.mFreeCount.fetch_add(1, std::memory_order_relaxed);
+			counters.mFreeBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+		void AddToType(u32 index, s64 size, s64 count)
+		{
+			TypeEntry & entry = gTracker.mTypes[index];
+			entry.mLiveBytes.fetch_add(size, std::memory_order_relaxed);
+			entry.mLiveCount.fetch_add(count, std::memory_order_relaxed);
+			if (count > 0)
+				entry.mTotalCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		void AddToSite(u32 index, s64 size, s64 count)
+		{
+			SiteEntry & entry = gTracker.mSites[index];
+			entry.mLiveBytes.fetch_add(size, std::memory_order_relaxed);
+			entry.mLiveCount.fetch_add(count, std::memory_order_relaxed);
+			if (count > 0)
+				entry.mTotalCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		const char * GetTypeName(u32 typeId)
+		{
+			return typeId == 0 ? "" : StringId(typeId).GetString();
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// GLOBAL NEW/DELETE
+
+#ifdef AEX_ALLOC_TRACKING
+	namespace
+	{
+		// in front of every block from the global operator new. 16 bytes
+		// keep the alignment of malloc.
+		struct BlockHeader
+		{
+			u32 mSize;
+			u32 mSite;		// kNone: not tracked (tracking was off)
+			u32 mType;		// kNone: no type scope
+			u32 mMagic;
+		};
+		const u32 kMagic = 0xA11CA7ED;
+
+	#ifdef _MSC_VER
+		#define AEX_NOINLINE		__declspec(noinline)
+		#define AEX_RETURN_ADDRESS()	_ReturnAddress()
+	#else
+		#define AEX_NOINLINE		__attribute__((noinline))
+		#define AEX_RETURN_ADDRESS()	__builtin_return_address(0)
+	#endif
+
+		// hash of the callers' stack. Skips itself, TrackedNew and operator new.
+		AEX_NOINLINE u64 CaptureSite(void * caller)
+		{
+			u64 hash = Mix64((u64)(size_t)caller);
+		#ifdef _WIN32
+			void * frames[8];
+			USHORT count = RtlCaptureStackBackTrace(3, 8, frames, NULL);
+			for (USHORT i = 0; i < count; ++i)
+				hash = Mix64(hash ^ (u64)(size_t)frames[i]);
+		#endif
+			return hash ? hash : 1;
+		}
+
+		// caller: return address of operator new
+		AEX_NOINLINE void * TrackedNew(size_t size, void * caller, bool nothrow)
+		{
+			if (size == 0)
+				size = 1;
+			BlockHeader * header = static_cast<BlockHeader*>(malloc(size + sizeof(BlockHeader)));
+			if (!header)
+			{
+				if (nothrow)
+					return NULL;
+				throw std::bad_alloc();
+			}
+			header->mSize = u32(size);
+			header->mSite = kNone;
+			header->mType = kNone;
+			header->mMagic = kMagic;
+
+			if (gTracker.mEnabled.load(std::memory_order_relaxed))
+			{
+				header->mSite = FindSite(CaptureSite(caller), caller, tTypeScope);
+				AddToSite(header->mSite, size, 1);
+				if (tTypeScope)
+				{
+					header->mType = FindType(tTypeScope);
+					AddToType(header->mType, size, 1);
+				}
+				CountAlloc(size);
+			}
+			return header + 1;
+		}
+
+		void TrackedDelete(void * ptr)
+		{
+			if (!ptr)
+				return;
+			BlockHeader * header = static_cast<BlockHeader*>(ptr) - 1;
+			DebugErrorIf(header->mMagic != kMagic, "AllocTracker: delete of a block that was not allocated with new");
+
+			// counted even if tracking was turned off since: keeps the live
+			// values right
+			if (header->mSite != kNone)
+			{
+				AddToSite(header->mSite, -s64(header->mSize), -1);
+				if (header->mType != kNone)
+					AddToType(header->mType, -s64(header->mSize), -1);
+				CountFree(header->mSize);
+			}
+			header->mMagic = 0;
+			free(header);
+		}
+	}
+#endif
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// ALLOC TRACKER
+
+	const u32 AllocTracker::kNoBudget;
+
+	bool AllocTracker::IsHookingGlobalNew()
+	{
+	#ifdef AEX_ALLOC_TRACKING
+		return true;
+	#else
+		return false;
+	#endif
+	}
+	void AllocTracker::SetEnabled(bool enabled)
+	{
+		// the first frame counted starts now, not at the last NewFrame
+		if (enabled && !IsEnabled())
+		{
+			gTracker.mFrameStart = GetTotals();
+			for (u32 i = 0; i <= kSiteCount; ++i)
+				gTracker.mSites[i].mFrameStart = gTracker.mSites[i].mTotalCount.load(std::memory_order_relaxed);
+		}
+		gTracker.mEnabled.store(enabled, std::memory_order_relaxed);
+	}
+	bool AllocTracker::IsEnabled()
+	{
+		return gTracker.mEnabled.load(std::memory_order_relaxed);
+	}
+
+	AllocCounters AllocTracker::GetTotals()
+	{
+		AllocCounters totals = { 0, 0, 0, 0 };
+		u32 threadCount = std::min(gTracker.mThreadCount.load(std::memory_order_relaxed), kMaxThreads);
+		for (u32 i = 0; i < threadCount; ++i)
+		{
+			ThreadCounters & counters = gTracker.mThreads[i];
+			totals.mAllocCount += counters.mAllocCount.load(std::memory_order_relaxed);
+			totals.mAllocBytes += counters.mAllocBytes.load(std::memory_order_relaxed);
+			totals.mFreeCount += counters.mFreeCount.load(std::memory_order_relaxed);
+			totals.mFreeBytes += counters.mFreeBytes.load(std::memory_order_relaxed);
+		}
+		return totals;
+	}
+	AllocCounters AllocTracker::GetLastFrame()
+	{
+		return gTracker.mLastFrame;
+	}
+
+	void AllocTracker::SetFrameAllocBudget(u32 maxAllocs)
+	{
+		gTracker.mHasBudget = maxAllocs != kNoBudget;
+		gTracker.mFrameBudget = maxAllocs;
+	}
+	u32 AllocTracker::GetBudgetViolations()
+	{
+		return gTracker.mBudgetViolations;
+	}
+
+	void AllocTracker::NewFrame()
+	{
+		if (!IsEnabled())
+			return;
+
+		AllocCounters totals = GetTotals();
+		AllocCounters & start = gTracker.mFrameStart;
+		AllocCounters & last = gTracker.mLastFrame;
+		last.mAllocCount = totals.mAllocCount - start.mAllocCount;
+		last.mAllocBytes = totals.mAllocBytes - start.mAllocBytes;
+		last.mFreeCount = totals.mFreeCount - start.mFreeCount;
+		last.mFreeBytes = totals.mFreeBytes - start.mFreeBytes;
+		start = totals;
+
+		for (u32 i = 0; i <= kSiteCount; ++i)
+		{
+			SiteEntry & entry = gTracker.mSites[i];
+			u64 total = entry.mTotalCount.load(std::memory_order_relaxed);
+			entry.mLastFrame = total - entry.mFrameStart;
+			entry.mFrameStart = total;
+		}
+
+		if (gTracker.mHasBudget && last.mAllocCount > gTracker.mFrameBudget)
+		{
+			if (gTracker.mBudgetViolations++ == 0)
+			{
+				DebugErrorIf(true, "AllocTracker: %llu allocations (%llu bytes) last frame, the budget is %u. See the log for the sites.",
+					last.mAllocCount, last.mAllocBytes, gTracker.mFrameBudget);
+			}
+			MyPrintFunction("AllocTracker: %llu allocations (%llu bytes) last frame, budget %u\n",
+				last.mAllocCount, last.mAllocBytes, gTracker.mFrameBudget);
+			for (u32 i = 0; i <= kSiteCount; ++i)
+			{
+				SiteEntry & entry = gTracker.mSites[i];
+				if (entry.mLastFrame)
+					MyPrintFunction("    %6llu allocations from %p %s\n", entry.mLastFrame,
+						entry.mAddress.load(std::memory_order_relaxed), GetTypeName(entry.mTypeId.load(std::memory_order_relaxed)));
+			}
+		}
+	}
+
+	void AllocTracker::GetTopSites(AEX_ARRAY(AllocSiteStats) & out, u32 maxCount)
+	{
+		out.clear();
+		for (u32 i = 0; i <= kSiteCount; ++i)
+		{
+			SiteEntry & entry = gTracker.mSites[i];
+			if (i < kSiteCount && entry.mKey.load(std::memory_order_acquire) == 0)
+				continue;
+			AllocSiteStats stats;
+			stats.mSite = i < kSiteCount ? entry.mKey.load(std::memory_order_relaxed) : 0;
+			stats.mAddress = entry.mAddress.load(std::memory_order_relaxed);
+			stats.mTypeId = entry.mTypeId.load(std::memory_order_relaxed);
+			stats.mLiveBytes = entry.mLiveBytes.load(std::memory_order_relaxed);
+			stats.mLiveCount = entry.mLiveCount.load(std::memory_order_relaxed);
+			stats.mTotalCount = entry.mTotalCount.load(std::memory_order_relaxed);
+			stats.mLastFrameCount = entry.mLastFrame;
+			if (stats.mTotalCount)
+				out.push_back(stats);
+		}
+		std::sort(out.begin(), out.end(), [](const AllocSiteStats & a, const AllocSiteStats & b) { return a.mLiveBytes > b.mLiveBytes; });
+		if (out.size() > maxCount)
+			out.resize(maxCount);
+	}
+
+	void AllocTracker::GetTopTypes(AEX_ARRAY(AllocTypeStats) & out, u32 maxCount)
+	{
+		out.clear();
+		for (u32 i = 0; i <= kTypeCount; ++i)
+		{
+			TypeEntry & entry = gTracker.mTypes[i];
+			if (i < kTypeCount && entry.mKey.load(std::memory_order_acquire) == 0)
+				continue;
+			AllocTypeStats stats;
+			stats.mTypeId = i < kTypeCount ? entry.mKey.load(std::memory_order_relaxed) : 0;
+			stats.mLiveBytes = entry.mLiveBytes.load(std::memory_order_relaxed);
+			stats.mLiveCount = entry.mLiveCount.load(std::memory_order_relaxed);
+			stats.mTotalCount = entry.mTotalCount.load(std::memory_order_relaxed);
+			if (stats.mTotalCount)
+				out.push_back(stats);
+		}
+		std::sort(out.begin(), out.end(), [](const AllocTypeStats & a, const AllocTypeStats & b) { return a.mLiveBytes > b.mLiveBytes; });
+		if (out.size() > maxCount)
+			out.resize(maxCount);
+	}
+
+	void AllocTracker::Report(u32 maxLines)
+	{
+		AllocCounters totals = GetTotals();
+		MyPrintFunction("AllocTracker: %llu allocations (%llu bytes), %llu frees (%llu bytes), %lld bytes live\n",
+			totals.mAllocCount, totals.mAllocBytes, totals.mFreeCount, totals.mFreeBytes,
+			s64(totals.mAllocBytes - totals.mFreeBytes));
+
+		AEX_ARRAY(AllocTypeStats) types;
+		GetTopTypes(types, maxLines);
+		MyPrintFunction("%-40s %12s %10s %10s\n", "Type", "Live bytes", "Live", "Total");
+		FOR_EACH(it, types)
+		{
+			MyPrintFunction("%-40s %12lld %10lld %10llu\n", it->mTypeId ? GetTypeName(it->mTypeId) : "<other>",
+				it->mLiveBytes, it->mLiveCount, it->mTotalCount);
+		}
+
+		if (!IsHookingGlobalNew())
+			return;
+		AEX_ARRAY(AllocSiteStats) sites;
+		GetTopSites(sites, maxLines);
+		MyPrintFunction("%-18s %-16s %-30s %12s %10s %10s\n", "Site", "Address", "Type", "Live bytes", "Live", "Total");
+		FOR_EACH(it, sites)
+		{
+			MyPrintFunction("%016llx   %-16p %-30s %12lld %10lld %10llu\n", it->mSite, it->mAddress, GetTypeName(it->mTypeId),
+				it->mLiveBytes, it->mLiveCount, it->mTotalCount);
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	AllocTracker::TypeScope::TypeScope(StringId type)
+		: mPrevious(tTypeScope)
+	{
+		tTypeScope = type.GetHash();
+	}
+	AllocTracker::TypeScope::~TypeScope()
+	{
+		tTypeScope = mPrevious;
+	}
+
+	// ----------------------------------------------------------------------------
+	// counted even while tracking is off: a free doesn't know whether its
+	// allocation was counted (no header here), the live values must stay right
+	void AllocTracker::OnTypedAlloc(u32 typeId, u64 size)
+	{
+		AddToType(FindType(typeId), size, 1);
+		CountAlloc(size);
+	}
+	void AllocTracker::OnTypedFree(u32 typeId, u64 size)
+	{
+		AddToType(FindType(typeId), -s64(size), -1);
+		CountFree(size);
+	}
+	#pragma endregion
+}
+
+// ----------------------------------------------------------------------------
+#pragma region// OPERATOR NEW/DELETE
+
+#ifdef AEX_ALLOC_TRACKING
+void * operator new(size_t size)										{ return AEX::TrackedNew(size, AEX_RETURN_ADDRESS(), false); }
+void * operator new[](size_t size)										{ return AEX::TrackedNew(size, AEX_RETURN_ADDRESS(), false); }
+void * operator new(size_t size, const std::nothrow_t &) noexcept		{ return AEX::TrackedNew(size, AEX_RETURN_ADDRESS(), true); }
+void * operator new[](size_t size, const std::nothrow_t &) noexcept		{ return AEX::TrackedNew(size, AEX_RETURN_ADDRESS(), true); }
+void operator delete(void * ptr) noexcept								{ AEX::TrackedDelete(ptr); }
+void operator delete[](void * ptr) noexcept								{ AEX::TrackedDelete(ptr); }
+void operator delete(void * ptr, const std::nothrow_t &) noexcept		{ AEX::TrackedDelete(ptr); }
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept		{ AEX::TrackedDelete(ptr); }
+void operator delete(void * ptr, size_t) noexcept						{ AEX::TrackedDelete(ptr); }
+void operator delete[](void * ptr, size_t) noexcept						{ AEX::TrackedDelete(ptr); }
+#endif
+#pragma endregion
@@ -0,0 +1,113 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXAllocTracker.h
+// Purpose:	Opt-in allocation tracking: per frame counts, live allocations
+//			by call site and by type
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_ALLOC_TRACKER_H_
+#define AEX_ALLOC_TRACKER_H_
+
+#include "..\Core\AEXStringId.h"
+#include "..\Utilities\AEXContainers.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// totals, or deltas of a frame
+	struct AllocCounters
+	{
+		u64 mAllocCount;
+		u64 mAllocBytes;
+		u64 mFreeCount;
+		u64 mFreeBytes;
+	};
+
+	// live allocations made from one call site (global new only)
+	struct AllocSiteStats
+	{
+		u64		mSite;			// hash of the call stack
+		void *	mAddress;		// first return address outside operator new
+		u32		mTypeId;		// type scope of the first allocation, 0 if none
+		s64		mLiveBytes;
+		s64		mLiveCount;
+		u64		mTotalCount;	// allocations since the start
+		u64		mLastFrameCount;
+	};
+
+	// live allocations of one type: pools, TypeScope, EngineAllocator tags
+	struct AllocTypeStats
+	{
+		u32		mTypeId;		// StringId hash of the type name
+		s64		mLiveBytes;
+		s64		mLiveCount;
+		u64		mTotalCount;
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	AllocTracker
+	// \brief	Counts allocations per frame and keeps the live bytes per call
+	//			site and per type, to find who holds memory and to enforce
+	//			frames that don't allocate.
+	//
+	//	Off by default: SetEnabled(true) turns on the frame counts, the budget
+	//	and the global new tracking. The engine allocator and the component
+	//	pools always report to it (a few relaxed atomics), so their live
+	//	values are right whenever it is turned on or off. Global operator
+	//	new/delete are only hooked when the engine is built with
+	//	AEX_ALLOC_TRACKING defined: every block then gets a 16 bytes header
+	//	and its call stack is hashed, which is slow.
+	//
+	//	Lock-free: the counters are per thread, the site and type tables are
+	//	fixed size and filled with atomic operations. Sites and types past the
+	//	table capacity are counted in an "<other>" entry.
+	class AllocTracker
+	{
+	public:
+		static const u32 kNoBudget = 0xFFFFFFFF;
+
+		static bool IsHookingGlobalNew();	// built with AEX_ALLOC_TRACKING
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled();
+
+		// ------------------------------------------------------------------------
+		// stats
+		static AllocCounters GetTotals();
+		static AllocCounters GetLastFrame();	// last complete frame
+		static void NewFrame();					// called by FRC::StartFrame
+
+		// Frames that allocate more than this raise an error (the first time)
+		// and log the sites that allocated. 0 once the game is in a steady
+		// state: loading done, pools warm. kNoBudget turns it off.
+		static void SetFrameAllocBudget(u32 maxAllocs = 0);
+		static u32 GetBudgetViolations();
+
+		// by live bytes, biggest first, at most maxCount
+		static void GetTopSites(AEX_ARRAY(AllocSiteStats) & out, u32 maxCount);
+		static void GetTopTypes(AEX_ARRAY(AllocTypeStats) & out, u32 maxCount);
+
+		// ranked report of the live allocations. Printed in release builds too
+		// (MyPrintFunction: stdout and the debugger output).
+		static void Report(u32 maxLines = 20);
+
+		// ------------------------------------------------------------------------
+		// Global new made while a scope is alive (on this thread) are counted
+		// under its type, as are the sites they come from.
+		struct TypeScope
+		{
+			TypeScope(StringId type);
+			~TypeScope();
+			u32 mPrevious;
+		};
+
+		// ------------------------------------------------------------------------
+		// hooks
+		static void OnTypedAlloc(u32 typeId, u64 size);		// pools, engine allocator. Enabled or not
+		static void OnTypedFree(u32 typeId, u64 size);
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
@@ -10,6 +10,7 @@
 #include "..\Platform\AEXWindow.h"		// Window
 #include "..\Debug\MyDebug.h"			// Debug
 #include "..\Debug\CheckGLError.h"		// Debug OpenGL
+#include "..\Debug\AEXAllocTracker.h"	// Allocation tracking
 #include "..\Platform\AEXFilePath.h"		// File path
 #include "AEXGraphics.h"				// ALL GRAPHICS
 
@@ -309,21 +310,21 @@ namespace AEX
 	//		{
 	//			if ((*renderIt)->mIsVisible && (*renderIt)->IsEnabled())
 	//			{
-	//				if ((*renderIt)->pShaderRes)
+	//				if ((*renderIt)->GetShader())
 	//				{
-	//					(*renderIt)->pShaderRes->Bind();
-	//					(*renderIt)->pShaderRes->SetShaderUniform("mtxViewProj", &MVP);
+	//					(*renderIt)->GetShader()->Bind();
+	//					(*renderIt)->GetShader()->SetShaderUniform("mtxViewProj", &MVP);
 	//				}
 	//				(*renderIt)->Render();
 	//			}
 	//		}
 
 	//		// Draw the debug lines (once per camera)
-	//		if (mLineRenderer->pShaderRes)
+	//		if (mLineRenderer->GetShader())
 	//		{
 	//			// set debug drawer shader data
-	//			mLineRenderer->pShaderRes->Bind();
-	//			mLineRenderer->pShaderRes->SetShaderUniform("mtxViewProj", &MVP);
+	//			mLineRenderer->GetShader()->Bind();
+	//			mLineRenderer->GetShader()->SetShaderUniform("mtxViewProj", &MVP);
 	//			// render line renderer contents
 	//			mLineRenderer->Render();
 	//		}
@@ -468,70 +469,63 @@ namespace AEX
 	}
 	#pragma region Resource Management 
 	// ------------------------------------------------------------------------
-	AEX_PTR_DICTIONARY(Shader) sShaders;
-	AEX_PTR_DICTIONARY(ShaderProgram) sShaderProgs;
-	AEX_PTR_DICTIONARY(Texture) sTextures;
-	AEX_PTR_DICTIONARY(Model) sModels;
-	AEX_DICTIONARY(void*) sResources;
+	// keyed by StringId64 of the resource name: lookups hash the name, no
+	// string is built or compared.
+	typedef AEX_HASH_MAP(u64, void*) ResourceMap;
+	ResourceMap sShaders;
+	ResourceMap sShaderProgs;
+	ResourceMap sTextures;
+	ResourceMap sModels;
+	AEX_HASH_MAP(u32, ResourceMap*) sResources;	// Rtti id -> resource map
+
 	template <typename T>
-	T* AddResource(T* res, const char * resName = NULL)
+	ResourceMap * GetResourceMap()
 	{
 		// FIRST CALL - THIS IS A HACK (LAZY INIT)
 		// This can also be done pre-main.
 		if (sResources.empty())
 		{
-			sResources[Shader::TYPE().GetName()] = (void*)&sShaders;
-			sResources[ShaderProgram::TYPE().GetName()] = (void*)&sShaderProgs;
-			sResources[Texture::TYPE().GetName()] = (void*)&sTextures;
-			sResources[Model::TYPE().GetName()] = (void*)&sModels;
+			sResources[Shader::TYPE().GetId()] = &sShaders;
+			sResources[ShaderProgram::TYPE().GetId()] = &sShaderProgs;
+			sResources[Texture::TYPE().GetId()] = &sTextures;
+			sResources[Model::TYPE().GetId()] = &sModels;
 		}
+		AEX_HASH_MAP(u32, ResourceMap*)::iterator it = sResources.find(T::TYPE().GetId());
+		return it != sResources.end() ? it->second : NULL;
+	}
 
-		// cast to base! Note: C++ rtti will make sure that res is base. 
-		IBase * res_base = dynamic_cast<IBase*>(res);
+	template <typename T>
+	T* AddResource(T* res, const char * resName = NULL)
+	{
+		// cast to base! Note: the engine rtti will make sure that res is base. 
+		IBase * res_base = aex_cast<IBase>(res);
 
 		// name
 		if (NULL == resName)
 			resName = res_base->GetName();
-		
-		// typedef for resource map type
-		typedef AEX_PTR_DICTIONARY(T) RM_TYPE;
 
 		// find resourceMap and add the resource
-		AEX_DICTIONARY(void*)::iterator it = sResources.find(T::TYPE().GetName());
-		if (it != sResources.end())
-		{
-			//  cast the resMap
-			RM_TYPE* resMap = (RM_TYPE*)(it->second);
-
-			//@sanity check
-			DebugErrorIf(resMap == NULL, "ERROR");
-			
-			// add the resource
-			if (resMap)
-			{
-				(*resMap)[resName] = res;
-			}
-		}
+		ResourceMap * resMap = GetResourceMap<T>();
+
+		//@sanity check
+		DebugErrorIf(resMap == NULL, "ERROR");
+
+		// add the resource
+		if (resMap)
+			(*resMap)[StringId64::Intern(resName).GetHash()] = res;
 		return res;
 	}
 
 	template <typename T>
-	T * GetResouce(const char * resName)
+	T * GetResouce(StringId64 resName)
 	{
-		// typedef for resource map type
-		typedef AEX_PTR_DICTIONARY(T) RM_TYPE;
-
-		// find resourceMap and add the resource
-		AEX_DICTIONARY(void*)::iterator it = sResources.find(T::TYPE().GetName());
-		if (it != sResources.end())
+		// return the resource it exist
+		ResourceMap * resMap = GetResourceMap<T>();
+		if (resMap)
 		{
-			//  cast the resMap
-			RM_TYPE* resMap = (RM_TYPE*)(it->second);
-
-			// return the resource it exist
-			if (resMap && (*resMap).find(resName) != (*resMap).end()){
-				return (*resMap)[resName];
-			}
+			ResourceMap::iterator it = resMap->find(resName.GetHash());
+			if (it != resMap->end())
+				return static_cast<T*>(it->second);
 		}
 		// return null otherwise
 		return NULL;
@@ -544,22 +538,9 @@ namespace AEX
 		if (NULL == res)
 			return;
 
-		// typedef for resource map type
-		typedef AEX_PTR_DICTIONARY(T) RM_TYPE;
-
-		// find resourceMap and add the resource
-		AEX_DICTIONARY(void*)::iterator it = sResources.find(T::TYPE().GetName());
-		if (it != sResources.end())
-		{
-			//  cast the resMap
-			RM_TYPE* resMap = (RM_TYPE*)(it->second);
-
-			// return the resource it exist
-			RM_TYPE::iterator resourceIt = (*resMap).find(res->GetName());
-			if (resMap && resourceIt != (*resMap).end()){
-				resMap->erase(resourceIt);
-			}
-		}
+		ResourceMap * resMap = GetResourceMap<T>();
+		if (resMap)
+			resMap->erase(StringId64::Hash(res->GetName()));
 	}
 
 	ShaderProgram * Graphics::LoadShaderProgram(const char * shaderFile, Shader* pix, Shader * vert)
@@ -575,6 +556,7 @@ namespace AEX
 	}
 	Texture *		Graphics::LoadTexture(const char * textureFile)
 	{
+		AllocTracker::TypeScope allocScope(Texture::TYPE().GetNameId());
 		FilePath fp(textureFile);
 		std::string resName = fp.mFilename + fp.mExtension;
 		Texture * tex = new Texture(); tex->SetName(resName.c_str());
@@ -585,6 +567,7 @@ namespace AEX
 	}
 	Model *			Graphics::LoadModel(const char * modelFile)
 	{
+		AllocTracker::TypeScope allocScope(Model::TYPE().GetNameId());
 		FilePath fp(modelFile);
 		std::string modelName = fp.mFilename + fp.mExtension;
 		Model * pModel = new Model(); pModel->SetName(modelName.c_str());
@@ -629,21 +612,21 @@ namespace AEX
 		return AddResource<Shader>(pShader);
 	}
 
-	Shader*			Graphics::GetShader(const char * shaderName)
+	Shader*			Graphics::GetShader(StringId64 shaderName)
 	{
 		return GetResouce<Shader>(shaderName);
 	}
-	ShaderProgram * Graphics::GetShaderProgram(const char * shaderProgName)
+	ShaderProgram * Graphics::GetShaderProgram(StringId64 shaderProgName)
 	{
 		return GetResouce<ShaderProgram>(shaderProgName);
 
 	}
-	Texture *		Graphics::GetTexture(const char * textureName)
+	Texture *		Graphics::GetTexture(StringId64 textureName)
 	{
 		return GetResouce<Texture>(textureName);
 
 	}
-	Model *			Graphics::GetModel(const char * modelName)
+	Model *			Graphics::GetModel(StringId64 modelName)
 	{
 		return GetResouce<Model>(modelName);
 
@@ -693,17 +676,17 @@ namespace AEX
 	}
 	void			Graphics::DeleteTexture(const char * texName)
 	{
-		DeleteModel(GetModel(texName));
+		DeleteTexture(GetTexture(texName));
 
 	}
 	void			Graphics::DeleteShader(const char * shaderName)
 	{
-		DeleteModel(GetModel(shaderName));
+		DeleteShader(GetShader(shaderName));
 
 	}
 	void			Graphics::DeleteShaderProgram(const char * progName)
 	{
-		DeleteModel(GetModel(progName));
+		DeleteShaderProgram(GetShaderProgram(progName));
 
 	}
 	#pragma endregion
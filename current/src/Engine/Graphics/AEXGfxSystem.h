@@ -9,9 +9,7 @@
 // ---------------------------------------------------------------------------
 // INCLUDES & DEPENDENCIES
 #include "..\Core\AEXCore.h"
-#include <aexmath\AEXMathDefs.h>	// TWO_PI
-#include <aexmath\AEXVec2.h>	// TWO_PI
-#include <aexmath\AEXVec3.h>	// TWO_PI
+#include <aexmath\AEXMath.h>	// TWO_PI, AEVec2, AEVec3
 #include "AEXColor.h"		// Color
 
 #pragma warning (disable:4251) // dll and STL
@@ -66,10 +64,15 @@ namespace AEX
 		Shader *		LoadShader(const char * shaderFile);
 		ShaderProgram * LoadShaderProgram(const char * shaderFile, Shader* pix, Shader * vert);
 
-		Model *			GetModel(const char * modelName);
-		Texture *		GetTexture(const char * textureName);
-		Shader*			GetShader(const char * shaderName);
-		ShaderProgram * GetShaderProgram(const char * shaderName);
+		// by name, or by AEX_SID64("name") to skip hashing at run time
+		Model *			GetModel(StringId64 modelName);
+		Texture *		GetTexture(StringId64 textureName);
+		Shader*			GetShader(StringId64 shaderName);
+		ShaderProgram * GetShaderProgram(StringId64 shaderName);
+		Model *			GetModel(const char * modelName)			{ return GetModel(StringId64(StringId64::Hash(modelName))); }
+		Texture *		GetTexture(const char * textureName)		{ return GetTexture(StringId64(StringId64::Hash(textureName))); }
+		Shader*			GetShader(const char * shaderName)			{ return GetShader(StringId64(StringId64::Hash(shaderName))); }
+		ShaderProgram * GetShaderProgram(const char * shaderName)	{ return GetShaderProgram(StringId64(StringId64::Hash(shaderName))); }
 
 		void			DeleteModel(Model * model);
 		void			DeleteTexture(Texture * tex);
@@ -208,18 +208,16 @@ namespace AEX
 		// Specify how the data for the vertices is layed out
 		UploadVertexFormatToGPU();
 
-		// compute index dataand upload to GL device
+		// compute index dataand upload to GL device. Load time temporary: not
+		// from the frame arena, which would keep the size of the biggest model.
 		u32	indexBufferSize = mVertices.size();
-		u16 *indexBufferData = new u16[indexBufferSize];
+		AEX_TAGGED_ARRAY(u16, eMT_Graphics) indexBufferData(indexBufferSize);
 		for (u32 i = 0; i < indexBufferSize; ++i)
 			indexBufferData[i] = i;
 
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u16) * indexBufferSize, reinterpret_cast<void*>(indexBufferData), GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u16) * indexBufferSize, reinterpret_cast<void*>(indexBufferData.data()), GL_STATIC_DRAW);
 		check_gl_error();
 
-		// delete the index buffer data now that we've sent it to the GPU
-		delete[] indexBufferData;
-
 		// Unbind
 		Unbind();
 	}
@@ -401,49 +399,24 @@ namespace AEX
 	/// \param	mtx Matrix to transform the model by.
 	Model Model::Transform(AEMtx33 & mtx)const
 	{
-		// Create a transformed Model into view
+		// Create a transformed Model into view: copy the vertices, then
+		// transform all the positions in one batch
 		Model newModel;
 		newModel.mPrimitiveType = mPrimitiveType;
 		newModel.mDrawMode = mDrawMode;
-		for (u32 i = 0; i < GetVertexCount(); ++i)
-		{
-			// get the current vertex
-			const Vertex * pVertex = GetVertex(i);
-
-			// transform the position of the vertex
-			Vertex vPrime = *pVertex;
-			AEMtx33MultVec(&vPrime.mPosition, &mtx, &vPrime.mPosition);
-
-			// Add to the transformed model
-			newModel.AddVertex(vPrime);
-		}
+		newModel.mVertices = mVertices;
+		if (!newModel.mVertices.empty())
+			AEMtx33MultVecStrided(&newModel.mVertices[0].mPosition, sizeof(Vertex), &mtx, newModel.GetVertexCount());
 		return newModel;
 	}
 
-	// TODO
 	///--------------------------------------------------------------------
 	/// \fn		Transform
 	/// \brief	Transforms the model by the given matrix
 	/// \param	mtx Matrix to transform the model by.
 	Model Model::Transform(AEMtx33 & mtx)
 	{
-		// Create a transformed Model into view
-		Model newModel;
-		newModel.mPrimitiveType = mPrimitiveType;
-		newModel.mDrawMode = mDrawMode;
-		for (u32 i = 0; i < GetVertexCount(); ++i)
-		{
-			// get the current vertex
-			const Vertex * pVertex = GetVertex(i);
-
-			// transform the position of the vertex
-			Vertex vPrime = *pVertex;
-			AEMtx33MultVec(&vPrime.mPosition, &mtx, &vPrime.mPosition);
-
-			// Add to the transformed model
-			newModel.AddVertex(vPrime);
-		}
-		return newModel;
+		return static_cast<const Model *>(this)->Transform(mtx);
 	}
 
 }// namespace Rasterizer
\ No newline at end of file
@@ -142,7 +142,7 @@ namespace AEX
 		// Note(Thomas): The format of the vertex is set. 
 		// Unless your game requires mesh manipulation 
 		// or advanced shading. This Vertex is more than enough.
-		std::vector<Vertex> mVertices;
+		AEX_TAGGED_ARRAY(Vertex, eMT_Graphics) mVertices;
 
 		// Draw mode
 		EDrawMode				mDrawMode;
@@ -10,6 +10,7 @@
 #include "AEXGL.h"
 #include "..\Debug\MyDebug.h"
 #include "..\Debug\CheckGLError.h"
+#include "..\Utilities\AEXAllocator.h"
 
 // image loading library
 #define STB_IMAGE_IMPLEMENTATION
@@ -30,9 +31,15 @@ namespace AEX
 	Texture::Texture(u32 width, u32 height, u8*pixels)
 		: mWidth(width)
 		, mHeight(height)
-		, mPixels(pixels)
+		, mPixels(NULL)
 		, mGLHandle(0)
 	{
+		// copied: the texture owns its (tagged) pixel buffer
+		if (pixels)
+		{
+			mPixels = static_cast<u8*>(EngineAllocator::Allocate(width * height * 4, eMT_Resources));
+			memcpy(mPixels, pixels, width * height * 4);
+		}
 		CreateOpenGLTexture();
 	}
 	Texture::Texture(const char * filename)
@@ -120,7 +127,7 @@ namespace AEX
 	void Texture::FreeData()
 	{
 		if (mPixels) {
-			delete[] mPixels;
+			EngineAllocator::Free(mPixels, mWidth * mHeight * 4, eMT_Resources);
 			mPixels = NULL;
 		}
 	}
@@ -155,8 +162,8 @@ namespace AEX
 		outWidth = (u32)x;
 		outHeight = (u32)y;
 
-		// allocate memory for our image
-		outPixels = new u8[outWidth * outHeight * reqComp];
+		// allocate memory for our image (free with EngineAllocator::Free, eMT_Resources)
+		outPixels = static_cast<u8*>(EngineAllocator::Allocate(outWidth * outHeight * reqComp, eMT_Resources));
 
 		// copy the data but flip the height to match openGL
 		for (u32 i = 0; i < outHeight; ++i)
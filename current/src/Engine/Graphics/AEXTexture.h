@@ -34,7 +34,7 @@ namespace AEX
 
 		// constructor
 		Texture();
-		Texture(u32 width, u32 height, u8*pixels = NULL);
+		Texture(u32 width, u32 height, u8*pixels = NULL);	// copies the pixels
 		Texture(const char * filename);
 
 		// Destructor
@@ -58,6 +58,7 @@ namespace AEX
 
 
 	// External Image loading // works with PNG, JPG and TGA
+	// outPixels is allocated with EngineAllocator (eMT_Resources, 4 bytes per pixel)
 	bool LoadImageFromFile(const char * filename, u8 *& outPixels, u32 & outWidth, u32 & outHeight);
 }
 //-----------------------------------------------------------------------------
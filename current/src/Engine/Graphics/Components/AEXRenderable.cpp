@@ -2,6 +2,7 @@
 #include "..\AEXGraphics.h"
 #include "..\..\Composition\AEXGameObject.h"
 #include "..\..\Scene\AEXTransformComp.h"
+#include "..\..\Scene\AEXTransformStorage.h"
 #include "..\..\Debug\MyDebug.h"
 #include "..\AEXGL.h"
 
@@ -12,22 +13,13 @@ namespace AEX
 	// ---------------------------------------------------------------------------
 	Renderable::Renderable()
 		: mIsVisible(true)
-		, pTransform(NULL)
-		, pTransform3D(NULL)
-		, pShaderRes(NULL)
-		, pModelRes(NULL)
-		, pTextureRes(NULL)
-		, pSamplerRes(NULL)
 	{}
 	Renderable::~Renderable()
 	{}
 	void Renderable::Initialize()
 	{
 		if (GetOwner())
-		{
-			pTransform = GetOwner()->GetComp<TransformComp>();
-			pTransform3D = GetOwner()->GetComp<TransformComp3D>();
-		}
+			Reset();
 		// Add self to graphics system. TODO(Thomas): Implement this in the next lesson
 		//Graphics::Instance()->AddRenderable(this);
 	}
@@ -36,47 +28,57 @@ namespace AEX
 		// Add self to graphics system. TODO(Thomas): Implement this in the next lesson
 		//Graphics::Instance()->RemoveRenderable(this);
 	}
+	void Renderable::Reset()
+	{
+		TransformComp * transform = GetOwner()->GetComp<TransformComp>();
+		TransformComp3D * transform3D = GetOwner()->GetComp<TransformComp3D>();
+		mTransform = transform ? transform->GetHandle() : CompHandle();
+		mTransform3D = transform3D ? transform3D->GetHandle() : CompHandle();
+	}
 
 	void Renderable::Render()
 	{
-		DebugAssert(pModelRes != NULL, "Renderable: Model resource is NULL");
+		const RenderableResources & res = mResources.Get();
+		DebugAssert(res.pModelRes != NULL, "Renderable: Model resource is NULL");
 
 		// Bind Resources
 		{
 			// Set Texture to current
-			if (pTextureRes)
+			if (res.pTextureRes)
 			{
-				pTextureRes->Bind();
+				res.pTextureRes->Bind();
 
 				// bind the sampler if one is set
-				if (pSamplerRes)
-					pSamplerRes->BindToTextureUnit(0);
+				if (res.pSamplerRes)
+					res.pSamplerRes->BindToTextureUnit(0);
 			}
 
 			// Send data to shader
-			if (pShaderRes)
+			if (res.pShaderRes)
 			{
-				// Compute model and send to shader
-				AEMtx44 mtxModel = AEMtx44::Identity();
-				if (pTransform3D)
-					mtxModel = pTransform3D->GetModelToWorld();
-				else
-					mtxModel = pTransform->GetModelToWorld4x4();
+				// model matrix, cached by the transform, or built this frame
+				// by TransformStorage::Update for the stored roots. Sent every
+				// time: the shader and its uniforms are shared with other objects
+				TransformComp * pTransform = GetTransform();
+				TransformComp3D * pTransform3D = GetTransform3D();
+				const AEMtx44 & mtxModel = pTransform3D ? pTransform3D->GetModelToWorld()
+					: pTransform->IsStored() && !pTransform->IsInHierarchy() ? aexTransformStorage->GetModelMatrix(pTransform->GetStorageSlot())
+					: pTransform->GetModelToWorld4x4();
 
-				pShaderRes->Bind();
+				res.pShaderRes->Bind();
 				check_gl_error();
-				pShaderRes->SetShaderUniform("mtxModel", &mtxModel);
+				res.pShaderRes->SetShaderUniform("mtxModel", &mtxModel);
 				check_gl_error();
 
 				// Texture unit
 				int texUnit = 0;
-				pShaderRes->SetShaderUniform("ts_diffuse", &texUnit);
+				res.pShaderRes->SetShaderUniform("ts_diffuse", &texUnit);
 				check_gl_error();
 			}
 		}
 
 		// Draw Model
-		pModelRes->Draw();
+		res.pModelRes->Draw();
 	}
 	bool Renderable::IsVisible()
 	{
@@ -88,11 +90,11 @@ namespace AEX
 	}
 	TransformComp * Renderable::GetTransform()
 	{
-		return pTransform;
+		return static_cast<TransformComp*>(IComp::Get(mTransform));
 	}
 	TransformComp3D * Renderable::GetTransform3D()
 	{
-		return pTransform3D;
+		return static_cast<TransformComp3D*>(IComp::Get(mTransform3D));
 	}
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 // ----------------------------------------------------------------------------
 
 #include "..\..\Composition\AEXComponent.h"
+#include "..\..\Composition\AEXSharedData.h"
 namespace AEX
 {
 	class TransformComp;
@@ -13,12 +14,29 @@ namespace AEX
 	class Texture;
 	class TextureSampler;
 
+	// ---------------------------------------------------------------------------
+	// STRUCT:	RenderableResources
+	// PURPOSE:	What a renderable draws with. Usually the same for thousands of
+	//			instances: Renderables share it (see SharedData).
+	struct RenderableResources
+	{
+		RenderableResources() : pShaderRes(NULL), pModelRes(NULL), pTextureRes(NULL), pSamplerRes(NULL) {}
+
+		ShaderProgram	*pShaderRes;
+		Model			*pModelRes;
+		Texture			*pTextureRes;
+		TextureSampler	*pSamplerRes;
+	};
+
 	// ---------------------------------------------------------------------------
 	// CLASS:	Renderable:
 	// PURPOSE:	A renderable is any object that can be processed by the rendering
 	//			pipeline. Most importantly, it can be culled by the camera.
 	//			Note: The renderable needs to have a transform
-	class Renderable : IComp
+	//			The resources are shared: copies of a renderable (prefab
+	//			instances) point to the same RenderableResources until one of
+	//			them sets a resource, which gives it its own copy.
+	class Renderable : public IComp
 	{
 		AEX_RTTI_DECL(Renderable, IComp);
 	public:
@@ -28,6 +46,7 @@ namespace AEX
 		virtual ~Renderable();
 		virtual void Initialize();
 		virtual void Shutdown();
+		virtual void Reset();		// the transforms have new handles
 		virtual void Render();
 
 		bool IsVisible();
@@ -35,16 +54,26 @@ namespace AEX
 		TransformComp * GetTransform();
 		TransformComp3D * GetTransform3D();
 
-		ShaderProgram	*pShaderRes;
-		Model			*pModelRes;
-		Texture			*pTextureRes;
-		TextureSampler	*pSamplerRes;
+		// Resources
+		ShaderProgram * GetShader() const		{ return mResources->pShaderRes; }
+		Model * GetModel() const				{ return mResources->pModelRes; }
+		Texture * GetTexture() const			{ return mResources->pTextureRes; }
+		TextureSampler * GetSampler() const		{ return mResources->pSamplerRes; }
+		void SetShader(ShaderProgram * shader)		{ if (shader != GetShader()) mResources.Edit().pShaderRes = shader; }
+		void SetModel(Model * model)				{ if (model != GetModel()) mResources.Edit().pModelRes = model; }
+		void SetTexture(Texture * texture)			{ if (texture != GetTexture()) mResources.Edit().pTextureRes = texture; }
+		void SetSampler(TextureSampler * sampler)	{ if (sampler != GetSampler()) mResources.Edit().pSamplerRes = sampler; }
+
+		// share another renderable's resources (or a block made once for many)
+		const SharedData<RenderableResources> & GetResources() const { return mResources; }
+		void SetResources(const SharedData<RenderableResources> & resources) { mResources = resources; }
 
 	protected:
 		friend class Graphics;
 		bool			mIsVisible;
-		TransformComp	*pTransform;
-		TransformComp3D	*pTransform3D;
+		CompHandle		mTransform;		// handles: the transform can move (ArchetypeStorage chunks)
+		CompHandle		mTransform3D;
+		SharedData<RenderableResources> mResources;
 	};
 }
 
@@ -1,41 +1,400 @@
+#include <algorithm>
 #include "AEXLogic.h"
+#include "..\Composition\AEXGameObject.h"
+#include "..\Debug\MyDebug.h"
 
 namespace AEX
 {
+	//-------------------------------------------------------------------------
+	#pragma region // Logic Access
+
+	namespace
+	{
+		void InsertSorted(AEX_ARRAY(u32) & values, u32 value)
+		{
+			AEX_ARRAY(u32)::iterator it = std::lower_bound(values.begin(), values.end(), value);
+			if (it == values.end() || *it != value)
+				values.insert(it, value);
+		}
+		bool Intersects(const AEX_ARRAY(u32) & a, const AEX_ARRAY(u32) & b)
+		{
+			// both sorted
+			u32 i = 0, j = 0;
+			while (i < a.size() && j < b.size())
+			{
+				if (a[i] == b[j])
+					return true;
+				if (a[i] < b[j]) ++i;
+				else ++j;
+			}
+			return false;
+		}
+	}
+
+	LogicAccess::LogicAccess() : mbDeclared(false) {}
+
+	LogicAccess & LogicAccess::Read(const Rtti & type)
+	{
+		InsertSorted(mReads, type.GetIndex());
+		mbDeclared = true;
+		return *this;
+	}
+	LogicAccess & LogicAccess::Write(const Rtti & type)
+	{
+		InsertSorted(mWrites, type.GetIndex());
+		mbDeclared = true;
+		return *this;
+	}
+	bool LogicAccess::IsRead(const Rtti & type) const
+	{
+		return std::binary_search(mReads.begin(), mReads.end(), type.GetIndex());
+	}
+	bool LogicAccess::IsWritten(const Rtti & type) const
+	{
+		return std::binary_search(mWrites.begin(), mWrites.end(), type.GetIndex());
+	}
+	bool LogicAccess::ConflictsWith(const LogicAccess & other) const
+	{
+		return Intersects(mWrites, other.mWrites)
+			|| Intersects(mWrites, other.mReads)
+			|| Intersects(mReads, other.mWrites);
+	}
+	#pragma endregion
+
 	//-------------------------------------------------------------------------
 	#pragma region // Base Logic Component
 
-	LogicComp::LogicComp() : IComp() {}
+	LogicComp::LogicComp()
+		: IComp()
+		, mLogicGroup(Logic::kInvalidIndex)
+		, mLogicSlot(Logic::kInvalidIndex)
+		, mbInitialized(false)
+	{}
 	void LogicComp::Initialize() {
-		Logic::Instance()->AddComp(this);
+		mbInitialized = true;
+		if (IsEnabled())
+			Logic::Instance()->AddComp(this);
 	}
 	void LogicComp::Shutdown() {
+		// freed when this returns, while its Update is still running
+		DebugAssert(Logic::Instance()->GetUpdatingComp() != this,
+			"%s removed or destroyed itself from its Update. Use aexCommands.", GetType().GetName());
+		mbInitialized = false;
 		Logic::Instance()->RemoveComp(this);
 	}
+	void LogicComp::SetEnabled(bool enabled) {
+		IComp::SetEnabled(enabled);
+		if (!enabled)
+			Logic::Instance()->RemoveComp(this);
+		else if (mbInitialized)
+			Logic::Instance()->AddComp(this);
+	}
 	#pragma endregion
 
 	//-------------------------------------------------------------------------
 	#pragma region // Logic System
-	Logic::Logic() {}
+	const u32 Logic::kInvalidIndex;
+	const u32 Logic::kBatchSize;
+
+	Logic::Logic()
+		: mbPhasesDirty(false)
+		, mCompCount(0)
+		, mbInParallelUpdate(false)
+		, mbAccessCheck(false)
+		, mbParallel(true)
+		, mUpdatingGroup(kInvalidIndex)
+		, mpUpdatingComp(NULL)
+		, mbHoles(false)
+	{}
 
 	void Logic::Update()
 	{
-		FOR_EACH(comp, mComps)
-			/*TODO:if((*comp)->Enabled())*/
-			(*comp)->Update();
+		if (mbPhasesDirty)
+			BuildPhases();
+
+		// indices, not iterators: serial components may add or remove logic
+		// components from their Update. New types start updating next frame.
+		for (u32 p = 0; p < mPhases.size(); ++p)
+		{
+			const LogicPhase & phase = mPhases[p];
+			if (phase.mbParallel && mbAccessCheck)
+			{
+				FOR_EACH(g, phase.mGroups)
+					UpdateGroupChecked(*g);
+			}
+			else if (phase.mbParallel && mbParallel)
+				UpdatePhaseParallel(phase);
+			else
+			{
+				FOR_EACH(g, phase.mGroups)
+					UpdateGroup(*g);
+			}
+		}
+	}
+
+	void Logic::BeginGroupUpdate(u32 group)
+	{
+		mUpdatingGroup = group;
+		mbHoles = false;
+	}
+	void Logic::EndGroupUpdate()
+	{
+		u32 group = mUpdatingGroup;
+		mUpdatingGroup = kInvalidIndex;
+		mpUpdatingComp = NULL;
+		if (!mbHoles)
+			return;
+
+		// in order: the components keep their update order
+		AEX_TAGGED_PTR_ARRAY(LogicComp, eMT_Logic) & comps = mGroups[group].mComps;
+		u32 count = 0;
+		for (u32 i = 0; i < comps.size(); ++i)
+		{
+			if (!comps[i])
+				continue;
+			comps[i]->mLogicSlot = count;
+			comps[count++] = comps[i];
+		}
+		comps.resize(count);
+		mbHoles = false;
+	}
+
+	void Logic::UpdateGroup(u32 group)
+	{
+		// indices: components added meanwhile are appended and updated too
+		BeginGroupUpdate(group);
+		for (u32 i = 0; i < mGroups[group].mComps.size(); ++i)
+		{
+			LogicComp * comp = mGroups[group].mComps[i];
+			if (!comp)
+				continue;	// removed this frame
+			mpUpdatingComp = comp;
+			comp->Update();	// disabled components aren't registered
+		}
+		EndGroupUpdate();
+	}
+
+	void Logic::UpdatePhaseParallel(const LogicPhase & phase)
+	{
+		// split every group of the phase in batches
+		mBatches.clear();
+		FOR_EACH(g, phase.mGroups)
+		{
+			u32 count = mGroups[*g].mComps.size();
+			for (u32 begin = 0; begin < count; begin += kBatchSize)
+			{
+				LogicBatch batch = { *g, begin, std::min(begin + kBatchSize, count) };
+				mBatches.push_back(batch);
+			}
+		}
+
+		mbInParallelUpdate = true;
+		aexJobSystem->ParallelFor(mBatches.size(), 1, [this](u32 begin, u32 end)
+		{
+			for (u32 b = begin; b < end; ++b)
+			{
+				const LogicBatch & batch = mBatches[b];
+				AEX_TAGGED_PTR_ARRAY(LogicComp, eMT_Logic) & comps = mGroups[batch.mGroup].mComps;
+				for (u32 c = batch.mBegin; c < batch.mEnd; ++c)
+					comps[c]->Update();
+			}
+		});
+		mbInParallelUpdate = false;
+	}
+
+	// Sorts the groups in phases. Each group goes in the earliest phase after
+	// the last phase it conflicts with, so conflicting groups still run in
+	// registration order.
+	void Logic::BuildPhases()
+	{
+		mPhases.clear();
+		for (u32 g = 0; g < mGroups.size(); ++g)
+		{
+			const LogicAccess & access = mGroups[g].mAccess;
+
+			// undeclared -> serial phase of its own
+			if (!access.IsDeclared())
+			{
+				LogicPhase phase;
+				phase.mGroups.push_back(g);
+				phase.mbParallel = false;
+				mPhases.push_back(phase);
+				continue;
+			}
+
+			u32 first = mPhases.size();
+			while (first > 0)
+			{
+				const LogicPhase & prev = mPhases[first - 1];
+				bool conflict = !prev.mbParallel;
+				for (u32 i = 0; i < prev.mGroups.size() && !conflict; ++i)
+					conflict = access.ConflictsWith(mGroups[prev.mGroups[i]].mAccess);
+				if (conflict)
+					break;
+				--first;
+			}
+
+			if (first == mPhases.size())
+			{
+				LogicPhase phase;
+				phase.mbParallel = true;
+				mPhases.push_back(phase);
+			}
+			mPhases[first].mGroups.push_back(g);
+		}
+		mbPhasesDirty = false;
+	}
+
+	// ----------------------------------------------------------------------------
+	// Access check: hashes every component of the objects Logic knows about,
+	// updates one component, and reports the components that changed but that
+	// the component wasn't allowed to write.
+	namespace
+	{
+		u32 HashComp(IComp * comp)
+		{
+			const u8 * bytes = reinterpret_cast<const u8*>(comp);
+			u32 hash = 2166136261u;
+			for (u32 i = 0; i < comp->GetType().GetSize(); ++i)
+				hash = (hash ^ bytes[i]) * 16777619u;
+			return hash;
+		}
+	}
+	void Logic::UpdateGroupChecked(u32 group)
+	{
+		LogicGroup & logicGroup = mGroups[group];
+		if (logicGroup.mComps.empty())
+			return;
+		LogicComp * checked = logicGroup.mComps[logicGroup.mCheckCursor++ % logicGroup.mComps.size()];
+		CompHandle checkedHandle = checked->GetHandle();
+
+		// update the whole group in order, serially. The updates before the
+		// checked component can destroy objects: everything is gathered just
+		// before it, and read back through handles after it.
+		std::vector<std::pair<CompHandle, u32> > before;
+		BeginGroupUpdate(group);
+		for (u32 i = 0; i < mGroups[group].mComps.size(); ++i)
+		{
+			LogicComp * comp = mGroups[group].mComps[i];
+			if (!comp)
+				continue;
+			mpUpdatingComp = comp;
+			if (comp != checked)
+			{
+				comp->Update();
+				continue;
+			}
+
+			// the objects Logic can see (the holes are the components removed this frame)
+			GameObject * checkedOwner = checked->GetOwner();
+			std::vector<GameObject *> objects;
+			FOR_EACH(g, mGroups)
+				FOR_EACH(other, g->mComps)
+					if (*other && (*other)->GetOwner())
+						objects.push_back((*other)->GetOwner());
+			std::sort(objects.begin(), objects.end());
+			objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+			// hash everything the checked component must not write
+			FOR_EACH(obj, objects)
+			{
+				FOR_EACH(other, (*obj)->GetComps())
+				{
+					bool allowed = *other == checked ||
+						(*obj == checkedOwner && mGroups[group].mAccess.IsWritten((*other)->GetType()));
+					if (!allowed)
+						before.push_back(std::make_pair((*other)->GetHandle(), HashComp(*other)));
+				}
+			}
+
+			comp->Update();
+
+			// destroyed by its own update: nothing left to compare
+			if (!IComp::Get(checkedHandle))
+				continue;
+			FOR_EACH(it, before)
+			{
+				IComp * written = IComp::Get(it->first);
+				if (!written)
+					continue;
+				DebugErrorIf(HashComp(written) != it->second,
+					"Logic access check: %s on \"%s\" wrote %s on \"%s\" without declaring it.",
+					checked->GetType().GetName(), checkedOwner ? checkedOwner->GetName() : "",
+					written->GetType().GetName(), written->GetOwner() ? written->GetOwner()->GetName() : "");
+			}
+		}
+		EndGroupUpdate();
 	}
 
 	// component management
-	void Logic::AddComp(IComp * logicComp) {
-		mComps.remove(logicComp); // no duplicates
-		mComps.push_back(logicComp);
+	void Logic::AddComp(LogicComp * logicComp) {
+		DebugAssert(!mbInParallelUpdate, "Logic::AddComp called from a parallel logic update.");
+		if (logicComp->mLogicGroup != kInvalidIndex) // no duplicates
+			return;
+
+		// find the group of this concrete type, create it if needed
+		u32 typeIndex = logicComp->GetType().GetIndex();
+		if (typeIndex >= mGroupByType.size())
+			mGroupByType.resize(typeIndex + 1, kInvalidIndex);
+		if (mGroupByType[typeIndex] == kInvalidIndex)
+		{
+			mGroupByType[typeIndex] = mGroups.size();
+			mGroups.push_back(LogicGroup());
+			LogicGroup & group = mGroups.back();
+			group.mType = &logicComp->GetType();
+			group.mCheckCursor = 0;
+
+			// the type always writes itself
+			logicComp->DeclareAccess(group.mAccess);
+			if (group.mAccess.IsDeclared())
+				group.mAccess.Write(*group.mType);
+			mbPhasesDirty = true;
+		}
+
+		// append
+		LogicGroup & group = mGroups[mGroupByType[typeIndex]];
+		logicComp->mLogicGroup = mGroupByType[typeIndex];
+		logicComp->mLogicSlot = group.mComps.size();
+		group.mComps.push_back(logicComp);
+		++mCompCount;
 	}
-	void Logic::RemoveComp(IComp * logicComp) {
-		mComps.remove(logicComp);
+	void Logic::RemoveComp(LogicComp * logicComp) {
+		DebugAssert(!mbInParallelUpdate, "Logic::RemoveComp called from a parallel logic update.");
+		if (logicComp->mLogicGroup == kInvalidIndex) // not registered
+			return;
+
+		AEX_TAGGED_PTR_ARRAY(LogicComp, eMT_Logic) & comps = mGroups[logicComp->mLogicGroup].mComps;
+		if (logicComp->mLogicGroup == mUpdatingGroup)
+		{
+			// the group is being iterated: a hole, closed by EndGroupUpdate
+			comps[logicComp->mLogicSlot] = NULL;
+			mbHoles = true;
+		}
+		else
+		{
+			// swap-remove: the last component takes the freed slot
+			LogicComp * last = comps.back();
+			comps[logicComp->mLogicSlot] = last;
+			last->mLogicSlot = logicComp->mLogicSlot;
+			comps.pop_back();
+		}
+
+		logicComp->mLogicGroup = kInvalidIndex;
+		logicComp->mLogicSlot = kInvalidIndex;
+		--mCompCount;
 	}
 	void Logic::ClearComps() {
-		mComps.clear();
+		FOR_EACH(group, mGroups)
+		{
+			FOR_EACH(comp, group->mComps)
+			{
+				(*comp)->mLogicGroup = kInvalidIndex;
+				(*comp)->mLogicSlot = kInvalidIndex;
+			}
+			group->mComps.clear();
+		}
+		mCompCount = 0;
 	}
 
 	#pragma endregion
-}
\ No newline at end of file
+}
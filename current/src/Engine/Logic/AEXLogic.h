@@ -4,28 +4,146 @@
 
 namespace AEX
 {
+	// ----------------------------------------------------------------------------
+	// \class	LogicAccess
+	// \brief	Component types a logic component type reads and writes on its
+	//			owner while updating. Filled by LogicComp::DeclareAccess. The
+	//			declaring type itself is always written.
+	class LogicAccess
+	{
+	public:
+		LogicAccess();
+
+		template <typename T> LogicAccess & Read()	{ return Read(T::TYPE()); }
+		template <typename T> LogicAccess & Write()	{ return Write(T::TYPE()); }
+		LogicAccess & Read(const Rtti & type);
+		LogicAccess & Write(const Rtti & type);
+
+		// false until Read or Write is called: the type then runs serially.
+		bool IsDeclared() const { return mbDeclared; }
+		bool IsRead(const Rtti & type) const;
+		bool IsWritten(const Rtti & type) const;
+
+		// true if one side writes a type the other side reads or writes.
+		bool ConflictsWith(const LogicAccess & other) const;
+
+	private:
+		AEX_ARRAY(u32)	mReads;		// sorted Rtti indices
+		AEX_ARRAY(u32)	mWrites;	// sorted Rtti indices
+		bool			mbDeclared;
+	};
+
 	class LogicComp : public IComp
 	{
 		AEX_RTTI_DECL(LogicComp, IComp);
+		friend class Logic;
 	public:
 		LogicComp();
 		void Initialize();
 		void Shutdown();
+
+		// disabled components leave the Logic registry (O(1)), so that Update
+		// doesn't test them. Not from a parallel logic update. A serial Update
+		// may disable any component, itself included, but must not remove or
+		// destroy its own component or object: use aexCommands.
+		virtual void SetEnabled(bool enabled);
+
+		// Override to let Logic update this type on worker threads. Called once,
+		// on the first component of each concrete type. Update may then only
+		// touch its owner's components of the declared types, and must not add
+		// or remove components directly: record the change with aexCommands
+		// instead. Types that don't declare anything are updated on the main
+		// thread.
+		virtual void DeclareAccess(LogicAccess & /*access*/) {}
+
+	private:
+		// back-index into the Logic registry (kInvalidIndex when not registered)
+		u32 mLogicGroup;
+		u32 mLogicSlot;
+		bool mbInitialized;	// between Initialize and Shutdown
 	};
 
+	// ----------------------------------------------------------------------------
+	// \class	Logic
+	// \brief	Updates the logic components. Components are stored in dense
+	//			arrays, one per concrete type, so that Update calls the same
+	//			virtual function back to back. Add and remove are O(1): removing
+	//			moves the last component of the group into the freed slot.
+	//			Removing from the group being updated leaves a hole instead,
+	//			closed once the group is done, so no component misses its update.
+	//
+	//	Parallel update: groups are sorted into phases, in registration order.
+	//	Groups in the same phase don't conflict (see LogicAccess) and are split
+	//	in batches that run on the job system. Groups without declared access
+	//	get a phase of their own on the main thread.
 	class Logic :public ISystem
 	{
 		AEX_RTTI_DECL(Logic, ISystem);
 		AEX_SINGLETON(Logic);
 
 	public:
+		static const u32 kInvalidIndex = 0xFFFFFFFF;
+		static const u32 kBatchSize = 256;	// components per parallel task
+
 		virtual void Update();
 
 		// component management
-		void AddComp(IComp * logicComp);
-		void RemoveComp(IComp * logicComp);
+		void AddComp(LogicComp * logicComp);
+		void RemoveComp(LogicComp * logicComp);
 		void ClearComps();
+		u32 GetCompCount() const { return mCompCount; }
+
+		// false updates everything on the calling thread. Defaults to true.
+		void SetParallel(bool enabled) { mbParallel = enabled; }
+		bool GetParallel() const { return mbParallel; }
+
+		// Debug: runs everything serially and, each frame, checks one component
+		// per parallel type (round robin) for writes outside its declared access:
+		// other types on its owner, or any component of another object. Slow.
+		void SetAccessCheck(bool enabled) { mbAccessCheck = enabled; }
+		bool GetAccessCheck() const { return mbAccessCheck; }
+
+		// the component whose Update is running, serial updates only (else NULL)
+		LogicComp * GetUpdatingComp() const { return mpUpdatingComp; }
+
 	private:
-		std::list<IComp *> mComps;
+		struct LogicGroup
+		{
+			const Rtti *				mType;
+			AEX_TAGGED_PTR_ARRAY(LogicComp, eMT_Logic)	mComps;
+			LogicAccess					mAccess;
+			u32							mCheckCursor;	// next component to check
+		};
+		struct LogicPhase
+		{
+			AEX_ARRAY(u32)	mGroups;
+			bool			mbParallel;
+		};
+		struct LogicBatch
+		{
+			u32 mGroup;
+			u32 mBegin;
+			u32 mEnd;
+		};
+
+		void BuildPhases();
+		void UpdateGroup(u32 group);
+		void UpdatePhaseParallel(const LogicPhase & phase);
+		void UpdateGroupChecked(u32 group);
+		void BeginGroupUpdate(u32 group);
+		void EndGroupUpdate();			// closes the holes left by RemoveComp
+
+		AEX_ARRAY(LogicGroup)	mGroups;		// in order of first registration
+		AEX_ARRAY(u32)			mGroupByType;	// Rtti::GetIndex() -> group index
+		AEX_ARRAY(LogicPhase)	mPhases;
+		bool					mbPhasesDirty;
+		u32						mCompCount;
+		bool					mbInParallelUpdate;
+		bool					mbAccessCheck;
+		bool					mbParallel;
+		AEX_ARRAY(LogicBatch)	mBatches;		// of the current parallel phase
+		u32						mUpdatingGroup;	// serial update in progress, else kInvalidIndex
+		LogicComp *				mpUpdatingComp;
+		bool					mbHoles;		// NULL entries in mUpdatingGroup
 	};
-}
\ No newline at end of file
+}
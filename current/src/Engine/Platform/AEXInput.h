@@ -20,7 +20,7 @@
 #include "..\Utilities\AEXContainers.h"
 #include "..\Core\AEXCore.h"
 #include <Windows.h>
-#include <aexmath\AEXVec2.h>
+#include <aexmath\AEXMath.h>
 
 #pragma warning (disable:4251) // dll and STL
 namespace AEX
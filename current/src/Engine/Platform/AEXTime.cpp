@@ -10,6 +10,9 @@
 //                being updated. - Dan Weiss
 // ---------------------------------------------------------------------------
 #include "AEXTime.h"
+#include "..\Utilities\AEXFrameArena.h"
+#include "..\Utilities\AEXAllocator.h"
+#include "..\Debug\AEXAllocTracker.h"
 #include <Windows.h> //QueryPerformance... functions.
 
 // ---------------------------------------------------------------------------
@@ -78,6 +81,11 @@ namespace AEX
 	void FRC::StartFrame()
 	{
 		FRC::sFrameTimeStart = FRC::GetCPUTime();
+
+		// the frame arenas of two frames ago are reused for this one
+		FrameArena::NewFrame();
+		EngineAllocator::NewFrame();
+		AllocTracker::NewFrame();
 	}
 
 	// ---------------------------------------------------------------------------
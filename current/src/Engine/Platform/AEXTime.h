@@ -25,7 +25,9 @@ namespace AEX
 		virtual bool Initialize();
 		virtual void Update();
 
-		// call between each frame for frame statistics
+		// call between each frame for frame statistics. StartFrame also
+		// flips the frame arenas (see FrameArena) and closes the allocation
+		// stats of the last frame (see EngineAllocator).
 		void StartFrame();
 		void EndFrame();
 		void Reset();
@@ -71,7 +71,7 @@ namespace AEX
 	// Get one of the registered windows
 	Window* WindowManager::GetWindow(HWND hWin)
 	{
-		std::map<HWND, Window*>::iterator it = mWindows.find(hWin);
+		AEX_FLAT_MAP(HWND, Window*)::iterator it = mWindows.find(hWin);
 		if (it != mWindows.end())
 		{
 			return it->second;
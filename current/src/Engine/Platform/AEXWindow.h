@@ -119,7 +119,7 @@ namespace AEX
 		static LRESULT CALLBACK AEDefWinProc(HWND hWin, UINT msg, WPARAM wp, LPARAM lp);
 		
 	private:
-		std::map<HWND, Window*> mWindows;
+		AEX_FLAT_MAP(HWND, Window*) mWindows;	// few windows: sorted array
 		bool			mbIsAEWinClassRegistered;
 		WNDCLASSEX   mWinClass;		// window class associated to this window
 		Window*	mMainWindow;	// the main window for the engine
@@ -0,0 +1,172 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXScene.cpp
+// Purpose:	Owns the game objects, resolves handles and finds objects by
+//			name or tag.
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include "AEXScene.h"
+#include "..\Composition\AEXObjectPool.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	Scene::Scene()
+	{}
+	Scene::~Scene()
+	{
+		Clear();
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// OWNERSHIP
+
+	GameObject * Scene::NewObject(const char * name, const char * tag)
+	{
+		GameObject * obj = new GameObject();
+		if (name)
+			obj->SetName(name);
+		if (tag)
+			obj->SetTag(tag);
+		AddObject(obj);
+		return obj;
+	}
+	GameObjectHandle Scene::AddObject(GameObject * obj)
+	{
+		if (!obj)
+			return GameObjectHandle();
+		if (DebugErrorIf(!obj->mHandle.IsNull(), "Scene::AddObject: \"%s\" is already in the scene", obj->GetName()))
+			return obj->mHandle;
+
+		obj->mHandle = mHandles.Insert(obj);
+		if (obj->mHandle.mIndex >= mObjectSlots.size())
+			mObjectSlots.resize(obj->mHandle.mIndex + 1);
+		mObjectSlots[obj->mHandle.mIndex] = mObjects.size();
+		mObjects.push_back(obj);
+
+		IndexAdd(mNameIndex, obj->GetNameHash(), obj, &GameObject::mNameSlot);
+		IndexAdd(mTagIndex, obj->GetTagHash(), obj, &GameObject::mTagSlot);
+		return obj->mHandle;
+	}
+	void Scene::DestroyObject(GameObject * obj)
+	{
+		if (!Contains(obj))
+			return;
+
+		IndexRemove(mNameIndex, obj->GetNameHash(), obj, &GameObject::mNameSlot);
+		IndexRemove(mTagIndex, obj->GetTagHash(), obj, &GameObject::mTagSlot);
+
+		// swap-remove from the dense array
+		u32 slot = mObjectSlots[obj->mHandle.mIndex];
+		GameObject * last = mObjects.back();
+		mObjects[slot] = last;
+		mObjectSlots[last->mHandle.mIndex] = slot;
+		mObjects.pop_back();
+
+		mHandles.Remove(obj->mHandle);
+		obj->mHandle = GameObjectHandle();
+
+		// recycled with its components
+		if (obj->IsPooled())
+		{
+			aexObjectPool->Release(obj);
+			return;
+		}
+		obj->RemoveAllComp();
+		delete obj;
+	}
+	void Scene::DestroyObject(const GameObjectHandle & handle)
+	{
+		DestroyObject(Resolve(handle));
+	}
+	void Scene::Clear()
+	{
+		while (!mObjects.empty())
+			DestroyObject(mObjects.back());
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// QUERIES
+
+	bool Scene::Contains(const GameObject * obj) const
+	{
+		return obj && mHandles.Get(obj->mHandle) == obj;
+	}
+
+	// two strings with the same hash share a bucket: compare the strings
+	GameObject * Scene::FindFirst(const ObjectIndex & index, u32 hash, const char * str, IdGetter getId)
+	{
+		ObjectIndex::const_iterator it = index.find(hash);
+		if (it == index.end())
+			return NULL;
+		if (!str)
+			return it->second.front();
+		FOR_EACH(obj, it->second)
+		{
+			if (strcmp(((*obj)->*getId)().GetString(), str) == 0)
+				return *obj;
+		}
+		return NULL;
+	}
+	u32 Scene::FindAll(const ObjectIndex & index, u32 hash, const char * str, IdGetter getId, AEX_PTR_ARRAY(GameObject) & out)
+	{
+		ObjectIndex::const_iterator it = index.find(hash);
+		if (it == index.end())
+			return 0;
+		u32 found = 0;
+		FOR_EACH(obj, it->second)
+		{
+			if (!str || strcmp(((*obj)->*getId)().GetString(), str) == 0)
+			{
+				out.push_back(*obj);
+				++found;
+			}
+		}
+		return found;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// INDEX
+
+	void Scene::OnNameChanged(GameObject * obj, u32 oldNameHash)
+	{
+		if (!Contains(obj) || oldNameHash == obj->GetNameHash())
+			return;
+		IndexRemove(mNameIndex, oldNameHash, obj, &GameObject::mNameSlot);
+		IndexAdd(mNameIndex, obj->GetNameHash(), obj, &GameObject::mNameSlot);
+	}
+	void Scene::OnTagChanged(GameObject * obj, u32 oldTagHash)
+	{
+		if (!Contains(obj) || oldTagHash == obj->GetTagHash())
+			return;
+		IndexRemove(mTagIndex, oldTagHash, obj, &GameObject::mTagSlot);
+		IndexAdd(mTagIndex, obj->GetTagHash(), obj, &GameObject::mTagSlot);
+	}
+
+	void Scene::IndexAdd(ObjectIndex & index, u32 hash, GameObject * obj, BucketSlot slot)
+	{
+		ObjectBucket & bucket = index[hash];
+		obj->*slot = bucket.size();
+		bucket.push_back(obj);
+	}
+	void Scene::IndexRemove(ObjectIndex & index, u32 hash, GameObject * obj, BucketSlot slot)
+	{
+		ObjectIndex::iterator it = index.find(hash);
+		if (it == index.end())
+			return;
+		ObjectBucket & bucket = it->second;
+		u32 i = obj->*slot;
+		if (i >= bucket.size() || bucket[i] != obj)
+			return;
+		GameObject * last = bucket.back();
+		bucket[i] = last;
+		last->*slot = i;
+		bucket.pop_back();
+		if (bucket.empty())
+			index.erase(it);
+	}
+	#pragma endregion
+}
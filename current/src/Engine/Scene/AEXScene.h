@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXScene.h
+// Purpose:	Owns the game objects, resolves handles and finds objects by
+//			name or tag.
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_SCENE_H_
+#define AEX_SCENE_H_
+
+#include "..\Composition\AEXGameObject.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	Scene
+	// \brief	Owns every game object added to it, in a dense array. Handles
+	//			resolve in O(1) through a HandleTable. Names and tags are indexed
+	//			by StringId, so FindByName/FindByTag don't walk all the objects;
+	//			the index follows GameObject::SetName and SetTag.
+	//
+	//	Main thread only. From worker threads, create and destroy objects with
+	//	aexCommands: its objects join the scene when the commands are applied.
+	class Scene : public ISystem
+	{
+		AEX_RTTI_DECL(Scene, ISystem);
+		AEX_SINGLETON(Scene);
+
+	public:
+		virtual ~Scene();
+
+		// ------------------------------------------------------------------------
+		// ownership
+		GameObject * NewObject(const char * name = NULL, const char * tag = NULL);
+		GameObjectHandle AddObject(GameObject * obj);	// the scene deletes it
+		void DestroyObject(GameObject * obj);			// removes the components and deletes it (pooled: back to its ObjectPool)
+		void DestroyObject(const GameObjectHandle & handle);
+		void Clear();									// destroys everything
+
+		// ------------------------------------------------------------------------
+		// queries
+		GameObject * Resolve(const GameObjectHandle & handle) const { return mHandles.Get(handle); }	// NULL if stale
+		bool Contains(const GameObject * obj) const;
+		u32 GetObjectCount() const { return mObjects.size(); }
+		const AEX_PTR_ARRAY(GameObject) & GetObjects() const { return mObjects; }
+
+		// chunk storage for hot components, iterated as packed arrays:
+		// GetArchetypes().NewComp<TransformComp>(obj) instead of obj->NewComp,
+		// then GetArchetypes().ForEach<TransformComp>(...).
+		ArchetypeStorage & GetArchetypes() { return mArchetypes; }
+
+		// first match (any of them if several objects share the name/tag).
+		// Use AEX_SID("name") to hash literals at compile time. The strings
+		// are compared too, except for ids made from a hash only.
+		GameObject * FindByName(StringId name) const { return FindFirst(mNameIndex, name.GetHash(), name.IsInterned() ? name.GetString() : NULL, &GameObject::GetNameId); }
+		GameObject * FindByTag(StringId tag) const { return FindFirst(mTagIndex, tag.GetHash(), tag.IsInterned() ? tag.GetString() : NULL, &GameObject::GetTagId); }
+		GameObject * FindByName(const char * name) const { return FindFirst(mNameIndex, StringId::Hash(name), name, &GameObject::GetNameId); }
+		GameObject * FindByTag(const char * tag) const { return FindFirst(mTagIndex, StringId::Hash(tag), tag, &GameObject::GetTagId); }
+
+		// appends all the matches to out, returns how many
+		u32 FindAllByName(StringId name, AEX_PTR_ARRAY(GameObject) & out) const { return FindAll(mNameIndex, name.GetHash(), name.IsInterned() ? name.GetString() : NULL, &GameObject::GetNameId, out); }
+		u32 FindAllByTag(StringId tag, AEX_PTR_ARRAY(GameObject) & out) const { return FindAll(mTagIndex, tag.GetHash(), tag.IsInterned() ? tag.GetString() : NULL, &GameObject::GetTagId, out); }
+		u32 FindAllByName(const char * name, AEX_PTR_ARRAY(GameObject) & out) const { return FindAll(mNameIndex, StringId::Hash(name), name, &GameObject::GetNameId, out); }
+		u32 FindAllByTag(const char * tag, AEX_PTR_ARRAY(GameObject) & out) const { return FindAll(mTagIndex, StringId::Hash(tag), tag, &GameObject::GetTagId, out); }
+
+		// ------------------------------------------------------------------------
+		// called by GameObject when an object in the scene is renamed/retagged
+		void OnNameChanged(GameObject * obj, u32 oldNameHash);
+		void OnTagChanged(GameObject * obj, u32 oldTagHash);
+
+	private:
+		typedef AEX_SMALL_PTR_ARRAY(GameObject, 2) ObjectBucket;		// names are mostly unique
+		typedef AEX_HASH_MAP(u32, ObjectBucket) ObjectIndex;			// StringId hash -> objects
+
+		// slot: GameObject::mNameSlot or mTagSlot, the object's position in its
+		// bucket. Removing is a swap with the last object of the bucket.
+		typedef u32 GameObject::*BucketSlot;
+		static void IndexAdd(ObjectIndex & index, u32 hash, GameObject * obj, BucketSlot slot);
+		static void IndexRemove(ObjectIndex & index, u32 hash, GameObject * obj, BucketSlot slot);
+
+		// hash -> bucket, then the objects whose id string is str (all of them
+		// if str is NULL). getId: GetNameId or GetTagId.
+		typedef StringId (GameObject::*IdGetter)() const;
+		static GameObject * FindFirst(const ObjectIndex & index, u32 hash, const char * str, IdGetter getId);
+		static u32 FindAll(const ObjectIndex & index, u32 hash, const char * str, IdGetter getId, AEX_PTR_ARRAY(GameObject) & out);
+
+		AEX_PTR_ARRAY(GameObject)		mObjects;
+		AEX_ARRAY(u32)					mObjectSlots;	// handle index -> position in mObjects
+		HandleTable<GameObject>			mHandles;
+		ObjectIndex						mNameIndex;
+		ObjectIndex						mTagIndex;
+		ArchetypeStorage				mArchetypes;	// entities die with their objects, before it
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexScene (AEX::Scene::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
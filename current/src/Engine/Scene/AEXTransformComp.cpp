@@ -7,6 +7,12 @@ namespace AEX
 
 	// --------------------------------------------------------------------
 	TransformComp::TransformComp()
+		: mVersion(0)
+		, mInverseVersion(0xFFFFFFFF)
+		, mHierarchyNode(TransformHierarchy::kInvalidNode)
+		, mStorageSlot(TransformStorage::kInvalidSlot)
+		, mbDirty(true)
+		, mbStoreOnReset(false)
 	{
 		
 	}
@@ -14,6 +20,89 @@ namespace AEX
 	TransformComp::~TransformComp()
 	{
 		
+	}
+	// --------------------------------------------------------------------
+	void TransformComp::Initialize()
+	{
+		if (aexTransformStorage->GetAutoAdd())
+			aexTransformStorage->Add(this);
+	}
+	// --------------------------------------------------------------------
+	void TransformComp::Shutdown()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->Remove(this);
+	}
+	// --------------------------------------------------------------------
+	// a pooled transform is stored again if it was when recycled
+	void TransformComp::Reset()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+		SetLocal(Transform());
+		if (mbStoreOnReset)
+		{
+			mbStoreOnReset = false;
+			aexTransformStorage->Add(this);
+		}
+	}
+	// --------------------------------------------------------------------
+	// back in the pool: out of the hierarchy (the children are detached)
+	// and of the storage, like a destroyed transform
+	void TransformComp::Recycle()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+		mbStoreOnReset = IsStored();
+		if (mbStoreOnReset)
+			aexTransformStorage->Remove(this);
+	}
+	// --------------------------------------------------------------------
+	void TransformComp::SetStored(bool stored)
+	{
+		if (stored)
+			aexTransformStorage->Add(this);
+		else
+			aexTransformStorage->Remove(this);
+	}
+	// --------------------------------------------------------------------
+	Transform & TransformComp::EditLocal()
+	{
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->MarkStale(mStorageSlot);
+		return mLocal;
+	}
+	// --------------------------------------------------------------------
+	void TransformComp::SetLocal(const Transform & local)
+	{
+		mLocal = local;
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->Write(mStorageSlot, mLocal);
+	}
+	// --------------------------------------------------------------------
+	void TransformComp::Invalidate()
+	{
+		mbDirty = true;
+		++mVersion;
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->MarkDirty(mHierarchyNode);
+	}
+	// --------------------------------------------------------------------
+	u32 TransformComp::GetVersion() const
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			return mVersion + aexTransformHierarchy->GetWorldVersion(mHierarchyNode);
+		return mVersion;
+	}
+	// --------------------------------------------------------------------
+	// NULL if the parent is a TransformComp3D (the hierarchy takes any component)
+	TransformComp * TransformComp::GetParent() const
+	{
+		return aex_cast<TransformComp>(aexTransformHierarchy->GetParent(this));
 	}
 	// --------------------------------------------------------------------
 	f32 TransformComp::GetRotationAngle()
@@ -47,11 +136,17 @@ namespace AEX
 	void TransformComp::SetDirection(AEVec2 dir)
 	{
 		mLocal.mOrientation = RadToDeg(dir.GetAngle());
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->WriteRotation(mStorageSlot, mLocal.mOrientation);
 	}
 	// --------------------------------------------------------------------
 	void TransformComp::SetRotationAngle(f32 angle)
 	{
 		mLocal.mOrientation = angle;
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->WriteRotation(mStorageSlot, angle);
 	}
 	// --------------------------------------------------------------------
 	void TransformComp::SetPosition(const AEVec2 & pos)
@@ -59,6 +154,9 @@ namespace AEX
 		mLocal.mTranslation = pos;
 		mLocal.mTranslationZ.x = pos.x;
 		mLocal.mTranslationZ.y = pos.y;
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->WritePosition(mStorageSlot, mLocal.mTranslationZ);
 	}
 	// --------------------------------------------------------------------
 	void TransformComp::SetPosition3D(const AEVec3 & pos)
@@ -66,11 +164,17 @@ namespace AEX
 		mLocal.mTranslationZ = pos;
 		mLocal.mTranslation.x = pos.x;
 		mLocal.mTranslation.y = pos.y;
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->WritePosition(mStorageSlot, pos);
 	}
 	// --------------------------------------------------------------------
 	void TransformComp::SetScale(const AEVec2 & scale)
 	{
 		mLocal.mScale = scale;
+		Invalidate();
+		if (mStorageSlot != TransformStorage::kInvalidSlot)
+			aexTransformStorage->WriteScale(mStorageSlot, scale);
 	}
 	// --------------------------------------------------------------------
 	AEMtx33 TransformComp::GetModelToWorld()
@@ -83,20 +187,55 @@ namespace AEX
 		return mLocal.GetInvMatrix();
 	}
 	// --------------------------------------------------------------------
-	AEMtx44 TransformComp::GetModelToWorld4x4()
+	const AEMtx44 & TransformComp::GetLocalToParent4x4()
 	{
-		AEMtx44 scale_mtx = AEMtx44::Scale(mLocal.mScale.x, mLocal.mScale.y, 1.0f);
-		AEMtx44 rot_mtx = AEMtx44::RotateXYZ(0, 0, mLocal.mOrientation);
-		AEMtx44 trans_mtx = AEMtx44::Translate(mLocal.mTranslationZ.x, mLocal.mTranslationZ.y, mLocal.mTranslationZ.z);
-		return (trans_mtx * rot_mtx * scale_mtx);
+		if (mbDirty)
+			UpdateMatrices();
+		return mLocalToParent;
 	}
 	// --------------------------------------------------------------------
-	AEMtx44 TransformComp::GetWorldToModel4x4()
+	const AEMtx44 & TransformComp::GetModelToWorld4x4()
 	{
-		AEMtx44 scale_mtx = AEMtx44::Scale(1.0f/mLocal.mScale.x, 1.0f/mLocal.mScale.y, 1.0f);
-		AEMtx44 rot_mtx = AEMtx44::RotateXYZ(0, 0, -mLocal.mOrientation);
-		AEMtx44 trans_mtx = AEMtx44::Translate(-mLocal.mTranslationZ.x, -mLocal.mTranslationZ.y, -mLocal.mTranslationZ.z);
-		return(scale_mtx*rot_mtx*trans_mtx);
+		if (HasParent())
+			return aexTransformHierarchy->GetWorld(mHierarchyNode);
+		return GetLocalToParent4x4();
+	}
+	// --------------------------------------------------------------------
+	// without a parent: inverse(S) * transpose(Rz) * inverse(T), composed
+	// directly like the local matrix
+	const AEMtx44 & TransformComp::GetWorldToModel4x4()
+	{
+		u32 version = GetVersion();
+		if (mInverseVersion == version)
+			return mWorldToModel;
+		mInverseVersion = version;
+
+		if (HasParent())
+			return mWorldToModel = aexTransformHierarchy->GetWorld(mHierarchyNode).Inverse();
+
+		f32 c = cosf(mLocal.mOrientation), s = sinf(mLocal.mOrientation);
+		const AEVec3 & t = mLocal.mTranslationZ;
+		f32 isx = 1.0f / mLocal.mScale.x, isy = 1.0f / mLocal.mScale.y;
+		mWorldToModel = AEMtx44( c * isx, s * isx, 0.0f, -(c * t.x + s * t.y) * isx,
+								-s * isy, c * isy, 0.0f,  (s * t.x - c * t.y) * isy,
+								0.0f, 0.0f, 1.0f, -t.z,
+								0.0f, 0.0f, 0.0f, 1.0f);
+		return mWorldToModel;
+	}
+	// --------------------------------------------------------------------
+	// T * Rz * S, composed directly from one sin/cos. As the
+	// RotateXYZ(0, 0, mOrientation) this replaces, the 4x4 matrices take the
+	// orientation as is (radians).
+	void TransformComp::UpdateMatrices()
+	{
+		f32 c = cosf(mLocal.mOrientation), s = sinf(mLocal.mOrientation);
+		const AEVec2 & sc = mLocal.mScale;
+		const AEVec3 & t = mLocal.mTranslationZ;
+		mLocalToParent = AEMtx44(c * sc.x, -s * sc.y, 0.0f, t.x,
+								 s * sc.x,  c * sc.y, 0.0f, t.y,
+								 0.0f, 0.0f, 1.0f, t.z,
+								 0.0f, 0.0f, 0.0f, 1.0f);
+		mbDirty = false;
 	}
 
 
@@ -107,11 +246,56 @@ namespace AEX
 
 	// --------------------------------------------------------------------
 	TransformComp3D::TransformComp3D()
+		: mVersion(0)
+		, mInverseVersion(0xFFFFFFFF)
+		, mHierarchyNode(TransformHierarchy::kInvalidNode)
+		, mbDirty(true)
 	{}
 	// --------------------------------------------------------------------
 	TransformComp3D::~TransformComp3D()
 	{}
 	// --------------------------------------------------------------------
+	void TransformComp3D::Shutdown()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+	}
+	// --------------------------------------------------------------------
+	void TransformComp3D::Reset()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+		mLocal = Transform3D();
+		Invalidate();
+	}
+	// --------------------------------------------------------------------
+	void TransformComp3D::Recycle()
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->Remove(this);
+	}
+	// --------------------------------------------------------------------
+	void TransformComp3D::Invalidate()
+	{
+		mbDirty = true;
+		++mVersion;
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			aexTransformHierarchy->MarkDirty(mHierarchyNode);
+	}
+	// --------------------------------------------------------------------
+	u32 TransformComp3D::GetVersion() const
+	{
+		if (mHierarchyNode != TransformHierarchy::kInvalidNode)
+			return mVersion + aexTransformHierarchy->GetWorldVersion(mHierarchyNode);
+		return mVersion;
+	}
+	// --------------------------------------------------------------------
+	// NULL if the parent is a 2D TransformComp
+	TransformComp3D * TransformComp3D::GetParent() const
+	{
+		return aex_cast<TransformComp3D>(aexTransformHierarchy->GetParent(this));
+	}
+	// --------------------------------------------------------------------
 	AEVec3	TransformComp3D::GetRotationXYZ()
 	{
 		return mLocal.rot.ToEulerXYZ();
@@ -145,19 +329,38 @@ namespace AEX
 		return mLocal.scale;
 	}
 	// --------------------------------------------------------------------
-	AEMtx44 TransformComp3D::GetModelToWorld()
+	const AEMtx44 & TransformComp3D::GetLocalToParent()
 	{
-		return mLocal.GetMatrix();
+		if (mbDirty)
+		{
+			mLocalToParent = mLocal.GetMatrix();
+			mbDirty = false;
+		}
+		return mLocalToParent;
+	}
+	// --------------------------------------------------------------------
+	const AEMtx44 & TransformComp3D::GetModelToWorld()
+	{
+		if (HasParent())
+			return aexTransformHierarchy->GetWorld(mHierarchyNode);
+		return GetLocalToParent();
 	}
 	// --------------------------------------------------------------------
-	AEMtx44 TransformComp3D::GetWorldToModel()
+	const AEMtx44 & TransformComp3D::GetWorldToModel()
 	{
-		return mLocal.GetInverseMatrix();
+		u32 version = GetVersion();
+		if (mInverseVersion != version)
+		{
+			mWorldToModel = HasParent() ? aexTransformHierarchy->GetWorld(mHierarchyNode).Inverse() : mLocal.GetInverseMatrix();
+			mInverseVersion = version;
+		}
+		return mWorldToModel;
 	}
 	// --------------------------------------------------------------------
 	void TransformComp3D::SetRotationXYZRad(f32 xRad, f32 yRad, f32 zRad)
 	{
 		mLocal.rot.FromEulerXYZ(xRad, yRad, zRad);
+		Invalidate();
 	}
 	// --------------------------------------------------------------------
 	void TransformComp3D::SetRotationXYZDeg(f32 xDeg, f32 yDeg, f32 zDeg)
@@ -168,21 +371,25 @@ namespace AEX
 	void TransformComp3D::SetPosition(const AEVec3 & pos)
 	{
 		mLocal.position = pos;
+		Invalidate();
 	}
 	// --------------------------------------------------------------------
 	void TransformComp3D::SetScale(const AEVec3 & scale)
 	{
 		mLocal.scale = scale;
+		Invalidate();
 	}
 	// --------------------------------------------------------------------
 	void TransformComp3D::SetScale(f32 sx, f32 sy, f32 sz)
 	{
 		mLocal.scale = AEVec3(sx, sy, sz);
+		Invalidate();
 	}
 	// --------------------------------------------------------------------
 	void TransformComp3D::SetScale(f32 sc)
 	{
 		mLocal.scale = AEVec3(sc, sc, sc);
+		Invalidate();
 	}
 
 	#pragma endregion
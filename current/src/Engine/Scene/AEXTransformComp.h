@@ -3,12 +3,17 @@
 
 #include <aexmath\AEXMath.h>
 #include "..\Composition\AEXComponent.h"
+#include "..\Composition\AEXPrefab.h"
+#include "AEXTransformHierarchy.h"
+#include "AEXTransformStorage.h"
 
 namespace AEX
 {
 	class TransformComp : public IComp
 	{
 		AEX_RTTI_DECL(TransformComp, IComp);
+		friend class TransformHierarchy;
+		friend class TransformStorage;
 
 	public:
 		TransformComp();
@@ -19,26 +24,70 @@ namespace AEX
 		AEVec2 GetPosition();
 		AEVec3 GetPosition3D();
 		AEVec2 GetScale();
-		AEMtx33 GetModelToWorld();
+		AEMtx33 GetModelToWorld();		// local only, orientation in degrees
 		AEMtx33 GetWorldToModel();
-		AEMtx44 GetModelToWorld4x4();
-		AEMtx44 GetWorldToModel4x4();
+		const AEMtx44 & GetLocalToParent4x4();
+		const AEMtx44 & GetModelToWorld4x4();	// parents included
+		const AEMtx44 & GetWorldToModel4x4();
 
 		void SetDirection(AEVec2 dir);
 		void SetRotationAngle(f32 angle);
 		void SetPosition(const AEVec2 & pos);
 		void SetPosition3D(const AEVec3 & posZorder);
 		void SetScale(const AEVec2 & scale);
+
+		// the local transform. Change it through the setters, SetLocal or
+		// EditLocal (get the reference again after reading a matrix), so
+		// that the cached matrices are rebuilt.
+		const Transform & GetLocal() const			{ return mLocal; }
+		Transform & EditLocal();
+		void SetLocal(const Transform & local);
+
+		// changes with every change of the model to world matrix, local or
+		// inherited: whoever keeps a copy of the matrices (ex: uploaded to the
+		// GPU) can skip unchanged ones
+		u32 GetVersion() const;
+
+		// hierarchy, see TransformHierarchy. The parent's world matrix is
+		// applied by TransformHierarchy::Update, once per frame.
+		bool SetParent(TransformComp * parent)	{ return aexTransformHierarchy->SetParent(this, parent); }
+		TransformComp * GetParent() const;
+		bool IsInHierarchy() const { return mHierarchyNode != TransformHierarchy::kInvalidNode; }
+
+		// SoA storage, see TransformStorage. A stored transform's model matrix
+		// is also built by TransformStorage::Update, with all the others.
+		void SetStored(bool stored);
+		bool IsStored() const { return mStorageSlot != TransformStorage::kInvalidSlot; }
+		u32 GetStorageSlot() const { return mStorageSlot; }
+
+		virtual void Initialize();
+		virtual void Shutdown();
+		virtual void Reset();
+		virtual void Recycle();
 		
+	private:
+		void Invalidate();
+		void LeaveHierarchy(u32 worldVersion) { mVersion += worldVersion + 1; mHierarchyNode = TransformHierarchy::kInvalidNode; }
+		void UpdateMatrices();
+		bool HasParent() const { return mHierarchyNode != TransformHierarchy::kInvalidNode && aexTransformHierarchy->HasParent(mHierarchyNode); }
+
 		// Data
-	public:
-		Transform mLocal;
+		Transform	mLocal;
+		AEMtx44		mLocalToParent;		// cached, rebuilt when dirty
+		AEMtx44		mWorldToModel;		// cached, valid if mInverseVersion == GetVersion()
+		u32			mVersion;			// local changes; the hierarchy counts the inherited ones
+		u32			mInverseVersion;
+		u32			mHierarchyNode;		// TransformHierarchy::kInvalidNode if not in the hierarchy
+		u32			mStorageSlot;		// TransformStorage::kInvalidSlot if not stored
+		bool		mbDirty;
+		bool		mbStoreOnReset;		// was stored when its pooled owner was recycled
 	};
 
 
 	class TransformComp3D : public IComp
 	{
 		AEX_RTTI_DECL(TransformComp3D, IComp);
+		friend class TransformHierarchy;
 
 	public:
 		TransformComp3D();
@@ -49,8 +98,9 @@ namespace AEX
 		AEMtx44 GetRotationMtx44();
 		AEVec3	GetPosition();
 		AEVec3	GetScale();
-		AEMtx44 GetModelToWorld();
-		AEMtx44 GetWorldToModel();
+		const AEMtx44 & GetLocalToParent();
+		const AEMtx44 & GetModelToWorld();		// parents included
+		const AEMtx44 & GetWorldToModel();
 
 		void SetRotationXYZRad(f32 xRad, f32 yRad, f32 zRad);
 		void SetRotationXYZDeg(f32 xDeg, f32 yDeg, f32 zDeg);
@@ -58,11 +108,40 @@ namespace AEX
 		void SetScale(const AEVec3 & scale);
 		void SetScale(f32 sx, f32 sy, f32 sz);
 		void SetScale(f32 sc);
+
+		// same as TransformComp
+		const Transform3D & GetLocal() const		{ return mLocal; }
+		Transform3D & EditLocal()					{ Invalidate(); return mLocal; }
+		void SetLocal(const Transform3D & local)	{ mLocal = local; Invalidate(); }
+		u32 GetVersion() const;
+		bool SetParent(TransformComp3D * parent)	{ return aexTransformHierarchy->SetParent(this, parent); }
+		TransformComp3D * GetParent() const;
+		bool IsInHierarchy() const { return mHierarchyNode != TransformHierarchy::kInvalidNode; }
+
+		virtual void Shutdown();
+		virtual void Reset();
+		virtual void Recycle();
 		
+	private:
+		void Invalidate();
+		void LeaveHierarchy(u32 worldVersion) { mVersion += worldVersion + 1; mHierarchyNode = TransformHierarchy::kInvalidNode; }
+		bool HasParent() const { return mHierarchyNode != TransformHierarchy::kInvalidNode && aexTransformHierarchy->HasParent(mHierarchyNode); }
+
 		// Data
-	public:
-		Transform3D mLocal;
+		Transform3D	mLocal;
+		AEMtx44		mLocalToParent;		// cached, rebuilt when dirty
+		AEMtx44		mWorldToModel;
+		u32			mVersion;
+		u32			mInverseVersion;
+		u32			mHierarchyNode;
+		bool		mbDirty;
 	};
+
+	// plain data, cache included: prefab instances are memcpy'd. The
+	// hierarchy node and storage slot are copied too: Prefab::Compile checks
+	// that the defaults are neither in the hierarchy nor stored.
+	AEX_PREFAB_BITWISE(TransformComp);
+	AEX_PREFAB_BITWISE(TransformComp3D);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,382 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXTransformHierarchy.cpp
+// Purpose:	Parent/child links between transform components and the
+//			propagation of their world matrices
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include "AEXTransformHierarchy.h"
+#include "AEXTransformComp.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	const u32 TransformHierarchy::kInvalidNode;
+	const u32 TransformHierarchy::kBatchSize;
+	const u32 TransformHierarchy::kParallelMinCount;
+
+	TransformHierarchy::TransformHierarchy()
+		: mbOrderDirty(false)
+		, mbAnyDirty(false)
+		, mbStaleFound(false)
+		, mUpdatedCount(0)
+		, mbParallel(true)
+		, mbUpdating(false)
+	{}
+	TransformHierarchy::~TransformHierarchy()
+	{
+		// the transforms still linked forget their node
+		for (u32 i = 0; i < mNodes.size(); ++i)
+		{
+			if (IComp * comp = IComp::Get(mNodes[i].mComp))
+				LeaveNode(comp, mNodes[i].mb3D, mWorldVersion[i]);
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// TRANSFORM ACCESS
+
+	bool TransformHierarchy::IsTransform(const IComp * comp, bool & is3D)
+	{
+		is3D = comp->GetType().IsExactly(TransformComp3D::TYPE());
+		return is3D || comp->GetType().IsExactly(TransformComp::TYPE());
+	}
+	u32 TransformHierarchy::GetNodeOf(const IComp * comp, bool is3D)
+	{
+		return is3D ? static_cast<const TransformComp3D*>(comp)->mHierarchyNode : static_cast<const TransformComp*>(comp)->mHierarchyNode;
+	}
+	void TransformHierarchy::SetNodeOf(IComp * comp, bool is3D, u32 node)
+	{
+		if (is3D)
+			static_cast<TransformComp3D*>(comp)->mHierarchyNode = node;
+		else
+			static_cast<TransformComp*>(comp)->mHierarchyNode = node;
+	}
+	const AEMtx44 & TransformHierarchy::GetLocalOf(IComp * comp, bool is3D)
+	{
+		return is3D ? static_cast<TransformComp3D*>(comp)->GetLocalToParent() : static_cast<TransformComp*>(comp)->GetLocalToParent4x4();
+	}
+	void TransformHierarchy::LeaveNode(IComp * comp, bool is3D, u32 worldVersion)
+	{
+		if (is3D)
+			static_cast<TransformComp3D*>(comp)->LeaveHierarchy(worldVersion);
+		else
+			static_cast<TransformComp*>(comp)->LeaveHierarchy(worldVersion);
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// STRUCTURE
+
+	u32 TransformHierarchy::FindNode(const IComp * comp) const
+	{
+		bool is3D;
+		if (!comp || !IsTransform(comp, is3D))
+			return kInvalidNode;
+		u32 node = GetNodeOf(comp, is3D);
+		if (node >= mNodes.size() || mNodes[node].mComp.IsNull())
+			return kInvalidNode;
+
+		// the handle is already gone when Shutdown runs: trust the node then
+		if (!comp->GetHandle().IsNull() && comp->GetHandle() != mNodes[node].mComp)
+			return kInvalidNode;
+		return node;
+	}
+	u32 TransformHierarchy::AddNode(IComp * comp, bool is3D)
+	{
+		Node node = { comp->GetHandle(), kInvalidNode, kInvalidNode, kInvalidNode, is3D };
+		u32 index = mNodes.size();
+		mNodes.push_back(node);
+		mParents.push_back(kInvalidNode);
+		mDirty.push_back(0);
+		mLocal.push_back(GetLocalOf(comp, is3D));
+		mWorld.push_back(mLocal.back());
+		mWorldVersion.push_back(0);
+		SetNodeOf(comp, is3D, index);
+		return index;
+	}
+	void TransformHierarchy::Unlink(u32 node)
+	{
+		u32 parent = mParents[node];
+		if (parent == kInvalidNode)
+			return;
+
+		Node & n = mNodes[node];
+		if (n.mPrevSibling != kInvalidNode)
+			mNodes[n.mPrevSibling].mNextSibling = n.mNextSibling;
+		else
+			mNodes[parent].mFirstChild = n.mNextSibling;
+		if (n.mNextSibling != kInvalidNode)
+			mNodes[n.mNextSibling].mPrevSibling = n.mPrevSibling;
+		n.mPrevSibling = n.mNextSibling = kInvalidNode;
+		mParents[node] = kInvalidNode;
+		mbOrderDirty = true;
+	}
+
+	bool TransformHierarchy::SetParent(IComp * child, IComp * parent)
+	{
+		DebugAssert(!mbUpdating, "TransformHierarchy::SetParent during Update");
+		bool childIs3D, parentIs3D = false;
+		if (DebugErrorIf(!child || !IsTransform(child, childIs3D), "TransformHierarchy::SetParent: the child isn't a transform component"))
+			return false;
+		if (DebugErrorIf(parent && !IsTransform(parent, parentIs3D), "TransformHierarchy::SetParent: the parent isn't a transform component"))
+			return false;
+		if (DebugErrorIf(child == parent, "TransformHierarchy::SetParent: a transform can't be its own parent"))
+			return false;
+
+		u32 childNode = FindNode(child);
+		if (!parent)
+		{
+			if (childNode != kInvalidNode && mParents[childNode] != kInvalidNode)
+			{
+				// now a root: world = local, for it and its subtree
+				Unlink(childNode);
+				MarkDirty(childNode);
+				++mWorldVersion[childNode];
+			}
+			return true;
+		}
+		if (DebugErrorIf(child->GetHandle().IsNull() || parent->GetHandle().IsNull(), "TransformHierarchy::SetParent: the transforms must be on game objects"))
+			return false;
+
+		// no cycles: the child can't be an ancestor of its new parent
+		u32 parentNode = FindNode(parent);
+		for (u32 n = parentNode; n != kInvalidNode; n = mParents[n])
+		{
+			if (DebugErrorIf(n == childNode, "TransformHierarchy::SetParent: the parent is in the child's subtree"))
+				return false;
+		}
+
+		if (childNode == kInvalidNode)
+			childNode = AddNode(child, childIs3D);
+		if (parentNode == kInvalidNode)
+			parentNode = AddNode(parent, parentIs3D);
+		if (mParents[childNode] == parentNode)
+			return true;
+
+		Unlink(childNode);
+		Node & n = mNodes[childNode];
+		n.mNextSibling = mNodes[parentNode].mFirstChild;
+		if (n.mNextSibling != kInvalidNode)
+			mNodes[n.mNextSibling].mPrevSibling = childNode;
+		mNodes[parentNode].mFirstChild = childNode;
+		mParents[childNode] = parentNode;
+		mbOrderDirty = true;
+
+		// the child's world right away, its subtree at the next Update
+		const AEMtx44 & parentWorld = mParents[parentNode] != kInvalidNode ? mWorld[parentNode] : GetLocalOf(parent, parentIs3D);
+		mWorld[childNode] = parentWorld * GetLocalOf(child, childIs3D);
+		++mWorldVersion[childNode];
+		MarkDirty(childNode);
+		return true;
+	}
+
+	IComp * TransformHierarchy::GetParent(const IComp * comp) const
+	{
+		u32 node = FindNode(comp);
+		if (node == kInvalidNode || mParents[node] == kInvalidNode)
+			return NULL;
+		return IComp::Get(mNodes[mParents[node]].mComp);
+	}
+	u32 TransformHierarchy::GetChildren(const IComp * comp, AEX_PTR_ARRAY(IComp) & out) const
+	{
+		u32 node = FindNode(comp), count = 0;
+		if (node == kInvalidNode)
+			return 0;
+		for (u32 c = mNodes[node].mFirstChild; c != kInvalidNode; c = mNodes[c].mNextSibling)
+		{
+			if (IComp * child = IComp::Get(mNodes[c].mComp))
+			{
+				out.push_back(child);
+				++count;
+			}
+		}
+		return count;
+	}
+
+	void TransformHierarchy::Remove(IComp * comp)
+	{
+		DebugAssert(!mbUpdating, "TransformHierarchy::Remove during Update");
+		u32 node = FindNode(comp);
+		if (node != kInvalidNode)
+			RemoveNode(node, comp);
+	}
+	void TransformHierarchy::RemoveNode(u32 node, IComp * comp)
+	{
+		// the children become roots
+		for (u32 c = mNodes[node].mFirstChild; c != kInvalidNode;)
+		{
+			u32 next = mNodes[c].mNextSibling;
+			mNodes[c].mPrevSibling = mNodes[c].mNextSibling = kInvalidNode;
+			mParents[c] = kInvalidNode;
+			MarkDirty(c);
+			++mWorldVersion[c];
+			c = next;
+		}
+		mNodes[node].mFirstChild = kInvalidNode;
+		Unlink(node);
+
+		// the slot stays until the order is rebuilt
+		if (comp)
+			LeaveNode(comp, mNodes[node].mb3D, mWorldVersion[node]);
+		mNodes[node].mComp = CompHandle();
+		mbOrderDirty = true;
+	}
+
+	// Breadth first from the roots: each depth is a contiguous range and
+	// the children of a node are contiguous. Removed nodes and roots without
+	// children leave.
+	void TransformHierarchy::Rebuild()
+	{
+		// destroyed without Shutdown (ex: deleted directly)
+		for (u32 i = 0; i < mNodes.size(); ++i)
+		{
+			if (!mNodes[i].mComp.IsNull() && !IComp::Get(mNodes[i].mComp))
+				RemoveNode(i, NULL);
+		}
+
+		AEX_ARRAY(u32) order;
+		order.reserve(mNodes.size());
+		for (u32 i = 0; i < mNodes.size(); ++i)
+		{
+			if (mParents[i] == kInvalidNode && mNodes[i].mFirstChild != kInvalidNode)
+				order.push_back(i);
+		}
+		mLevels.clear();
+		for (u32 begin = 0; begin < order.size();)
+		{
+			u32 end = order.size();
+			mLevels.push_back(begin);
+			for (u32 k = begin; k < end; ++k)
+			{
+				for (u32 c = mNodes[order[k]].mFirstChild; c != kInvalidNode; c = mNodes[c].mNextSibling)
+					order.push_back(c);
+			}
+			begin = end;
+		}
+		mLevels.push_back(order.size());
+
+		// old -> new slot. The lonely roots forget their node.
+		AEX_ARRAY(u32) remap(mNodes.size(), kInvalidNode);
+		for (u32 k = 0; k < order.size(); ++k)
+			remap[order[k]] = k;
+		for (u32 i = 0; i < mNodes.size(); ++i)
+		{
+			IComp * comp;
+			if (remap[i] == kInvalidNode && (comp = IComp::Get(mNodes[i].mComp)) != NULL)
+				LeaveNode(comp, mNodes[i].mb3D, mWorldVersion[i]);
+		}
+
+		AEX_ARRAY(Node) nodes(order.size());
+		AEX_ARRAY(u32) parents(order.size());
+		AEX_ARRAY(u8) dirty(order.size());
+		AEX_ARRAY(AEMtx44) local(order.size()), world(order.size());
+		AEX_ARRAY(u32) worldVersion(order.size());
+		for (u32 k = 0; k < order.size(); ++k)
+		{
+			u32 i = order[k];
+			Node & n = nodes[k];
+			n = mNodes[i];
+			n.mFirstChild = n.mFirstChild != kInvalidNode ? remap[n.mFirstChild] : kInvalidNode;
+			n.mNextSibling = n.mNextSibling != kInvalidNode ? remap[n.mNextSibling] : kInvalidNode;
+			n.mPrevSibling = n.mPrevSibling != kInvalidNode ? remap[n.mPrevSibling] : kInvalidNode;
+			parents[k] = mParents[i] != kInvalidNode ? remap[mParents[i]] : kInvalidNode;
+			dirty[k] = mDirty[i];
+			local[k] = mLocal[i];
+			world[k] = mWorld[i];
+			worldVersion[k] = mWorldVersion[i];
+			SetNodeOf(IComp::Get(n.mComp), n.mb3D, k);
+		}
+		mNodes.swap(nodes);
+		mParents.swap(parents);
+		mDirty.swap(dirty);
+		mLocal.swap(local);
+		mWorld.swap(world);
+		mWorldVersion.swap(worldVersion);
+		mbOrderDirty = false;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// PROPAGATION
+
+	void TransformHierarchy::Update()
+	{
+		mUpdatedCount.store(0, std::memory_order_relaxed);
+		if (mbOrderDirty)
+			Rebuild();
+		if (!mbAnyDirty.exchange(false, std::memory_order_relaxed) || mNodes.empty())
+			return;
+
+		// one level at a time: its parents are all done
+		mbUpdating = true;
+		for (u32 level = 0; level + 1 < mLevels.size(); ++level)
+		{
+			u32 first = mLevels[level], count = mLevels[level + 1] - first;
+			if (mbParallel && count >= kParallelMinCount)
+			{
+				aexJobSystem->ParallelFor(count, kBatchSize, [this, first](u32 begin, u32 end)
+				{
+					PropagateRange(first + begin, first + end);
+				});
+			}
+			else
+				PropagateRange(first, first + count);
+		}
+		mbUpdating = false;
+
+		memset(&mDirty[0], 0, mDirty.size());
+		if (mbStaleFound.exchange(false, std::memory_order_relaxed))
+			RemoveStaleNodes();
+	}
+
+	// a node is recomputed if it or its parent is dirty; it then is dirty
+	// for its own children. Only the transforms that changed are read.
+	void TransformHierarchy::PropagateRange(u32 begin, u32 end)
+	{
+		u32 updated = 0;
+		for (u32 i = begin; i < end; ++i)
+		{
+			u32 parent = mParents[i];
+			u8 dirty = mDirty[i];
+			if (parent != kInvalidNode && mDirty[parent])
+				dirty |= kParentChanged;
+			if (!dirty)
+				continue;
+			mDirty[i] = dirty;
+
+			if (dirty & kLocalChanged)
+			{
+				IComp * comp = IComp::Get(mNodes[i].mComp);
+				if (!comp)
+				{
+					// not dirty for its children: they keep the world they got
+					// from it until RemoveStaleNodes makes them dirty roots
+					mDirty[i] = 0;
+					mbStaleFound.store(true, std::memory_order_relaxed);
+					continue;
+				}
+				mLocal[i] = GetLocalOf(comp, mNodes[i].mb3D);
+			}
+			if (parent != kInvalidNode)
+				mWorld[i] = mWorld[parent] * mLocal[i];
+			else
+				mWorld[i] = mLocal[i];
+			++mWorldVersion[i];
+			++updated;
+		}
+		mUpdatedCount.fetch_add(updated, std::memory_order_relaxed);
+	}
+
+	void TransformHierarchy::RemoveStaleNodes()
+	{
+		for (u32 i = 0; i < mNodes.size(); ++i)
+		{
+			if (!mNodes[i].mComp.IsNull() && !IComp::Get(mNodes[i].mComp))
+				RemoveNode(i, NULL);
+		}
+	}
+	#pragma endregion
+}
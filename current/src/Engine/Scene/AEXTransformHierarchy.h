@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXTransformHierarchy.h
+// Purpose:	Parent/child links between transform components and the
+//			propagation of their world matrices
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_TRANSFORM_HIERARCHY_H_
+#define AEX_TRANSFORM_HIERARCHY_H_
+
+#include <atomic>
+#include <aexmath\AEXMath.h>
+#include "..\Composition\AEXComponent.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	TransformHierarchy
+	// \brief	World matrices of the transforms that have a parent or children
+	//			(TransformComp and TransformComp3D, mixed freely). The others
+	//			never enter it: their world matrix is their local one.
+	//
+	//	The nodes are sorted breadth first: parents before children, one
+	//	contiguous range per depth. Changing a transform marks its node dirty;
+	//	Update walks the levels in order and recomputes the dirty nodes and
+	//	everything under them (world = parent world * local), reading the
+	//	parents from the level before. The local matrices are copied in the
+	//	nodes: only the transforms that changed are read, the rest of the
+	//	subtree is linear in the node arrays. Levels with many nodes are split
+	//	on the job system. Linking and unlinking only flag the order, which is
+	//	rebuilt at the start of the next Update.
+	//
+	//	Main thread, except MarkDirty (called by the transform setters), which
+	//	any thread can call for its own nodes as long as Update isn't running.
+	class TransformHierarchy : public ISystem
+	{
+		AEX_RTTI_DECL(TransformHierarchy, ISystem);
+		AEX_SINGLETON(TransformHierarchy);
+
+	public:
+		static const u32 kInvalidNode = 0xFFFFFFFF;
+		static const u32 kBatchSize = 256;				// nodes per parallel task
+		static const u32 kParallelMinCount = 2048;		// smaller levels run on the calling thread
+
+		virtual ~TransformHierarchy();
+
+		// propagates the dirty subtrees. Scheduled once per frame, before rendering.
+		virtual void Update();
+
+		// ------------------------------------------------------------------------
+		// structure. child and parent are transform components on game objects.
+		// A NULL parent detaches. Fails (and changes nothing) if parent is in
+		// child's subtree. The child keeps its local transform: it moves with
+		// the parent from now on.
+		bool SetParent(IComp * child, IComp * parent);
+		IComp * GetParent(const IComp * comp) const;
+		u32 GetChildren(const IComp * comp, AEX_PTR_ARRAY(IComp) & out) const;	// appends, returns how many
+		void Remove(IComp * comp);		// detaches the children too. Called by the transforms' Shutdown, Reset and Recycle
+
+		// ------------------------------------------------------------------------
+		// nodes, as stored in the transforms. The world matrix is the one of the
+		// last Update (or of SetParent, for a new child).
+		void MarkDirty(u32 node) { mDirty[node] = kLocalChanged; mbAnyDirty.store(true, std::memory_order_relaxed); }
+		bool HasParent(u32 node) const { return mParents[node] != kInvalidNode; }
+		const AEMtx44 & GetWorld(u32 node) const { return mWorld[node]; }
+		u32 GetWorldVersion(u32 node) const { return mWorldVersion[node]; }	// bumped when the world matrix changes
+
+		// ------------------------------------------------------------------------
+		// stats
+		u32 GetNodeCount() const { return mNodes.size(); }
+		u32 GetLevelCount() const { return mLevels.empty() ? 0 : mLevels.size() - 1; }
+		u32 GetUpdatedCount() const { return mUpdatedCount; }	// nodes recomputed by the last Update
+
+		// false propagates everything on the calling thread. Defaults to true.
+		void SetParallel(bool enabled) { mbParallel = enabled; }
+		bool GetParallel() const { return mbParallel; }
+
+	private:
+		enum { kLocalChanged = 1, kParentChanged = 2 };	// mDirty
+
+		// structure, not touched by the propagation
+		struct Node
+		{
+			CompHandle	mComp;			// null once removed
+			u32			mFirstChild;
+			u32			mNextSibling;
+			u32			mPrevSibling;
+			bool		mb3D;			// TransformComp3D, else TransformComp
+		};
+
+		// TransformComp or TransformComp3D
+		static bool IsTransform(const IComp * comp, bool & is3D);
+		static u32 GetNodeOf(const IComp * comp, bool is3D);
+		static void SetNodeOf(IComp * comp, bool is3D, u32 node);
+		static const AEMtx44 & GetLocalOf(IComp * comp, bool is3D);
+		static void LeaveNode(IComp * comp, bool is3D, u32 worldVersion);	// keeps its version going up
+
+		u32 FindNode(const IComp * comp) const;		// kInvalidNode if comp isn't in the hierarchy
+		u32 AddNode(IComp * comp, bool is3D);
+		void RemoveNode(u32 node, IComp * comp);	// comp: NULL if destroyed
+		void Unlink(u32 node);						// from its parent's children
+		void Rebuild();								// breadth first order, drops the removed and lonely nodes
+		void PropagateRange(u32 begin, u32 end);
+		void RemoveStaleNodes();
+
+		// one entry per node, breadth first once rebuilt
+		AEX_ARRAY(Node)			mNodes;
+		AEX_ARRAY(u32)			mParents;
+		AEX_ARRAY(u8)			mDirty;
+		AEX_ARRAY(AEMtx44)		mLocal;
+		AEX_ARRAY(AEMtx44)		mWorld;
+		AEX_ARRAY(u32)			mWorldVersion;
+
+		AEX_ARRAY(u32)			mLevels;		// first node of each depth, then the node count
+		bool					mbOrderDirty;
+		std::atomic<bool>		mbAnyDirty;
+		std::atomic<bool>		mbStaleFound;	// a dirty node's component was destroyed without Shutdown
+		std::atomic<u32>		mUpdatedCount;
+		bool					mbParallel;
+		bool					mbUpdating;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexTransformHierarchy (AEX::TransformHierarchy::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
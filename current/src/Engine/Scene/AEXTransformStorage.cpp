@@ -0,0 +1,187 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXTransformStorage.cpp
+// Purpose:	SoA copy of the 2D transforms and the per frame pass that builds
+//			all their model matrices
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include "AEXTransformStorage.h"
+#include "AEXTransformComp.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	const u32 TransformStorage::kInvalidSlot;
+	const u32 TransformStorage::kBatchSize;
+	const u32 TransformStorage::kParallelMinCount;
+
+	TransformStorage::TransformStorage()
+		: mbAnyStale(false)
+		, mbDeadFound(false)
+		, mbAutoAdd(false)
+		, mbParallel(true)
+		, mbUpdating(false)
+	{}
+	TransformStorage::~TransformStorage()
+	{
+		Clear();
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// MEMBERSHIP
+
+	void TransformStorage::Resize(u32 count)
+	{
+		mComps.resize(count);
+		mPosX.resize(count);
+		mPosY.resize(count);
+		mPosZ.resize(count);
+		mScaleX.resize(count);
+		mScaleY.resize(count);
+		mCos.resize(count);
+		mSin.resize(count);
+		mStale.resize(count);
+		mModel.resize(count);
+	}
+
+	void TransformStorage::Add(TransformComp * comp)
+	{
+		DebugAssert(!mbUpdating, "TransformStorage::Add during Update");
+		if (DebugErrorIf(!comp || comp->GetHandle().IsNull(), "TransformStorage::Add: the transform isn't on a game object"))
+			return;
+		if (comp->mStorageSlot != kInvalidSlot)
+			return;
+
+		u32 slot = mComps.size();
+		Resize(slot + 1);
+		mComps[slot] = comp->GetHandle();
+		mStale[slot] = 0;
+		Write(slot, comp->mLocal);
+		mModel[slot] = comp->GetLocalToParent4x4();
+		comp->mStorageSlot = slot;
+	}
+
+	void TransformStorage::Remove(TransformComp * comp)
+	{
+		DebugAssert(!mbUpdating, "TransformStorage::Remove during Update");
+		u32 slot = comp->mStorageSlot;
+		if (slot == kInvalidSlot)
+			return;
+		comp->mStorageSlot = kInvalidSlot;
+
+		// the handle is already gone when Shutdown runs: trust the slot then
+		if (DebugErrorIf(slot >= mComps.size() || (!comp->GetHandle().IsNull() && comp->GetHandle() != mComps[slot]),
+			"TransformStorage::Remove: the transform's slot belongs to another one"))
+			return;
+		RemoveSlot(slot);
+	}
+
+	void TransformStorage::RemoveSlot(u32 slot)
+	{
+		u32 last = mComps.size() - 1;
+		if (slot != last)
+		{
+			mComps[slot] = mComps[last];
+			mPosX[slot] = mPosX[last];
+			mPosY[slot] = mPosY[last];
+			mPosZ[slot] = mPosZ[last];
+			mScaleX[slot] = mScaleX[last];
+			mScaleY[slot] = mScaleY[last];
+			mCos[slot] = mCos[last];
+			mSin[slot] = mSin[last];
+			mStale[slot] = mStale[last];
+			mModel[slot] = mModel[last];
+			if (TransformComp * moved = static_cast<TransformComp*>(IComp::Get(mComps[slot])))
+				moved->mStorageSlot = slot;
+			else
+				mbDeadFound.store(true, std::memory_order_relaxed);
+		}
+		Resize(last);
+	}
+
+	// the transforms destroyed without Shutdown (ex: deleted directly) leave
+	// a handle that doesn't resolve anymore
+	void TransformStorage::RemoveDeadSlots()
+	{
+		for (u32 slot = 0; slot < mComps.size();)
+		{
+			if (!IComp::Get(mComps[slot]))
+				RemoveSlot(slot);	// the moved slot is checked next
+			else
+				++slot;
+		}
+		mbDeadFound.store(false, std::memory_order_relaxed);
+	}
+
+	void TransformStorage::Clear()
+	{
+		DebugAssert(!mbUpdating, "TransformStorage::Clear during Update");
+		// the transforms still stored forget their slot
+		FOR_EACH(it, mComps)
+		{
+			if (TransformComp * comp = static_cast<TransformComp*>(IComp::Get(*it)))
+				comp->mStorageSlot = kInvalidSlot;
+		}
+		Resize(0);
+		mbAnyStale.store(false, std::memory_order_relaxed);
+		mbDeadFound.store(false, std::memory_order_relaxed);
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// UPDATE
+
+	void TransformStorage::Write(u32 slot, const Transform & local)
+	{
+		WritePosition(slot, local.mTranslationZ);
+		WriteScale(slot, local.mScale);
+		WriteRotation(slot, local.mOrientation);
+	}
+
+	// the transforms changed through EditLocal: the only ones read this frame
+	void TransformStorage::ReadStale()
+	{
+		for (u32 slot = 0; slot < mStale.size(); ++slot)
+		{
+			if (!mStale[slot])
+				continue;
+			mStale[slot] = 0;
+			if (TransformComp * comp = static_cast<TransformComp*>(IComp::Get(mComps[slot])))
+				Write(slot, comp->mLocal);
+			else
+				mbDeadFound.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	void TransformStorage::BuildRange(u32 begin, u32 end)
+	{
+		AEMtx44BuildTRS2DSoA(&mModel[begin], &mPosX[begin], &mPosY[begin], &mPosZ[begin],
+			&mScaleX[begin], &mScaleY[begin], &mCos[begin], &mSin[begin], end - begin);
+	}
+
+	void TransformStorage::Update()
+	{
+		if (mbAnyStale.exchange(false, std::memory_order_relaxed))
+			ReadStale();
+		if (mbDeadFound.exchange(false, std::memory_order_relaxed))
+			RemoveDeadSlots();
+
+		u32 count = mComps.size();
+		if (!count)
+			return;
+
+		mbUpdating = true;
+		if (mbParallel && count >= kParallelMinCount)
+		{
+			aexJobSystem->ParallelFor(count, kBatchSize, [this](u32 begin, u32 end)
+			{
+				BuildRange(begin, end);
+			});
+		}
+		else
+			BuildRange(0, count);
+		mbUpdating = false;
+	}
+	#pragma endregion
+}
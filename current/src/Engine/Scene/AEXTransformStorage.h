@@ -0,0 +1,124 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXTransformStorage.h
+// Purpose:	SoA copy of the 2D transforms and the per frame pass that builds
+//			all their model matrices
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_TRANSFORM_STORAGE_H_
+#define AEX_TRANSFORM_STORAGE_H_
+
+#include <atomic>
+#include <aexmath\AEXMath.h>
+#include "..\Composition\AEXComponent.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	class TransformComp;
+
+	// ----------------------------------------------------------------------------
+	// \class	TransformStorage
+	// \brief	Optional storage for the TransformComp: translation, scale and
+	//			rotation (as its cosine and sine) of every stored transform,
+	//			one array per field. Update builds all their model matrices in
+	//			one SIMD pass, without touching the components, into a packed
+	//			array that can be uploaded as is as per instance data (row
+	//			major AEMtx44, the layout of the matrix uniforms).
+	//
+	//	A stored transform is a view on its slot: its setters write the
+	//	fields they change there (the sine and cosine are computed then, not
+	//	every frame). The component keeps its Transform for GetLocal, the
+	//	serialization and the prefabs; changes through EditLocal are read
+	//	back at the start of the next Update. Removing a transform moves the
+	//	last slot in its place: slots are stable between two Add/Remove only.
+	//
+	//	The matrices are the local ones, which are the model to world ones of
+	//	the transforms without a parent. Children keep theirs in the
+	//	TransformHierarchy (TransformComp::GetModelToWorld4x4). Renderable
+	//	draws the stored transforms outside the hierarchy with these
+	//	matrices: they are up to date between Update and the next change.
+	//
+	//	Nothing is stored unless asked: Add, or SetAutoAdd(true) before the
+	//	objects are created. Main thread, except the writes from the
+	//	transforms, which any thread can do for its own slot as long as
+	//	Update isn't running.
+	class TransformStorage : public ISystem
+	{
+		AEX_RTTI_DECL(TransformStorage, ISystem);
+		AEX_SINGLETON(TransformStorage);
+
+	public:
+		static const u32 kInvalidSlot = 0xFFFFFFFF;
+		static const u32 kBatchSize = 4096;				// matrices per parallel task
+		static const u32 kParallelMinCount = 16384;		// smaller storages run on the calling thread
+
+		virtual ~TransformStorage();
+
+		// builds the model matrices. Scheduled once per frame, before rendering.
+		virtual void Update();
+
+		// ------------------------------------------------------------------------
+		// membership. comp must be on a game object.
+		void Add(TransformComp * comp);
+		void Remove(TransformComp * comp);		// called by the transform's Shutdown and Recycle
+		void Clear();
+
+		// true: every TransformComp initialized from now on is added. Defaults to false.
+		void SetAutoAdd(bool enabled) { mbAutoAdd = enabled; }
+		bool GetAutoAdd() const { return mbAutoAdd; }
+
+		// ------------------------------------------------------------------------
+		// results of the last Update, one per slot. GetComp pairs a matrix with
+		// its transform (ex: to find the renderable of the same object).
+		u32 GetCount() const { return mComps.size(); }
+		const AEMtx44 * GetModelMatrices() const { return mModel.empty() ? NULL : &mModel[0]; }
+		const AEMtx44 & GetModelMatrix(u32 slot) const { return mModel[slot]; }
+		CompHandle GetComp(u32 slot) const { return mComps[slot]; }
+
+		// ------------------------------------------------------------------------
+		// writes, by the transforms. Read at the next Update.
+		void WritePosition(u32 slot, const AEVec3 & pos) { mPosX[slot] = pos.x; mPosY[slot] = pos.y; mPosZ[slot] = pos.z; }
+		void WriteScale(u32 slot, const AEVec2 & scale) { mScaleX[slot] = scale.x; mScaleY[slot] = scale.y; }
+		void WriteRotation(u32 slot, f32 angle) { mCos[slot] = cosf(angle); mSin[slot] = sinf(angle); }
+		void Write(u32 slot, const Transform & local);
+		void MarkStale(u32 slot) { mStale[slot] = 1; mbAnyStale.store(true, std::memory_order_relaxed); }	// read the whole transform back
+
+		// false builds everything on the calling thread. Defaults to true.
+		void SetParallel(bool enabled) { mbParallel = enabled; }
+		bool GetParallel() const { return mbParallel; }
+
+	private:
+		void Resize(u32 count);
+		void RemoveSlot(u32 slot);			// the last slot fills the hole
+		void BuildRange(u32 begin, u32 end);
+		void ReadStale();
+		void RemoveDeadSlots();
+
+		// one entry per slot
+		AEX_ARRAY(CompHandle)	mComps;
+		AEX_ARRAY(f32)			mPosX;
+		AEX_ARRAY(f32)			mPosY;
+		AEX_ARRAY(f32)			mPosZ;
+		AEX_ARRAY(f32)			mScaleX;
+		AEX_ARRAY(f32)			mScaleY;
+		AEX_ARRAY(f32)			mCos;
+		AEX_ARRAY(f32)			mSin;
+		AEX_ARRAY(u8)			mStale;
+		AEX_ARRAY(AEMtx44)		mModel;
+
+		std::atomic<bool>		mbAnyStale;
+		std::atomic<bool>		mbDeadFound;	// a stored transform was destroyed without Shutdown
+		bool					mbAutoAdd;
+		bool					mbParallel;
+		bool					mbUpdating;
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to singleton
+#define aexTransformStorage (AEX::TransformStorage::Instance())
+
+// ----------------------------------------------------------------------------
+#endif
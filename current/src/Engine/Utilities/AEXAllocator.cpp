@@ -0,0 +1,440 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXAllocator.cpp
+// Purpose:	General engine allocator: thread caches per size class and
+//			allocation stats per system tag
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#ifdef _WIN32
+	#include <malloc.h>		// _aligned_malloc
+#else
+	#include <cstdlib>		// posix_memalign
+#endif
+#include "AEXAllocator.h"
+#include "AEXContainers.h"
+#include "..\Debug\MyDebug.h"
+#include "..\Debug\AEXAllocTracker.h"
+
+namespace AEX
+{
+	const u32 EngineAllocator::kAlignment;
+	const u32 EngineAllocator::kMaxSmallSize;
+
+	namespace
+	{
+		const u32 kSpanSize = 64 * 1024;
+
+		// 16 to 256 by 16, then 4 classes per power of two up to 2048
+		const u32 kClassSizes[] = {
+			16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+			320, 384, 448, 512, 640, 768, 896, 1024, 1280, 1536, 1792, 2048 };
+		const u32 kClassCount = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+
+		// size (in 16 bytes units, rounded up) -> class
+		struct SizeClassTable
+		{
+			u8 mClass[EngineAllocator::kMaxSmallSize / 16 + 1];
+			SizeClassTable()
+			{
+				u32 c = 0;
+				for (u32 units = 0; units <= EngineAllocator::kMaxSmallSize / 16; ++units)
+				{
+					while (kClassSizes[c] < units * 16)
+						++c;
+					mClass[units] = (u8)c;
+				}
+			}
+		};
+		// function static: allocations can happen during static init
+		inline u32 SizeToClass(u32 size)
+		{
+			static const SizeClassTable sTable;
+			return sTable.mClass[(size + 15) / 16];
+		}
+
+		// blocks taken from or given back to the global lists at once
+		inline u32 BatchCount(u32 c)
+		{
+			u32 count = 16 * 1024 / kClassSizes[c];
+			return count < 4 ? 4 : count > 64 ? 64 : count;
+		}
+
+		// spans and big blocks. Not operator new: it is only 8 bytes aligned
+		// on Win32, and the AllocTracker would count the blocks a second time.
+		void * AlignedAlloc(size_t size)
+		{
+		#ifdef _WIN32
+			void * ptr = _aligned_malloc(size, EngineAllocator::kAlignment);
+		#else
+			void * ptr = NULL;
+			if (posix_memalign(&ptr, EngineAllocator::kAlignment, size) != 0)
+				ptr = NULL;
+		#endif
+			if (!ptr)
+				throw std::bad_alloc();
+			return ptr;
+		}
+		void AlignedFree(void * ptr)
+		{
+		#ifdef _WIN32
+			_aligned_free(ptr);
+		#else
+			free(ptr);
+		#endif
+		}
+
+		struct FreeNode { FreeNode * mNext; };
+
+		// ------------------------------------------------------------------------
+		// global free list of a size class
+		struct CentralList
+		{
+			std::mutex	mMutex;
+			FreeNode *	mHead = NULL;
+
+			// count nodes (or less) to out, returns how many
+			u32 Pop(u32 c, u32 count, FreeNode *& out)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (mHead == NULL)
+					CarveSpan(c);
+				u32 n = 0;
+				out = mHead;
+				FreeNode * last = NULL;
+				while (mHead && n < count)
+				{
+					last = mHead;
+					mHead = mHead->mNext;
+					++n;
+				}
+				last->mNext = NULL;
+				return n;
+			}
+			void Push(FreeNode * first, FreeNode * last)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				last->mNext = mHead;
+				mHead = first;
+			}
+			void CarveSpan(u32 c)
+			{
+				u32 size = kClassSizes[c];
+				u8 * span = static_cast<u8*>(AlignedAlloc(kSpanSize));
+				for (u32 offset = kSpanSize / size * size; offset > 0; offset -= size)
+				{
+					FreeNode * node = reinterpret_cast<FreeNode*>(span + offset - size);
+					node->mNext = mHead;
+					mHead = node;
+				}
+			}
+		};
+
+		// per tag counters. Atomics so that the stats can read other threads'
+		// counters; they are only written by their thread (relaxed, no contention).
+		struct TagCounters
+		{
+			std::atomic<u64> mAllocBytes[eMT_Count];
+			std::atomic<u64> mAllocCount[eMT_Count];
+			std::atomic<u64> mFreeBytes[eMT_Count];
+			std::atomic<u64> mFreeCount[eMT_Count];
+
+			TagCounters()
+			{
+				for (u32 t = 0; t < eMT_Count; ++t)
+					mAllocBytes[t] = mAllocCount[t] = mFreeBytes[t] = mFreeCount[t] = 0;
+			}
+			void OnAlloc(EMemTag tag, u32 size)
+			{
+				mAllocBytes[tag].store(mAllocBytes[tag].load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+				mAllocCount[tag].store(mAllocCount[tag].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+			void OnFree(EMemTag tag, u32 size)
+			{
+				mFreeBytes[tag].store(mFreeBytes[tag].load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+				mFreeCount[tag].store(mFreeCount[tag].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		};
+
+		// ------------------------------------------------------------------------
+		// free lists and counters of one thread
+		struct ThreadCache
+		{
+			FreeNode *	mLists[kClassCount];
+			u32			mCounts[kClassCount];
+			TagCounters	mCounters;
+
+			ThreadCache()
+			{
+				for (u32 c = 0; c < kClassCount; ++c)
+				{
+					mLists[c] = NULL;
+					mCounts[c] = 0;
+				}
+			}
+		};
+
+		// ------------------------------------------------------------------------
+		// Never destroyed: blocks can be freed during static destruction.
+		struct Globals
+		{
+			CentralList				mLists[kClassCount];
+
+			std::mutex				mCachesMutex;
+			AEX_PTR_ARRAY(ThreadCache) mCaches;		// live threads
+			TagCounters				mRetired;		// exited threads, and threads without a cache
+
+			// totals at the start of the current frame, and the last frame deltas
+			u64						mFrameStartBytes[eMT_Count];
+			u64						mFrameStartCount[eMT_Count];
+			u64						mLastFrameBytes[eMT_Count];
+			u64						mLastFrameCount[eMT_Count];
+
+			Globals()
+			{
+				for (u32 t = 0; t < eMT_Count; ++t)
+					mFrameStartBytes[t] = mFrameStartCount[t] = mLastFrameBytes[t] = mLastFrameCount[t] = 0;
+			}
+		};
+		Globals & GetGlobals()
+		{
+			static Globals * sGlobals = new Globals();
+			return *sGlobals;
+		}
+
+		// ------------------------------------------------------------------------
+		// The cache is created on first use and flushed when the thread exits.
+		// After that (static destruction of the main thread) the calls go to
+		// the global lists directly.
+		thread_local ThreadCache *	tCache = NULL;
+		thread_local bool			tCacheDead = false;
+
+		void FlushCache(ThreadCache * cache)
+		{
+			Globals & globals = GetGlobals();
+			for (u32 c = 0; c < kClassCount; ++c)
+			{
+				FreeNode * first = cache->mLists[c];
+				if (!first)
+					continue;
+				FreeNode * last = first;
+				while (last->mNext)
+					last = last->mNext;
+				globals.mLists[c].Push(first, last);
+			}
+
+			std::lock_guard<std::mutex> lock(globals.mCachesMutex);
+			for (u32 t = 0; t < eMT_Count; ++t)
+			{
+				globals.mRetired.mAllocBytes[t] += cache->mCounters.mAllocBytes[t];
+				globals.mRetired.mAllocCount[t] += cache->mCounters.mAllocCount[t];
+				globals.mRetired.mFreeBytes[t] += cache->mCounters.mFreeBytes[t];
+				globals.mRetired.mFreeCount[t] += cache->mCounters.mFreeCount[t];
+			}
+			FOR_EACH(it, globals.mCaches)
+			{
+				if (*it == cache)
+				{
+					globals.mCaches.erase(it);
+					break;
+				}
+			}
+		}
+		struct CacheGuard
+		{
+			~CacheGuard()
+			{
+				if (tCache)
+				{
+					FlushCache(tCache);
+					delete tCache;
+					tCache = NULL;
+				}
+				tCacheDead = true;
+			}
+		};
+		thread_local CacheGuard tCacheGuard;
+
+		ThreadCache * GetCache()
+		{
+			if (tCache || tCacheDead)
+				return tCache;
+			(void)&tCacheGuard;	// odr-use: constructs the guard for this thread
+			tCache = new ThreadCache();
+			Globals & globals = GetGlobals();
+			std::lock_guard<std::mutex> lock(globals.mCachesMutex);
+			globals.mCaches.push_back(tCache);
+			return tCache;
+		}
+
+		// AllocTracker type of each tag: "EngineAllocator:<tag>"
+		u32 GetTrackerType(EMemTag tag)
+		{
+			struct TagTypes
+			{
+				u32 mTypes[eMT_Count];
+				TagTypes()
+				{
+					for (u32 t = 0; t < eMT_Count; ++t)
+						mTypes[t] = StringId::Intern((std::string("EngineAllocator:") + EngineAllocator::GetTagName(EMemTag(t))).c_str()).GetHash();
+				}
+			};
+			static const TagTypes sTagTypes;
+			return sTagTypes.mTypes[tag];
+		}
+
+		// sum of the counters of every thread. Called with mCachesMutex held.
+		void SumCounters(Globals & globals, u32 t, u64 & allocBytes, u64 & allocCount, u64 & freeBytes, u64 & freeCount)
+		{
+			allocBytes = globals.mRetired.mAllocBytes[t];
+			allocCount = globals.mRetired.mAllocCount[t];
+			freeBytes = globals.mRetired.mFreeBytes[t];
+			freeCount = globals.mRetired.mFreeCount[t];
+			FOR_EACH(it, globals.mCaches)
+			{
+				allocBytes += (*it)->mCounters.mAllocBytes[t].load(std::memory_order_relaxed);
+				allocCount += (*it)->mCounters.mAllocCount[t].load(std::memory_order_relaxed);
+				freeBytes += (*it)->mCounters.mFreeBytes[t].load(std::memory_order_relaxed);
+				freeCount += (*it)->mCounters.mFreeCount[t].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// ALLOCATION
+
+	void * EngineAllocator::Allocate(u32 size, EMemTag tag)
+	{
+		AllocTracker::OnTypedAlloc(GetTrackerType(tag), size);
+
+		ThreadCache * cache = GetCache();
+		if (cache)
+			cache->mCounters.OnAlloc(tag, size);
+		else
+		{
+			// no cache, counters are shared
+			GetGlobals().mRetired.mAllocBytes[tag] += size;
+			++GetGlobals().mRetired.mAllocCount[tag];
+		}
+
+		if (size > kMaxSmallSize)
+			return AlignedAlloc(size);
+		if (size == 0)
+			size = 1;
+
+		u32 c = SizeToClass(size);
+		if (!cache)
+		{
+			FreeNode * node;
+			GetGlobals().mLists[c].Pop(c, 1, node);
+			return node;
+		}
+		if (cache->mLists[c] == NULL)
+			cache->mCounts[c] = GetGlobals().mLists[c].Pop(c, BatchCount(c), cache->mLists[c]);
+
+		FreeNode * node = cache->mLists[c];
+		cache->mLists[c] = node->mNext;
+		--cache->mCounts[c];
+		return node;
+	}
+
+	void EngineAllocator::Free(void * ptr, u32 size, EMemTag tag)
+	{
+		if (!ptr)
+			return;
+		AllocTracker::OnTypedFree(GetTrackerType(tag), size);
+
+		ThreadCache * cache = GetCache();
+		if (cache)
+			cache->mCounters.OnFree(tag, size);
+		else
+		{
+			GetGlobals().mRetired.mFreeBytes[tag] += size;
+			++GetGlobals().mRetired.mFreeCount[tag];
+		}
+
+		if (size > kMaxSmallSize)
+		{
+			AlignedFree(ptr);
+			return;
+		}
+		if (size == 0)
+			size = 1;
+
+		u32 c = SizeToClass(size);
+		FreeNode * node = static_cast<FreeNode*>(ptr);
+		if (!cache)
+		{
+			GetGlobals().mLists[c].Push(node, node);
+			return;
+		}
+		node->mNext = cache->mLists[c];
+		cache->mLists[c] = node;
+
+		// too many: give a batch back so that other threads can use them
+		u32 batch = BatchCount(c);
+		if (++cache->mCounts[c] >= 2 * batch)
+		{
+			FreeNode * last = node;
+			for (u32 i = 1; i < batch; ++i)
+				last = last->mNext;
+			cache->mLists[c] = last->mNext;
+			cache->mCounts[c] -= batch;
+			GetGlobals().mLists[c].Push(node, last);
+		}
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// STATS
+
+	MemTagStats EngineAllocator::GetStats(EMemTag tag)
+	{
+		Globals & globals = GetGlobals();
+		std::lock_guard<std::mutex> lock(globals.mCachesMutex);
+		u64 allocBytes, allocCount, freeBytes, freeCount;
+		SumCounters(globals, tag, allocBytes, allocCount, freeBytes, freeCount);
+
+		MemTagStats stats;
+		stats.mLiveBytes = s64(allocBytes - freeBytes);
+		stats.mLiveCount = s64(allocCount - freeCount);
+		stats.mFrameAllocBytes = globals.mLastFrameBytes[tag];
+		stats.mFrameAllocCount = globals.mLastFrameCount[tag];
+		return stats;
+	}
+
+	const char * EngineAllocator::GetTagName(EMemTag tag)
+	{
+		static const char * sNames[eMT_Count] = { "General", "Graphics", "Logic", "Resources", "Serialization" };
+		return tag < eMT_Count ? sNames[tag] : "<invalid>";
+	}
+
+	void EngineAllocator::NewFrame()
+	{
+		Globals & globals = GetGlobals();
+		std::lock_guard<std::mutex> lock(globals.mCachesMutex);
+		for (u32 t = 0; t < eMT_Count; ++t)
+		{
+			u64 allocBytes, allocCount, freeBytes, freeCount;
+			SumCounters(globals, t, allocBytes, allocCount, freeBytes, freeCount);
+			globals.mLastFrameBytes[t] = allocBytes - globals.mFrameStartBytes[t];
+			globals.mLastFrameCount[t] = allocCount - globals.mFrameStartCount[t];
+			globals.mFrameStartBytes[t] = allocBytes;
+			globals.mFrameStartCount[t] = allocCount;
+		}
+	}
+
+	void EngineAllocator::PrintStats()
+	{
+		MyPrintFunction("%-16s %12s %10s %14s %12s\n", "Tag", "Live bytes", "Live", "Frame bytes", "Frame allocs");
+		for (u32 t = 0; t < eMT_Count; ++t)
+		{
+			MemTagStats stats = GetStats(EMemTag(t));
+			MyPrintFunction("%-16s %12lld %10lld %14llu %12llu\n", GetTagName(EMemTag(t)), stats.mLiveBytes, stats.mLiveCount,
+				stats.mFrameAllocBytes, stats.mFrameAllocCount);
+		}
+	}
+	#pragma endregion
+}
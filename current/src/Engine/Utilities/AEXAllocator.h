@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXAllocator.h
+// Purpose:	General engine allocator: thread caches per size class and
+//			allocation stats per system tag
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_ALLOCATOR_H_
+#define AEX_ALLOCATOR_H_
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include "..\Core\AEXDataTypes.h"
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// which system an allocation belongs to, for the stats
+	enum EMemTag { eMT_General, eMT_Graphics, eMT_Logic, eMT_Resources, eMT_Serialization, eMT_Count };
+
+	// stats of one tag. Live values are since the start, frame values are
+	// for the last complete frame (see EngineAllocator::NewFrame).
+	struct MemTagStats
+	{
+		s64 mLiveBytes;
+		s64 mLiveCount;
+		u64 mFrameAllocBytes;
+		u64 mFrameAllocCount;
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	EngineAllocator
+	// \brief	Sized allocations, tagged by system. All blocks are kAlignment
+	//			(16) bytes aligned.
+	//
+	//	Blocks up to kMaxSmallSize are rounded up to a size class. Each thread
+	//	keeps a free list per class, so most Allocate/Free calls take no lock.
+	//	An empty thread list is refilled with a batch from the global list of
+	//	the class (under that class' lock), which carves new 64KB spans when
+	//	it runs out; a thread list that gets too long gives a batch back. Spans
+	//	are never returned to the OS. Bigger blocks go to the aligned heap.
+	//
+	//	Like an STL allocator, Free needs the size and the tag the block was
+	//	allocated with. Blocks can be freed by any thread.
+	class EngineAllocator
+	{
+	public:
+		static const u32 kAlignment = 16;
+		static const u32 kMaxSmallSize = 2048;
+
+		static void * Allocate(u32 size, EMemTag tag = eMT_General);
+		static void Free(void * ptr, u32 size, EMemTag tag = eMT_General);
+
+		// constructs/destructs one T (exact type: the size must match)
+		template <typename T, typename... Args>
+		static T * New(EMemTag tag, Args &&... args)
+		{
+			return new (Allocate(sizeof(T), tag)) T(std::forward<Args>(args)...);
+		}
+		template <typename T>
+		static void Delete(T * obj, EMemTag tag)
+		{
+			if (!obj)
+				return;
+			obj->~T();
+			Free(obj, sizeof(T), tag);
+		}
+
+		// stats, summed over all the threads
+		static MemTagStats GetStats(EMemTag tag);
+		static const char * GetTagName(EMemTag tag);
+		static void PrintStats();	// one line per tag, through MyPrintFunction (all builds)
+
+		// closes the frame stats. Called by FRC::StartFrame.
+		static void NewFrame();
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	TaggedAllocator
+	// \brief	STL allocator on the EngineAllocator, with a fixed tag. See
+	//			AEX_TAGGED_ARRAY and co. in AEXContainers.h.
+	template <typename T, EMemTag Tag>
+	class TaggedAllocator
+	{
+	public:
+		typedef T value_type;
+		template <typename U> struct rebind { typedef TaggedAllocator<U, Tag> other; };
+
+		TaggedAllocator() {}
+		template <typename U>
+		TaggedAllocator(const TaggedAllocator<U, Tag> &) {}
+
+		T * allocate(size_t count)
+		{
+			static_assert(alignof(T) <= EngineAllocator::kAlignment, "over-aligned type");
+			return static_cast<T*>(EngineAllocator::Allocate(u32(count * sizeof(T)), Tag));
+		}
+		void deallocate(T * ptr, size_t count)
+		{
+			EngineAllocator::Free(ptr, u32(count * sizeof(T)), Tag);
+		}
+
+		template <typename U> bool operator==(const TaggedAllocator<U, Tag> &) const { return true; }
+		template <typename U> bool operator!=(const TaggedAllocator<U, Tag> &) const { return false; }
+	};
+}
+
+// ----------------------------------------------------------------------------
+#endif
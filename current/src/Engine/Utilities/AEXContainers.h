@@ -12,6 +12,13 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include "AEXHashMap.h"
+#include "AEXFlatMap.h"
+#include "AEXAllocator.h"
 
 // ----------------------------------------------------------------------------
 //	MACCRO
@@ -19,20 +26,273 @@
 	public:																	\
 		typedef std::vector<classname> ARRAY;								\
 		typedef std::list<classname>	LIST;								\
-		typedef std::map<std::string, classname> DICTIONARY;				\
+		typedef AEX::HashMap<std::string, classname> DICTIONARY;			\
 		typedef std::vector<classname*> PTR_ARRAY;							\
 		typedef std::list<classname*>	PTR_LIST;							\
-		typedef std::map<std::string, classname *> PTR_DICTIONARY;			\
+		typedef AEX::HashMap<std::string, classname *> PTR_DICTIONARY;		\
+
+// same as AEX_CONTAINERS, the arrays and lists allocate through the
+// EngineAllocator with the given EMemTag (the dictionaries don't take an
+// allocator).
+#define AEX_TAGGED_CONTAINERS(classname, tag)								\
+	public:																	\
+		typedef std::vector<classname, AEX::TaggedAllocator<classname, tag> > ARRAY;		\
+		typedef std::list<classname, AEX::TaggedAllocator<classname, tag> >	LIST;		\
+		typedef AEX::HashMap<std::string, classname> DICTIONARY;							\
+		typedef std::vector<classname*, AEX::TaggedAllocator<classname*, tag> > PTR_ARRAY;	\
+		typedef std::list<classname*, AEX::TaggedAllocator<classname*, tag> >	PTR_LIST;	\
+		typedef AEX::HashMap<std::string, classname *> PTR_DICTIONARY;						\
 
 #define AEX_ARRAY(classname) std::vector<classname> 
 #define AEX_LIST(classname) std::list<classname> 
-#define AEX_DICTIONARY(classname) std::map<std::string, classname> 
+#define AEX_DICTIONARY(classname) AEX::HashMap<std::string, classname> 
 #define AEX_PTR_ARRAY(classname) std::vector<classname*> 
 #define AEX_PTR_LIST(classname) std::list<classname*> 
-#define AEX_PTR_DICTIONARY(classname) std::map<std::string, classname*> 
-#define AEX_HASH_MAP(type1, type2) std::map<type1, type2>
+#define AEX_PTR_DICTIONARY(classname) AEX::HashMap<std::string, classname*> 
+#define AEX_HASH_MAP(type1, type2) AEX::HashMap<type1, type2>
+#define AEX_FLAT_MAP(type1, type2) AEX::FlatMap<type1, type2>
+#define AEX_SMALL_ARRAY(classname, count) AEX::SmallVector<classname, count>
+#define AEX_SMALL_PTR_ARRAY(classname, count) AEX::SmallVector<classname*, count>
 #define	AEX_STRING std::string
 
+// tagged variants (see AEX::EMemTag)
+#define AEX_TAGGED_ARRAY(classname, tag) std::vector<classname, AEX::TaggedAllocator<classname, tag> >
+#define AEX_TAGGED_LIST(classname, tag) std::list<classname, AEX::TaggedAllocator<classname, tag> >
+#define AEX_TAGGED_PTR_ARRAY(classname, tag) std::vector<classname*, AEX::TaggedAllocator<classname*, tag> >
+#define AEX_TAGGED_PTR_LIST(classname, tag) std::list<classname*, AEX::TaggedAllocator<classname*, tag> >
+
+// ----------------------------------------------------------------------------
+//	SMALL VECTOR
+#ifndef AEX_SMALL_VECTOR_H_
+#define AEX_SMALL_VECTOR_H_
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	SmallVector
+	// \brief	std::vector look-alike that keeps its first N elements inside
+	//			the object and only allocates when it grows past them. For short
+	//			per-object lists (components of a game object): no heap block
+	//			and no extra indirection while the list stays small.
+	//
+	//	Iterators are pointers. As with std::vector, growing invalidates
+	//	them; moving a SmallVector that is still inline moves the elements.
+	template <typename T, unsigned N>
+	class SmallVector
+	{
+	public:
+		typedef T			value_type;
+		typedef unsigned	size_type;
+		typedef T *			iterator;
+		typedef const T *	const_iterator;
+		typedef T &			reference;
+		typedef const T &	const_reference;
+		typedef std::reverse_iterator<iterator>			reverse_iterator;
+		typedef std::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+		SmallVector() : mData(InlineData()), mSize(0), mCapacity(N) {}
+		SmallVector(const SmallVector & other) : SmallVector()
+		{
+			reserve(other.mSize);
+			for (size_type i = 0; i < other.mSize; ++i)
+				new (mData + i) T(other.mData[i]);
+			mSize = other.mSize;
+		}
+		SmallVector(SmallVector && other) : SmallVector()
+		{
+			MoveFrom(other);
+		}
+		~SmallVector()
+		{
+			clear();
+			FreeHeap();
+		}
+		SmallVector & operator=(const SmallVector & other)
+		{
+			if (this != &other)
+			{
+				clear();
+				reserve(other.mSize);
+				for (size_type i = 0; i < other.mSize; ++i)
+					new (mData + i) T(other.mData[i]);
+				mSize = other.mSize;
+			}
+			return *this;
+		}
+		SmallVector & operator=(SmallVector && other)
+		{
+			if (this != &other)
+			{
+				clear();
+				FreeHeap();
+				MoveFrom(other);
+			}
+			return *this;
+		}
+
+		// --------------------------------------------------------------------
+		// iteration
+		iterator begin()						{ return mData; }
+		iterator end()							{ return mData + mSize; }
+		const_iterator begin() const			{ return mData; }
+		const_iterator end() const				{ return mData + mSize; }
+		reverse_iterator rbegin()				{ return reverse_iterator(end()); }
+		reverse_iterator rend()					{ return reverse_iterator(begin()); }
+		const_reverse_iterator rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const		{ return const_reverse_iterator(begin()); }
+
+		// --------------------------------------------------------------------
+		// access
+		T & operator[](size_type i)				{ return mData[i]; }
+		const T & operator[](size_type i) const	{ return mData[i]; }
+		T & front()								{ return mData[0]; }
+		const T & front() const					{ return mData[0]; }
+		T & back()								{ return mData[mSize - 1]; }
+		const T & back() const					{ return mData[mSize - 1]; }
+		T * data()								{ return mData; }
+		const T * data() const					{ return mData; }
+
+		// --------------------------------------------------------------------
+		// size
+		bool empty() const			{ return mSize == 0; }
+		size_type size() const		{ return mSize; }
+		size_type capacity() const	{ return mCapacity; }
+		bool IsInline() const		{ return mData == InlineData(); }
+
+		void reserve(size_type count)
+		{
+			if (count > mCapacity)
+				Grow(count);
+		}
+		void resize(size_type count)
+		{
+			reserve(count);
+			while (mSize > count)
+				mData[--mSize].~T();
+			while (mSize < count)
+				new (mData + mSize++) T();
+		}
+		// keeps the heap block, if any
+		void clear()
+		{
+			while (mSize)
+				mData[--mSize].~T();
+		}
+
+		// --------------------------------------------------------------------
+		// modifiers
+		void push_back(const T & value)
+		{
+			if (mSize == mCapacity)
+			{
+				T copy(value);	// value may live in this vector
+				Grow(mCapacity * 2);
+				new (mData + mSize++) T(std::move(copy));
+			}
+			else
+				new (mData + mSize++) T(value);
+		}
+		void push_back(T && value)
+		{
+			if (mSize == mCapacity)
+			{
+				T tmp(std::move(value));
+				Grow(mCapacity * 2);
+				new (mData + mSize++) T(std::move(tmp));
+			}
+			else
+				new (mData + mSize++) T(std::move(value));
+		}
+		void pop_back()
+		{
+			mData[--mSize].~T();
+		}
+		iterator insert(const_iterator pos, const T & value)
+		{
+			size_type index = size_type(pos - mData);
+			if (index == mSize)
+			{
+				push_back(value);
+				return mData + index;
+			}
+			T copy(value);
+			push_back(std::move(back()));
+			for (size_type i = mSize - 2; i > index; --i)
+				mData[i] = std::move(mData[i - 1]);
+			mData[index] = std::move(copy);
+			return mData + index;
+		}
+		iterator erase(const_iterator pos)
+		{
+			size_type index = size_type(pos - mData);
+			for (size_type i = index; i + 1 < mSize; ++i)
+				mData[i] = std::move(mData[i + 1]);
+			pop_back();
+			return mData + index;
+		}
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			size_type index = size_type(first - mData);
+			size_type count = size_type(last - first);
+			for (size_type i = index; i + count < mSize; ++i)
+				mData[i] = std::move(mData[i + count]);
+			for (size_type i = 0; i < count; ++i)
+				pop_back();
+			return mData + index;
+		}
+
+	private:
+		T * InlineData() { return reinterpret_cast<T*>(&mInline); }
+		const T * InlineData() const { return reinterpret_cast<const T*>(&mInline); }
+
+		void Grow(size_type count)
+		{
+			T * data = static_cast<T*>(::operator new(count * sizeof(T)));
+			for (size_type i = 0; i < mSize; ++i)
+			{
+				new (data + i) T(std::move(mData[i]));
+				mData[i].~T();
+			}
+			FreeHeap();
+			mData = data;
+			mCapacity = count;
+		}
+		void FreeHeap()
+		{
+			if (!IsInline())
+				::operator delete(mData);
+			mData = InlineData();
+			mCapacity = N;
+		}
+		// other is empty and inline afterwards
+		void MoveFrom(SmallVector & other)
+		{
+			if (other.IsInline())
+			{
+				for (size_type i = 0; i < other.mSize; ++i)
+					new (mData + i) T(std::move(other.mData[i]));
+				mSize = other.mSize;
+				other.clear();
+			}
+			else
+			{
+				// steal the heap block
+				mData = other.mData;
+				mSize = other.mSize;
+				mCapacity = other.mCapacity;
+				other.mData = other.InlineData();
+				other.mSize = 0;
+				other.mCapacity = N;
+			}
+		}
+
+		T *			mData;		// InlineData() or a heap block
+		size_type	mSize;
+		size_type	mCapacity;
+		typename std::aligned_storage<sizeof(T) * N, std::alignment_of<T>::value>::type mInline;
+	};
+}
+#endif // AEX_SMALL_VECTOR_H_
+
 #ifndef FOR_EACH
 	#define FOR_EACH(itName, container)												\
 		for(auto itName = (container).begin(); itName != (container).end(); ++itName)	
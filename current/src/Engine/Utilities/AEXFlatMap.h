@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXFlatMap.h
+// Purpose:	Map stored as a sorted array of pairs
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_FLAT_MAP_H_
+#define AEX_FLAT_MAP_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include "..\Core\AEXDataTypes.h"
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	FlatMap
+	// \brief	Sorted std::vector of pairs, searched with a binary search.
+	//
+	//	For small maps, or maps that are built once and then read: one
+	//	contiguous allocation, no per element node, ordered iteration. Insert
+	//	and erase shift the elements after the position, so they are O(n) and
+	//	invalidate iterators, pointers and references.
+	//
+	//	The default comparison is std::less<>, which is transparent: a map
+	//	keyed by std::string is searched with a const char * without building
+	//	a string. The keys are mutable through the iterators; changing one
+	//	breaks the order.
+	template <typename K, typename V, typename TLess = std::less<> >
+	class FlatMap
+	{
+	public:
+		typedef K									key_type;
+		typedef V									mapped_type;
+		typedef std::pair<K, V>						value_type;
+		typedef u32									size_type;
+		typedef typename std::vector<value_type>::iterator			iterator;
+		typedef typename std::vector<value_type>::const_iterator	const_iterator;
+
+		// --------------------------------------------------------------------
+		// iteration, by increasing key
+		iterator begin()				{ return mData.begin(); }
+		iterator end()					{ return mData.end(); }
+		const_iterator begin() const	{ return mData.begin(); }
+		const_iterator end() const		{ return mData.end(); }
+
+		// --------------------------------------------------------------------
+		// size
+		bool empty() const				{ return mData.empty(); }
+		size_type size() const			{ return mData.size(); }
+		void clear()					{ mData.clear(); }
+		void reserve(u32 count)			{ mData.reserve(count); }
+
+		// --------------------------------------------------------------------
+		// lookup, K or any type TLess compares with K
+		template <typename Q>
+		iterator lower_bound(const Q & key)
+		{
+			return std::lower_bound(mData.begin(), mData.end(), key, KeyLess());
+		}
+		template <typename Q>
+		const_iterator lower_bound(const Q & key) const
+		{
+			return std::lower_bound(mData.begin(), mData.end(), key, KeyLess());
+		}
+		template <typename Q>
+		iterator find(const Q & key)
+		{
+			iterator it = lower_bound(key);
+			return it != mData.end() && !mLess(key, it->first) ? it : mData.end();
+		}
+		template <typename Q>
+		const_iterator find(const Q & key) const
+		{
+			const_iterator it = lower_bound(key);
+			return it != mData.end() && !mLess(key, it->first) ? it : mData.end();
+		}
+		template <typename Q>
+		size_type count(const Q & key) const	{ return find(key) != end() ? 1 : 0; }
+
+		// --------------------------------------------------------------------
+		// insertion
+		V & operator[](const K & key)
+		{
+			iterator it = lower_bound(key);
+			if (it == mData.end() || mLess(key, it->first))
+				it = mData.insert(it, value_type(key, V()));
+			return it->second;
+		}
+		// doesn't overwrite an existing value
+		std::pair<iterator, bool> insert(const value_type & value)
+		{
+			iterator it = lower_bound(value.first);
+			if (it != mData.end() && !mLess(value.first, it->first))
+				return std::make_pair(it, false);
+			return std::make_pair(mData.insert(it, value), true);
+		}
+
+		// --------------------------------------------------------------------
+		// removal. Returns the element after the erased one.
+		iterator erase(const_iterator it)	{ return mData.erase(it); }
+		iterator erase(iterator it)			{ return mData.erase(it); }
+		size_type erase(const K & key)
+		{
+			iterator it = find(key);
+			if (it == mData.end())
+				return 0;
+			mData.erase(it);
+			return 1;
+		}
+
+	private:
+		// element < key, for lower_bound
+		struct KeyLess
+		{
+			TLess mLess;
+			template <typename Q> bool operator()(const value_type & a, const Q & b) const { return mLess(a.first, b); }
+		};
+
+		std::vector<value_type>	mData;
+		TLess					mLess;
+	};
+}
+
+// ----------------------------------------------------------------------------
+#endif
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXFrameArena.cpp
+// Purpose:	Linear allocators for per-frame temporaries
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstring>
+#include <mutex>
+#include "AEXFrameArena.h"
+#include "..\Debug\MyDebug.h"
+
+namespace AEX
+{
+	const u32 LinearArena::kDefaultBlockSize;
+	const u8 LinearArena::kPoison;
+
+	namespace
+	{
+		// every thread arena created so far. Owned here: the worker threads
+		// live as long as the engine.
+		struct ThreadArenas
+		{
+			std::mutex					mMutex;
+			AEX_PTR_ARRAY(FrameArena)	mArenas;
+
+			~ThreadArenas()
+			{
+				FOR_EACH(it, mArenas)
+					delete *it;
+			}
+		};
+		ThreadArenas & GetThreadArenas()
+		{
+			static ThreadArenas sArenas;
+			return sArenas;
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	#pragma region// LINEAR ARENA
+
+	LinearArena::LinearArena(u32 blockSize)
+		: mOffset(0)
+		, mUsedInPrevBlocks(0)
+		, mPeak(0)
+		, mBlockSize(blockSize)
+	{}
+	LinearArena::~LinearArena()
+	{
+		FOR_EACH(it, mBlocks)
+			delete[] it->mMemory;
+	}
+
+	void * LinearArena::Allocate(u32 size, u32 align)
+	{
+		if (mBlocks.empty())
+			AddBlock(size + align);
+
+		Block & block = mBlocks.back();
+		u32 start = (mOffset + u32(-(size_t)(block.mMemory + mOffset) & (align - 1)));
+		if (start + size > block.mSize)
+		{
+			AddBlock(size + align);
+			return Allocate(size, align);
+		}
+		mOffset = start + size;
+		if (GetUsed() > mPeak)
+			mPeak = GetUsed();
+		return mBlocks.back().mMemory + start;
+	}
+
+	void LinearArena::Reset()
+	{
+	#if AEX_FRAME_ARENA_POISON
+		for (u32 i = 0; i < mBlocks.size(); ++i)
+			memset(mBlocks[i].mMemory, kPoison, i + 1 < mBlocks.size() ? mBlocks[i].mSize : mOffset);
+	#endif
+
+		// overflowed: one block for the whole frame from now on
+		if (mBlocks.size() > 1)
+		{
+			u32 capacity = GetCapacity();
+			FOR_EACH(it, mBlocks)
+				delete[] it->mMemory;
+			mBlocks.clear();
+			AddBlock(capacity);
+		}
+		mOffset = 0;
+		mUsedInPrevBlocks = 0;
+	}
+
+	u32 LinearArena::GetCapacity() const
+	{
+		u32 capacity = 0;
+		FOR_EACH(it, mBlocks)
+			capacity += it->mSize;
+		return capacity;
+	}
+
+	void LinearArena::AddBlock(u32 minSize)
+	{
+		if (!mBlocks.empty())
+			mUsedInPrevBlocks += mBlocks.back().mSize;	// the rest of the block is lost
+		Block block;
+		block.mSize = minSize > mBlockSize ? minSize : mBlockSize;
+		block.mMemory = new u8[block.mSize];
+		mBlocks.push_back(block);
+		mOffset = 0;
+	}
+	#pragma endregion
+
+	// ----------------------------------------------------------------------------
+	#pragma region// FRAME ARENA
+
+	FrameArena::FrameArena()
+		: mCurrent(0)
+		, mFrame(0)
+	{}
+
+	void FrameArena::Flip()
+	{
+		mCurrent ^= 1;
+		mArenas[mCurrent].Reset();
+		++mFrame;
+	}
+
+	FrameArena & FrameArena::Get()
+	{
+		static thread_local FrameArena * tArena = NULL;
+		if (!tArena)
+		{
+			tArena = new FrameArena();
+			ThreadArenas & arenas = GetThreadArenas();
+			std::lock_guard<std::mutex> lock(arenas.mMutex);
+			arenas.mArenas.push_back(tArena);
+		}
+		return *tArena;
+	}
+
+	void FrameArena::NewFrame()
+	{
+		ThreadArenas & arenas = GetThreadArenas();
+		std::lock_guard<std::mutex> lock(arenas.mMutex);
+		FOR_EACH(it, arenas.mArenas)
+			(*it)->Flip();
+	}
+
+	void FrameArena::PrintStats()
+	{
+		ThreadArenas & arenas = GetThreadArenas();
+		std::lock_guard<std::mutex> lock(arenas.mMutex);
+		MyPrintFunction("%-20s %10s %10s %10s\n", "Frame arena", "Used", "Peak", "Capacity");
+		for (u32 i = 0; i < arenas.mArenas.size(); ++i)
+		{
+			FrameArena * arena = arenas.mArenas[i];
+			MyPrintFunction("thread arena %-7u %10u %10u %10u\n", i, arena->GetUsed(), arena->GetPeak(), arena->GetCapacity());
+		}
+	}
+	#pragma endregion
+}
@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXFrameArena.h
+// Purpose:	Linear allocators for per-frame temporaries
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_FRAME_ARENA_H_
+#define AEX_FRAME_ARENA_H_
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include "AEXContainers.h"
+
+// debug builds fill the memory of a frame with 0xDD when it is released, so
+// that pointers kept past their frame read garbage instead of stale data.
+#if defined(_DEBUG) && !defined(AEX_FRAME_ARENA_NO_POISON)
+	#define AEX_FRAME_ARENA_POISON 1
+#else
+	#define AEX_FRAME_ARENA_POISON 0
+#endif
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	LinearArena
+	// \brief	Bump allocator: an allocation moves an offset in the current
+	//			block, there is no free. Reset releases everything at once.
+	//
+	//	When a frame doesn't fit in the block, more blocks are added. Reset
+	//	replaces them with a single block big enough for all of them, so in
+	//	steady state an arena is one block and allocating never hits the heap.
+	class LinearArena
+	{
+	public:
+		static const u32 kDefaultBlockSize = 256 * 1024;
+		static const u8 kPoison = 0xDD;
+
+		LinearArena(u32 blockSize = kDefaultBlockSize);
+		~LinearArena();
+
+		void * Allocate(u32 size, u32 align = 16);
+		void Reset();
+
+		// stats
+		u32 GetUsed() const			{ return mUsedInPrevBlocks + mOffset; }	// including alignment padding
+		u32 GetPeak() const			{ return mPeak; }
+		u32 GetCapacity() const;
+
+	private:
+		struct Block
+		{
+			u8 *	mMemory;
+			u32		mSize;
+		};
+		void AddBlock(u32 minSize);
+
+		AEX_ARRAY(Block)	mBlocks;			// the last one is the current one
+		u32					mOffset;			// in the current block
+		u32					mUsedInPrevBlocks;
+		u32					mPeak;
+		u32					mBlockSize;
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	FrameArena
+	// \brief	Two linear arenas used on alternate frames. Memory allocated
+	//			during a frame stays valid until the end of the next frame, so a
+	//			frame can read what the previous one produced.
+	//
+	//	Each thread has its own FrameArena (Get), so jobs allocate without
+	//	locks. NewFrame, called by FRC::StartFrame, flips every thread's
+	//	arena: it must run on the main thread while no job is running. Nothing
+	//	is destructed, use it for trivially destructible data or through
+	//	FrameVector/FrameString, whose destructors release nothing.
+	class FrameArena
+	{
+	public:
+		FrameArena();
+
+		void * Allocate(u32 size, u32 align = 16) { return mArenas[mCurrent].Allocate(size, align); }
+
+		// uninitialized array of count T
+		template <typename T>
+		T * NewArray(u32 count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "FrameArena doesn't call destructors");
+			return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		// the other arena becomes current and is reset (two frames old)
+		void Flip();
+
+		// stats
+		u32 GetUsed() const			{ return mArenas[mCurrent].GetUsed(); }
+		u32 GetPeak() const			{ return mArenas[0].GetPeak() > mArenas[1].GetPeak() ? mArenas[0].GetPeak() : mArenas[1].GetPeak(); }
+		u32 GetCapacity() const		{ return mArenas[0].GetCapacity() + mArenas[1].GetCapacity(); }
+		u32 GetFrame() const		{ return mFrame; }
+
+		// the calling thread's arena, created on first use
+		static FrameArena & Get();
+
+		// flips all the thread arenas. Main thread, between frames.
+		static void NewFrame();
+
+		// all thread arenas, with their peak and capacity, through MyPrintFunction (all builds)
+		static void PrintStats();
+
+	private:
+		LinearArena		mArenas[2];
+		u32				mCurrent;
+		u32				mFrame;		// flips so far
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	FrameAllocator
+	// \brief	STL allocator in a FrameArena (the constructing thread's by
+	//			default). deallocate does nothing: the memory goes back when
+	//			the arena flips. A container using it must not outlive the next
+	//			frame, nor grow on another thread than its arena's.
+	template <typename T>
+	class FrameAllocator
+	{
+	public:
+		typedef T value_type;
+
+		FrameAllocator() : mArena(&FrameArena::Get()) {}
+		explicit FrameAllocator(FrameArena & arena) : mArena(&arena) {}
+		template <typename U>
+		FrameAllocator(const FrameAllocator<U> & other) : mArena(other.GetArena()) {}
+
+		T * allocate(size_t count)		{ return static_cast<T*>(mArena->Allocate(u32(count * sizeof(T)), alignof(T))); }
+		void deallocate(T *, size_t)	{}
+
+		FrameArena * GetArena() const	{ return mArena; }
+
+		template <typename U> bool operator==(const FrameAllocator<U> & other) const { return mArena == other.GetArena(); }
+		template <typename U> bool operator!=(const FrameAllocator<U> & other) const { return mArena != other.GetArena(); }
+
+	private:
+		FrameArena * mArena;
+	};
+
+	// frame containers
+	template <typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T> >;
+	typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char> > FrameString;
+}
+#pragma warning (default:4251) // dll and STL
+
+// Easy access to the calling thread's arena
+#define aexFrameArena (&AEX::FrameArena::Get())
+
+// ----------------------------------------------------------------------------
+#endif
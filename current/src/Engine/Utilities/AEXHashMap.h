@@ -0,0 +1,548 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXHashMap.h
+// Purpose:	Open addressing hash map (Swiss table) probed 16 slots at a time
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_HASH_MAP_H_
+#define AEX_HASH_MAP_H_
+
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include "..\Core\AEXDataTypes.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define AEX_HASH_MAP_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define AEX_HASH_MAP_SSE2 0
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \struct	StringView
+	// \brief	Non owning (pointer, length) string, for lookups in string keyed
+	//			maps without building a std::string.
+	struct StringView
+	{
+		const char *	mData;
+		u32				mSize;
+
+		StringView(const char * str) : mData(str), mSize((u32)strlen(str)) {}
+		StringView(const char * str, u32 size) : mData(str), mSize(size) {}
+		StringView(const std::string & str) : mData(str.data()), mSize((u32)str.size()) {}
+	};
+
+	namespace internal
+	{
+		// finalizer of MurmurHash3: spreads the bits of integer keys (ids,
+		// pointers, hashes of hashes) so that the 7 bits used by the control
+		// bytes and the bits used for the position are independent.
+		inline u64 MixHash(u64 h)
+		{
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+			return h;
+		}
+		// FNV-1a, same as StringId64 but on a sized range
+		inline u64 HashBytes(const char * data, u32 size)
+		{
+			u64 h = 14695981039346656037ull;
+			for (u32 i = 0; i < size; ++i)
+				h = (h ^ (u8)data[i]) * 1099511628211ull;
+			return h;
+		}
+
+		inline u32 CountTrailingZeros(u32 mask)
+		{
+		#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return index;
+		#else
+			return __builtin_ctz(mask);
+		#endif
+		}
+
+		// ------------------------------------------------------------------------
+		// Control bytes: one per slot. Full slots store the low 7 bits of the
+		// hash (H2), so a probe compares 16 of them at once and only touches the
+		// slots whose H2 matches.
+		typedef signed char ctrl_t;
+		const ctrl_t kEmpty = -128;		// 0b10000000
+		const ctrl_t kDeleted = -2;		// 0b11111110
+		const ctrl_t kSentinel = -1;	// 0b11111111, ends the iteration
+		const u32 kGroupWidth = 16;
+
+		inline bool IsFull(ctrl_t c) { return c >= 0; }
+
+		// the 16 control bytes starting at a position, as bit masks
+		struct Group
+		{
+		#if AEX_HASH_MAP_SSE2
+			__m128i mCtrl;
+			explicit Group(const ctrl_t * pos) : mCtrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+			u32 Match(ctrl_t h2) const		{ return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), mCtrl)); }
+			u32 MatchEmpty() const			{ return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(kEmpty), mCtrl)); }
+			u32 MatchEmptyOrDeleted() const	{ return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), mCtrl)); }
+		#else
+			// scalar fallback, same masks
+			const ctrl_t * mCtrl;
+			explicit Group(const ctrl_t * pos) : mCtrl(pos) {}
+
+			u32 Match(ctrl_t h2) const
+			{
+				u32 mask = 0;
+				for (u32 i = 0; i < kGroupWidth; ++i)
+					mask |= u32(mCtrl[i] == h2) << i;
+				return mask;
+			}
+			u32 MatchEmpty() const { return Match(kEmpty); }
+			u32 MatchEmptyOrDeleted() const
+			{
+				u32 mask = 0;
+				for (u32 i = 0; i < kGroupWidth; ++i)
+					mask |= u32(mCtrl[i] < kSentinel) << i;
+				return mask;
+			}
+		#endif
+		};
+
+		// a control block for tables that never allocated: begin() == end()
+		inline ctrl_t * EmptyCtrl()
+		{
+			static ctrl_t sEmpty[kGroupWidth] = { kSentinel, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty,
+												   kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty };
+			return sEmpty;
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	// \struct	Hasher
+	// \brief	Default hash of the engine maps. Integers, enums and pointers
+	//			are mixed; strings hash their characters and are transparent:
+	//			a map keyed by std::string is searched with a const char * or a
+	//			StringView without allocating.
+	template <typename T, typename Enable = void>
+	struct Hasher
+	{
+		u64 operator()(const T & key) const { return internal::MixHash((u64)std::hash<T>()(key)); }
+	};
+	template <typename T>
+	struct Hasher<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+	{
+		u64 operator()(T key) const { return internal::MixHash((u64)key); }
+	};
+	template <typename T>
+	struct Hasher<T*, void>
+	{
+		u64 operator()(const T * key) const { return internal::MixHash((u64)(size_t)key); }
+	};
+	template <>
+	struct Hasher<std::string, void>
+	{
+		typedef void is_transparent;
+		u64 operator()(const StringView & key) const { return internal::MixHash(internal::HashBytes(key.mData, key.mSize)); }
+	};
+
+	// \struct	KeyEqual
+	// \brief	operator==, transparent for strings like Hasher.
+	template <typename T>
+	struct KeyEqual
+	{
+		bool operator()(const T & a, const T & b) const { return a == b; }
+	};
+	template <>
+	struct KeyEqual<std::string>
+	{
+		typedef void is_transparent;
+		bool operator()(const std::string & a, const StringView & b) const
+		{
+			return a.size() == b.mSize && memcmp(a.data(), b.mData, b.mSize) == 0;
+		}
+	};
+
+	// ----------------------------------------------------------------------------
+	// \class	HashMap
+	// \brief	Open addressing hash map, with the std::map interface the engine
+	//			uses (find, operator[], insert, erase, iteration on pairs).
+	//
+	//	The slots and one control byte per slot live in a single allocation.
+	//	A lookup hashes the key once: the high bits pick the first group of 16
+	//	control bytes, the low 7 bits are compared against the whole group in
+	//	one SSE2 instruction. Only the slots that match are compared with the
+	//	key, and the search stops at the first group with an empty slot.
+	//	Groups are visited in triangular steps, which covers the whole table
+	//	since the capacity is a power of two. Erased slots become tombstones
+	//	that are cleared by the next rehash. The table grows at 7/8 full.
+	//
+	//	Unlike std::map, insertions that rehash move the elements: they
+	//	invalidate iterators, pointers and references. Erasing only
+	//	invalidates the erased element. The iteration order is unspecified.
+	template <typename K, typename V, typename THash = Hasher<K>, typename TEqual = KeyEqual<K> >
+	class HashMap
+	{
+		typedef internal::ctrl_t ctrl_t;
+
+	public:
+		typedef K						key_type;
+		typedef V						mapped_type;
+		typedef std::pair<const K, V>	value_type;
+		typedef u32						size_type;
+		typedef THash					hasher;
+		typedef TEqual					key_equal;
+
+		// --------------------------------------------------------------------
+		// walks the control bytes and skips the empty and erased slots. Stops
+		// at the sentinel after the last slot.
+		template <bool IsConst>
+		class Iterator
+		{
+			friend class HashMap;
+			typedef typename std::conditional<IsConst, const typename HashMap::value_type, typename HashMap::value_type>::type slot_type;
+
+		public:
+			typedef std::forward_iterator_tag	iterator_category;
+			typedef typename HashMap::value_type value_type;
+			typedef std::ptrdiff_t				difference_type;
+			typedef slot_type *					pointer;
+			typedef slot_type &					reference;
+
+			Iterator() : mCtrl(NULL), mSlot(NULL) {}
+			// iterator -> const_iterator
+			Iterator(const Iterator<false> & other) : mCtrl(other.mCtrl), mSlot(other.mSlot) {}
+
+			reference operator*() const		{ return *mSlot; }
+			pointer operator->() const		{ return mSlot; }
+			Iterator & operator++()			{ ++mCtrl; ++mSlot; SkipEmpty(); return *this; }
+			Iterator operator++(int)		{ Iterator tmp = *this; ++*this; return tmp; }
+			template <bool B> bool operator==(const Iterator<B> & other) const { return mCtrl == other.mCtrl; }
+			template <bool B> bool operator!=(const Iterator<B> & other) const { return mCtrl != other.mCtrl; }
+
+		private:
+			Iterator(ctrl_t * ctrl, slot_type * slot) : mCtrl(ctrl), mSlot(slot) {}
+			void SkipEmpty()
+			{
+				// empty and deleted are below the sentinel
+				while (*mCtrl < internal::kSentinel)
+				{
+					++mCtrl;
+					++mSlot;
+				}
+			}
+
+			ctrl_t *	mCtrl;
+			slot_type *	mSlot;
+			friend class Iterator<!IsConst>;
+		};
+		typedef Iterator<false>	iterator;
+		typedef Iterator<true>	const_iterator;
+
+		// --------------------------------------------------------------------
+		HashMap() : mCtrl(internal::EmptyCtrl()), mSlots(NULL), mCapacity(0), mSize(0), mGrowthLeft(0) {}
+		HashMap(const HashMap & other) : HashMap()
+		{
+			if (other.mSize)
+				Reserve(other.mSize);
+			for (const_iterator it = other.begin(); it != other.end(); ++it)
+				insert(*it);
+		}
+		HashMap(HashMap && other) noexcept : HashMap()
+		{
+			Swap(other);
+		}
+		~HashMap()
+		{
+			DestroyAll();
+		}
+		HashMap & operator=(const HashMap & other)
+		{
+			if (this != &other)
+			{
+				HashMap tmp(other);
+				Swap(tmp);
+			}
+			return *this;
+		}
+		HashMap & operator=(HashMap && other) noexcept
+		{
+			Swap(other);
+			return *this;
+		}
+		void Swap(HashMap & other) noexcept
+		{
+			std::swap(mCtrl, other.mCtrl);
+			std::swap(mSlots, other.mSlots);
+			std::swap(mCapacity, other.mCapacity);
+			std::swap(mSize, other.mSize);
+			std::swap(mGrowthLeft, other.mGrowthLeft);
+			std::swap(mHash, other.mHash);
+			std::swap(mEqual, other.mEqual);
+		}
+
+		// --------------------------------------------------------------------
+		// iteration
+		iterator begin()				{ iterator it(mCtrl, mSlots); it.SkipEmpty(); return it; }
+		iterator end()					{ return iterator(mCtrl + mCapacity, mSlots + mCapacity); }
+		const_iterator begin() const	{ return const_cast<HashMap*>(this)->begin(); }
+		const_iterator end() const		{ return const_cast<HashMap*>(this)->end(); }
+
+		// --------------------------------------------------------------------
+		// size
+		bool empty() const				{ return mSize == 0; }
+		size_type size() const			{ return mSize; }
+		size_type capacity() const		{ return mCapacity; }
+
+		// keeps the allocation
+		void clear()
+		{
+			if (mCapacity == 0)
+				return;
+			for (u32 i = 0; i < mCapacity; ++i)
+				if (internal::IsFull(mCtrl[i]))
+					mSlots[i].~value_type();
+			ResetCtrl();
+			mSize = 0;
+		}
+		// makes room for count elements without rehashing
+		void Reserve(u32 count)
+		{
+			u32 capacity = 15;
+			while (MaxLoad(capacity) < count)
+				capacity = capacity * 2 + 1;
+			if (capacity > mCapacity)
+				Rehash(capacity);
+		}
+		void reserve(u32 count) { Reserve(count); }
+
+		// --------------------------------------------------------------------
+		// lookup
+		iterator find(const K & key)				{ return MakeIterator(FindIndex(key, mHash(key))); }
+		const_iterator find(const K & key) const	{ return const_cast<HashMap*>(this)->find(key); }
+		size_type count(const K & key) const		{ return find(key) != end() ? 1 : 0; }
+
+		// heterogeneous lookup (string maps: const char *, StringView)
+		template <typename Q, typename H = THash, typename = typename H::is_transparent>
+		iterator find(const Q & key)				{ return MakeIterator(FindIndex(key, mHash(key))); }
+		template <typename Q, typename H = THash, typename = typename H::is_transparent>
+		const_iterator find(const Q & key) const	{ return const_cast<HashMap*>(this)->find(key); }
+		template <typename Q, typename H = THash, typename = typename H::is_transparent>
+		size_type count(const Q & key) const		{ return find(key) != end() ? 1 : 0; }
+
+		// --------------------------------------------------------------------
+		// insertion
+		V & operator[](const K & key)
+		{
+			std::pair<u32, bool> res = FindOrPrepareInsert(key);
+			if (res.second)
+				new (mSlots + res.first) value_type(key, V());
+			return mSlots[res.first].second;
+		}
+		V & operator[](K && key)
+		{
+			std::pair<u32, bool> res = FindOrPrepareInsert(key);
+			if (res.second)
+				new (mSlots + res.first) value_type(std::move(key), V());
+			return mSlots[res.first].second;
+		}
+		// doesn't overwrite an existing value
+		std::pair<iterator, bool> insert(const value_type & value)
+		{
+			std::pair<u32, bool> res = FindOrPrepareInsert(value.first);
+			if (res.second)
+				new (mSlots + res.first) value_type(value);
+			return std::make_pair(MakeIterator(res.first), res.second);
+		}
+		std::pair<iterator, bool> insert(value_type && value)
+		{
+			std::pair<u32, bool> res = FindOrPrepareInsert(value.first);
+			if (res.second)
+				new (mSlots + res.first) value_type(std::move(value));
+			return std::make_pair(MakeIterator(res.first), res.second);
+		}
+
+		// --------------------------------------------------------------------
+		// removal. Returns the element after the erased one.
+		iterator erase(const_iterator it)
+		{
+			u32 index = u32(it.mCtrl - mCtrl);
+			EraseAt(index);
+			iterator next(mCtrl + index, mSlots + index);
+			next.SkipEmpty();
+			return next;
+		}
+		iterator erase(iterator it)
+		{
+			return erase(const_iterator(it));
+		}
+		size_type erase(const K & key)
+		{
+			u32 index = FindIndex(key, mHash(key));
+			if (index == kNotFound)
+				return 0;
+			EraseAt(index);
+			return 1;
+		}
+
+	private:
+		// --------------------------------------------------------------------
+		static u32 MaxLoad(u32 capacity) { return capacity - capacity / 8; }
+		static u32 H1(u64 hash) { return u32(hash >> 7); }
+		static ctrl_t H2(u64 hash) { return ctrl_t(hash & 0x7F); }
+
+		static const u32 kNotFound = 0xFFFFFFFF;
+		iterator MakeIterator(u32 index) { return index == kNotFound ? end() : iterator(mCtrl + index, mSlots + index); }
+
+		// slot of key, or kNotFound
+		template <typename Q>
+		u32 FindIndex(const Q & key, u64 hash) const
+		{
+			if (mSize == 0)
+				return kNotFound;
+			ctrl_t h2 = H2(hash);
+			u32 pos = H1(hash) & mCapacity;
+			for (u32 step = internal::kGroupWidth;; step += internal::kGroupWidth)
+			{
+				internal::Group group(mCtrl + pos);
+				for (u32 match = group.Match(h2); match; match &= match - 1)
+				{
+					u32 index = (pos + internal::CountTrailingZeros(match)) & mCapacity;
+					if (mEqual(mSlots[index].first, key))
+						return index;
+				}
+				if (group.MatchEmpty())
+					return kNotFound;
+				pos = (pos + step) & mCapacity;
+			}
+		}
+
+		// first empty or deleted slot on the probe sequence of hash
+		u32 FindFreeSlot(u64 hash) const
+		{
+			u32 pos = H1(hash) & mCapacity;
+			for (u32 step = internal::kGroupWidth;; step += internal::kGroupWidth)
+			{
+				u32 mask = internal::Group(mCtrl + pos).MatchEmptyOrDeleted();
+				if (mask)
+					return (pos + internal::CountTrailingZeros(mask)) & mCapacity;
+				pos = (pos + step) & mCapacity;
+			}
+		}
+
+		// slot of key and false, or a free slot marked full and true: the
+		// caller constructs the element in it.
+		std::pair<u32, bool> FindOrPrepareInsert(const K & key)
+		{
+			u64 hash = mHash(key);
+			u32 index = FindIndex(key, hash);
+			if (index != kNotFound)
+				return std::make_pair(index, false);
+
+			index = FindFreeSlot(hash);
+			if (mGrowthLeft == 0 && mCtrl[index] != internal::kDeleted)
+			{
+				// mostly tombstones: clean up in place, grow otherwise
+				if (mCapacity == 0)
+					Rehash(15);
+				else
+					Rehash(mSize <= MaxLoad(mCapacity) / 2 ? mCapacity : mCapacity * 2 + 1);
+				index = FindFreeSlot(hash);
+			}
+			if (mCtrl[index] == internal::kEmpty)
+				--mGrowthLeft;
+			SetCtrl(index, H2(hash));
+			++mSize;
+			return std::make_pair(index, true);
+		}
+
+		void EraseAt(u32 index)
+		{
+			mSlots[index].~value_type();
+			SetCtrl(index, internal::kDeleted);
+			--mSize;
+		}
+
+		// the first 15 control bytes are cloned after the sentinel, so that a
+		// group read near the end of the table wraps around.
+		void SetCtrl(u32 index, ctrl_t h)
+		{
+			const u32 cloned = internal::kGroupWidth - 1;
+			mCtrl[index] = h;
+			mCtrl[((index - cloned) & mCapacity) + (cloned & mCapacity)] = h;
+		}
+		void ResetCtrl()
+		{
+			memset(mCtrl, internal::kEmpty, mCapacity + internal::kGroupWidth);
+			mCtrl[mCapacity] = internal::kSentinel;
+			mGrowthLeft = MaxLoad(mCapacity);
+		}
+
+		// capacity is a power of two minus one
+		void Rehash(u32 capacity)
+		{
+			ctrl_t * oldCtrl = mCtrl;
+			value_type * oldSlots = mSlots;
+			u32 oldCapacity = mCapacity;
+
+			// slots first, for their alignment
+			u8 * mem = static_cast<u8*>(::operator new(capacity * sizeof(value_type) + capacity + internal::kGroupWidth));
+			mSlots = reinterpret_cast<value_type*>(mem);
+			mCtrl = reinterpret_cast<ctrl_t*>(mem + capacity * sizeof(value_type));
+			mCapacity = capacity;
+			ResetCtrl();
+
+			for (u32 i = 0; i < oldCapacity; ++i)
+			{
+				if (!internal::IsFull(oldCtrl[i]))
+					continue;
+				value_type & old = oldSlots[i];
+				u64 hash = mHash(old.first);
+				u32 index = FindFreeSlot(hash);
+				SetCtrl(index, H2(hash));
+				// the old key is destroyed right after, moving it is safe
+				new (mSlots + index) value_type(std::move(const_cast<K&>(old.first)), std::move(old.second));
+				old.~value_type();
+			}
+			mGrowthLeft -= mSize;
+
+			if (oldCapacity)
+				::operator delete(oldSlots);
+		}
+
+		void DestroyAll()
+		{
+			if (mCapacity == 0)
+				return;
+			for (u32 i = 0; i < mCapacity; ++i)
+				if (internal::IsFull(mCtrl[i]))
+					mSlots[i].~value_type();
+			::operator delete(mSlots);
+		}
+
+		ctrl_t *		mCtrl;
+		value_type *	mSlots;
+		u32				mCapacity;		// 0, or a power of two minus one (used as mask)
+		u32				mSize;
+		u32				mGrowthLeft;	// empty slots that can be used before growing
+		THash			mHash;
+		TEqual			mEqual;
+	};
+}
+
+// ----------------------------------------------------------------------------
+#endif
@@ -0,0 +1,126 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXPoolAllocator.cpp
+// Purpose:	Fixed size free-list allocator and per-type pools
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#include <cstdlib>
+#include <new>
+#include "AEXPoolAllocator.h"
+#include "..\Debug\MyDebug.h"
+#include "..\Debug\AEXAllocTracker.h"
+
+namespace AEX
+{
+	namespace
+	{
+		// function static: pools are created during static init too
+		AEX_PTR_ARRAY(PoolAllocator) & GetPools()
+		{
+			static AEX_PTR_ARRAY(PoolAllocator) sPools;
+			return sPools;
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	PoolAllocator::PoolAllocator(const char * name, u32 objectSize, u32 objectAlign)
+		: mName(name)
+		, mTypeId(StringId::Intern(name))
+		, mFreeList(NULL)
+		, mLiveCount(0)
+		, mHighWaterMark(0)
+	{
+		// a free block stores the free list link
+		if (objectAlign < sizeof(FreeNode))
+			objectAlign = sizeof(FreeNode);
+		if (objectSize < sizeof(FreeNode))
+			objectSize = sizeof(FreeNode);
+		mStride = (objectSize + objectAlign - 1) / objectAlign * objectAlign;
+		mObjectsPerSlab = mStride < kSlabSize ? kSlabSize / mStride : 1;
+
+		GetPools().push_back(this);
+	}
+	PoolAllocator::~PoolAllocator()
+	{
+		FOR_EACH(it, mSlabs)
+			free(*it);
+
+		AEX_PTR_ARRAY(PoolAllocator) & pools = GetPools();
+		FOR_EACH(it, pools)
+		{
+			if (*it == this)
+			{
+				pools.erase(it);
+				break;
+			}
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	void * PoolAllocator::Allocate()
+	{
+		if (mFreeList == NULL)
+			AllocateSlab();
+
+		// pop the free list
+		FreeNode * node = mFreeList;
+		mFreeList = node->mNext;
+
+		if (++mLiveCount > mHighWaterMark)
+			mHighWaterMark = mLiveCount;
+		AllocTracker::OnTypedAlloc(mTypeId.GetHash(), mStride);
+		return node;
+	}
+	void PoolAllocator::Free(void * obj)
+	{
+		if (obj == NULL)
+			return;
+
+		// push on the free list: the most recently freed (warmest) block is reused first.
+		FreeNode * node = static_cast<FreeNode*>(obj);
+		node->mNext = mFreeList;
+		mFreeList = node;
+		--mLiveCount;
+		AllocTracker::OnTypedFree(mTypeId.GetHash(), mStride);
+	}
+	void PoolAllocator::AllocateSlab()
+	{
+		u32 slabBytes = mStride * mObjectsPerSlab;
+		// malloc: the blocks are reported to the AllocTracker one by one, the
+		// hooked operator new would count the slab too
+		u8 * allocation = static_cast<u8*>(malloc(slabBytes + kCacheLine));
+		if (!allocation)
+			throw std::bad_alloc();
+		u8 * slab = allocation + (kCacheLine - (size_t)allocation % kCacheLine) % kCacheLine;
+		mSlabs.push_back(allocation);
+
+		// thread the new blocks in address order
+		for (u32 i = mObjectsPerSlab; i > 0; --i)
+		{
+			FreeNode * node = reinterpret_cast<FreeNode*>(slab + (i - 1) * mStride);
+			node->mNext = mFreeList;
+			mFreeList = node;
+		}
+	}
+
+	// ----------------------------------------------------------------------------
+	u32 PoolAllocator::GetPoolCount()
+	{
+		return GetPools().size();
+	}
+	PoolAllocator & PoolAllocator::GetPool(u32 index)
+	{
+		return *GetPools()[index];
+	}
+	void PoolAllocator::PrintStats()
+	{
+		MyPrintFunction("%-40s %8s %8s %8s %8s\n", "Pool", "Size", "Live", "Peak", "Slabs");
+		FOR_EACH(it, GetPools())
+		{
+			PoolAllocator * pool = *it;
+			MyPrintFunction("%-40s %8u %8u %8u %8u\n", pool->GetName(), pool->GetObjectSize(),
+				pool->GetLiveCount(), pool->GetHighWaterMark(), pool->GetSlabCount());
+		}
+	}
+}
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------------
+// Project: GAM300 - Sample Engine
+// File:	AEXPoolAllocator.h
+// Purpose:	Fixed size free-list allocator and per-type pools
+//
+// Copyright DigiPen Institute of Technology
+// ----------------------------------------------------------------------------
+#ifndef AEX_POOL_ALLOCATOR_H_
+#define AEX_POOL_ALLOCATOR_H_
+
+#include "AEXContainers.h"
+#include "..\Core\AEXRtti.h"
+
+#pragma warning (disable:4251) // dll and STL
+namespace AEX
+{
+	// ----------------------------------------------------------------------------
+	// \class	PoolAllocator
+	// \brief	Hands out fixed size blocks from cache line aligned slabs. Freed
+	//			blocks go in a free list and are reused first. Slabs are only
+	//			released when the pool is destroyed.
+	class PoolAllocator
+	{
+	public:
+		static const u32 kSlabSize = 16 * 1024;
+		static const u32 kCacheLine = 64;
+
+		PoolAllocator(const char * name, u32 objectSize, u32 objectAlign);
+		~PoolAllocator();
+
+		void * Allocate();
+		void Free(void * obj);
+
+		// stats
+		const char * GetName() const		{ return mName.c_str(); }
+		u32 GetObjectSize() const			{ return mStride; }
+		u32 GetLiveCount() const			{ return mLiveCount; }
+		u32 GetHighWaterMark() const		{ return mHighWaterMark; }
+		u32 GetSlabCount() const			{ return mSlabs.size(); }
+
+		// all the pools created so far
+		static u32 GetPoolCount();
+		static PoolAllocator & GetPool(u32 index);
+		static void PrintStats();	// one line per pool, through MyPrintFunction (all builds)
+
+	private:
+		struct FreeNode { FreeNode * mNext; };
+		void AllocateSlab();
+
+		std::string			mName;
+		StringId			mTypeId;		// interned name, for the AllocTracker
+		u32					mStride;		// object size rounded up to its alignment
+		u32					mObjectsPerSlab;
+		FreeNode *			mFreeList;
+		AEX_ARRAY(u8*)		mSlabs;			// unaligned allocations
+		u32					mLiveCount;
+		u32					mHighWaterMark;
+	};
+
+	// ----------------------------------------------------------------------------
+	// \struct	TypedPool
+	// \brief	One pool per type T. The pool is never destroyed so objects can
+	//			be freed safely during static destruction.
+	template <typename T>
+	struct TypedPool
+	{
+		static PoolAllocator & Get()
+		{
+			static PoolAllocator * sPool = new PoolAllocator(Rtti::GetTypeName<T>().c_str(), sizeof(T), alignof(T));
+			return *sPool;
+		}
+	};
+}
+#pragma warning (default:4251) // dll and STL
+
+// ----------------------------------------------------------------------------
+#endif
@@ -2,5 +2,6 @@
 #define AEX_UTILS_H_
 
 #include "AEXContainers.h"
+#include "AEXFrameArena.h"
 
 #endif
\ No newline at end of file